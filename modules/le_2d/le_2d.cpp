@@ -1,5 +1,6 @@
 #include "le_2d.h"
 #include "le_core/le_core.h"
+#include "le_core/lru_cache.h"
 #include "3rdparty/src/spooky/SpookyV2.h"
 
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE // vulkan clip space is from 0 to 1
@@ -12,7 +13,9 @@
 #include <iomanip>
 #include <vector>
 #include <algorithm>
-#include <atomic>
+#include <iterator> // for make_reverse_iterator
+#include <memory>
+#include <unordered_map>
 #include <string.h> // for memset, memcpy
 
 #include "le_renderer/le_renderer.h"
@@ -22,16 +25,12 @@
 
 #include "le_tessellator/le_tessellator.h"
 #include "le_path/le_path.h"
+#include "le_jobs/le_jobs.h"
 
 using vec2f          = glm::vec2;
 using StrokeCapType  = le_2d_api::StrokeCapType;
 using StrokeJoinType = le_2d_api::StrokeJoinType;
-
-// A drawing context, owner of all primitives.
-struct le_2d_o {
-	le_command_buffer_encoder_o *    encoder = nullptr;
-	std::vector<le_2d_primitive_o *> primitives; // owning
-};
+using RenderMode     = le_2d_api::RenderMode;
 
 struct node_data_t {
 	// application order: t,r,s
@@ -102,16 +101,125 @@ struct le_2d_primitive_o {
 	node_data_t node;
 
 	uint64_t hash;
+
+	// Bulk primitives, added via add_circles, or add_lines, are drawn as many
+	// instances of the same geometry. Their instance data is held by the
+	// context, and their node data is unused.
+	uint32_t first_bulk_instance; // index into le_2d_o::bulk_instances
+	uint32_t num_bulk_instances;  // 0 for regular primitives
+};
+
+// per-instance data for a primitive
+struct PrimitiveInstanceData2D {
+	glm::vec2 translation;
+	glm::vec2 scale;
+	float     rotation_ccw;
+	uint32_t  color;
 };
 
+// Per-instance data for primitives which are drawn as quads, and shaded
+// using signed distance functions - see: `2d_primitives_sdf.frag`
+struct SdfInstanceData2D {
+	glm::vec2 translation; // centre of shape, in canvas space
+	glm::vec2 radii;       // ellipse: radius x, radius y; line: half length, 0
+	glm::vec2 angles;      // arc: start angle, end angle
+	float     rotation_ccw;
+	float     stroke_weight;
+	uint32_t  color;
+	uint32_t  flags; // shape, and flags - must match 2d_primitives_sdf.frag
+
+	enum : uint32_t {
+		eShapeEllipse = 0,
+		eShapeLine    = 1,
+		bitFilled     = 0x4,
+		bitArc        = 0x8, // restrict ellipse to sector between start and end angle
+	};
+};
+
+// A drawing context, owner of all primitives.
+struct le_2d_o {
+	static constexpr size_t PRIMITIVE_BLOCK_SIZE = 1024;
+
+	le_command_buffer_encoder_o *    encoder = nullptr;
+	std::vector<le_2d_primitive_o *> primitives; // in draw order, non-owning: primitives live in primitive_blocks
+
+	// Arena for primitives: we allocate primitives in blocks, which are freed
+	// all at once when the context is destroyed. Blocks never move, so that
+	// pointers to primitives stay valid.
+	std::vector<std::unique_ptr<le_2d_primitive_o[]>> primitive_blocks;
+	size_t                                            num_primitives_in_last_block = 0;
+
+	std::vector<PrimitiveInstanceData2D> bulk_instances; // instance data for bulk primitives
+
+	RenderMode render_mode = RenderMode::eRenderModeTessellated;
+};
+
+// Moves a line into its local space, the way circles are centred on the
+// origin, and placed via their node: the line then starts at the origin,
+// and its node moves it into place. Lines which differ only in position -
+// and, unless their node is scaled non-uniformly, in orientation - then
+// hash alike, and share geometry.
+static void le_2d_primitive_line_to_local_space( le_2d_primitive_o *p ) {
+
+	auto &line = p->data.as_line;
+	auto &node = p->node;
+
+	vec2f d = line.p1 - line.p0;
+
+	// Nodes apply scale, then rotation, then translation - moving the line
+	// by `-p0` means moving the node by `p0`, scaled, and rotated.
+	float const s = sinf( node.rotation_ccw );
+	float const c = cosf( node.rotation_ccw );
+	vec2f const t = line.p0 * node.scale;
+
+	node.translation += vec2f( c * t.x - s * t.y, s * t.x + c * t.y );
+
+	// Uniform scale commutes with rotation, so that we may rotate the node
+	// instead of the line, which then points along the x axis.
+	float const length = glm::length( d );
+
+	if ( node.scale.x == node.scale.y && length > 0.f ) {
+		node.rotation_ccw += atan2f( d.y, d.x );
+		d = { length, 0.f };
+	}
+
+	line.p0 = { 0.f, 0.f };
+	line.p1 = d;
+}
+
+// ----------------------------------------------------------------------
+
 void le_2d_primitive_update_hash( le_2d_primitive_o *obj ) {
-	// We can hash everything until `material.color` in one go, as
-	// the top of the struct is tightly packed.
+
+	if ( obj->type == le_2d_primitive_o::Type::ePath ) {
+		// Path data holds a pointer to its path, which tells us nothing about
+		// the shape of the path - and which may well be reused by a different
+		// path in a later frame. We hash path contents instead.
+		auto const &path = obj->data.as_path;
+
+		SpookyHash hash;
+		hash.Init( le_path::le_path_i.get_hash( path.path ), 0 );
+		hash.Update( &obj->type, sizeof( obj->type ) );
+		hash.Update( &path.tolerance, sizeof( path.tolerance ) );
+		hash.Update( &obj->material, offsetof( material_data_t, color ) );
+
+		uint64_t h1, h2;
+		hash.Final( &h1, &h2 );
+		obj->hash = h1;
+		return;
+	}
+
+	// We hash everything until `material.color` in one go. This range
+	// includes padding - between `type`, and `data`, which is 8-byte
+	// aligned - as well as any bytes of `data` which the primitive's type
+	// does not use.
+	//
+	// `le_2d_allocate_primitive` zeroes every primitive in full, padding
+	// included, which is what makes the hash predictable.
 	//
-	// Every primive is zero-initialised, meaning unused bytes in
-	// `le_2d_primitive_o.data` are initialised to zero, and the hash is
-	// therefore predictable.
-	obj->hash = SpookyHash::Hash32( &obj->type, offsetof( le_2d_primitive_o, material.color ), 0 );
+	// We use a 64 bit hash, as hashes are used as keys into the geometry
+	// cache, which holds on to geometry across frames.
+	obj->hash = SpookyHash::Hash64( &obj->type, offsetof( le_2d_primitive_o, material.color ), 0 );
 }
 
 // ----------------------------------------------------------------------
@@ -137,14 +245,6 @@ struct VertexData2D {
 	glm::vec2 texCoord;
 };
 
-// per-instance data for a primitive
-struct PrimitiveInstanceData2D {
-	glm::vec2 translation;
-	glm::vec2 scale;
-	float     rotation_ccw;
-	uint32_t  color;
-};
-
 // ----------------------------------------------------------------------
 
 static void generate_geometry_line( std::vector<VertexData2D> &geometry, glm::vec2 const &p0, glm::vec2 const &p1, float thickness ) {
@@ -153,8 +253,6 @@ static void generate_geometry_line( std::vector<VertexData2D> &geometry, glm::ve
 		return;
 	}
 
-	geometry.reserve( geometry.size() + 6 );
-
 	auto p_vec  = p1 - p0;
 	auto p_norm = glm::normalize( p_vec );
 
@@ -345,30 +443,25 @@ static void generate_geometry_outline_path( std::vector<VertexData2D> &geometry,
 		switch ( WHICH_TESSELLATOR ) {
 
 		case 0: {
-			std::vector<glm::vec2> vertices_l( 1024 );
-			std::vector<glm::vec2> vertices_r( 1024 );
+			std::vector<glm::vec2> all_vertices;
 
 			for ( size_t i = 0; i != num_contours; ++i ) {
 
-				size_t num_vertices_l = vertices_l.size();
-				size_t num_vertices_r = vertices_r.size();
+				glm::vec2 const *v_l;
+				glm::vec2 const *v_r;
+				size_t           num_vertices_l = 0;
+				size_t           num_vertices_r = 0;
 
-				glm::vec2 *v_l                   = vertices_l.data();
-				glm::vec2 *v_r                   = vertices_r.data();
-				bool       vertices_large_enough = le_path_i.generate_offset_outline_for_contour( path, i, stroke_weight, tolerance, v_l, &num_vertices_l, v_r, &num_vertices_r );
+				le_path_i.get_offset_outline_for_contour( path, i, stroke_weight, tolerance, &v_l, &num_vertices_l, &v_r, &num_vertices_r );
 
-				if ( !vertices_large_enough ) {
-					vertices_l.resize( num_vertices_l + 1 );
-					vertices_r.resize( num_vertices_r + 1 );
-					le_path_i.generate_offset_outline_for_contour( path, i, stroke_weight, tolerance, vertices_l.data(), &num_vertices_l, vertices_r.data(), &num_vertices_r );
-				}
+				// left outline, followed by right outline in reverse order
+				all_vertices.assign( v_l, v_l + num_vertices_l );
+				all_vertices.insert( all_vertices.end(), std::make_reverse_iterator( v_r + num_vertices_r ), std::make_reverse_iterator( v_r ) );
 
-				// reverse elements
-				std::reverse( vertices_r.begin(), vertices_r.begin() + int64_t( num_vertices_r ) );
+				if ( all_vertices.empty() ) {
+					continue;
+				}
 
-				std::vector<glm::vec2> all_vertices;
-				all_vertices.insert( all_vertices.end(), vertices_l.begin(), vertices_l.begin() + int64_t( num_vertices_l ) );
-				all_vertices.insert( all_vertices.end(), vertices_r.begin(), vertices_r.begin() + int64_t( num_vertices_r ) );
 				all_vertices.push_back( all_vertices.front() );
 
 				auto p_prev = all_vertices.front();
@@ -387,31 +480,20 @@ static void generate_geometry_outline_path( std::vector<VertexData2D> &geometry,
 			//			le_tessellator_i.set_options( tess, le_tessellator::Options::bitConstrainedDelaunayTriangulation );
 			//			le_tessellator_i.set_options( tess, le_tessellator::Options::bitUseEarcutTessellator );
 
-			std::vector<glm::vec2> vertices_l( 1024 );
-			std::vector<glm::vec2> vertices_r( 1024 );
+			std::vector<glm::vec2> all_vertices;
 
 			for ( size_t i = 0; i != num_contours; ++i ) {
 
-				size_t num_vertices_l = vertices_l.size();
-				size_t num_vertices_r = vertices_r.size();
+				glm::vec2 const *v_l;
+				glm::vec2 const *v_r;
+				size_t           num_vertices_l = 0;
+				size_t           num_vertices_r = 0;
 
-				glm::vec2 *v_l = vertices_l.data();
-				glm::vec2 *v_r = vertices_r.data();
-
-				bool vertices_large_enough = le_path_i.generate_offset_outline_for_contour( path, i, stroke_weight, tolerance, v_l, &num_vertices_l, v_r, &num_vertices_r );
-
-				if ( !vertices_large_enough ) {
-					vertices_l.resize( num_vertices_l + 1 );
-					vertices_r.resize( num_vertices_r + 1 );
-					le_path_i.generate_offset_outline_for_contour( path, i, stroke_weight, tolerance, vertices_l.data(), &num_vertices_l, vertices_r.data(), &num_vertices_r );
-				}
+				le_path_i.get_offset_outline_for_contour( path, i, stroke_weight, tolerance, &v_l, &num_vertices_l, &v_r, &num_vertices_r );
 
-				// reverse elements
-				std::reverse( vertices_r.begin(), vertices_r.begin() + int64_t( num_vertices_r ) );
-
-				std::vector<glm::vec2> all_vertices;
-				all_vertices.insert( all_vertices.end(), vertices_l.begin(), vertices_l.begin() + int64_t( num_vertices_l ) );
-				all_vertices.insert( all_vertices.end(), vertices_r.begin(), vertices_r.begin() + int64_t( num_vertices_r ) );
+				// left outline, followed by right outline in reverse order
+				all_vertices.assign( v_l, v_l + num_vertices_l );
+				all_vertices.insert( all_vertices.end(), std::make_reverse_iterator( v_r + num_vertices_r ), std::make_reverse_iterator( v_r ) );
 
 				if ( !all_vertices.empty() ) {
 					all_vertices.push_back( all_vertices.front() );
@@ -440,25 +522,17 @@ static void generate_geometry_outline_path( std::vector<VertexData2D> &geometry,
 			le_tessellator_i.destroy( tess );
 		} break;
 		case 2: {
-			std::vector<glm::vec2> vertices_l( 1024 );
-			std::vector<glm::vec2> vertices_r( 1024 );
-
 			for ( size_t i = 0; i != num_contours; ++i ) {
 
-				size_t num_vertices_l = vertices_l.size();
-				size_t num_vertices_r = vertices_r.size();
-
-				glm::vec2 *v_l = vertices_l.data();
-				glm::vec2 *v_r = vertices_r.data();
+				glm::vec2 const *v_l;
+				glm::vec2 const *v_r;
+				size_t           num_vertices_l = 0;
+				size_t           num_vertices_r = 0;
 
-				bool vertices_large_enough = le_path_i.generate_offset_outline_for_contour( path, i, stroke_weight, tolerance, v_l, &num_vertices_l, v_r, &num_vertices_r );
+				le_path_i.get_offset_outline_for_contour( path, i, stroke_weight, tolerance, &v_l, &num_vertices_l, &v_r, &num_vertices_r );
 
-				if ( !vertices_large_enough ) {
-					vertices_l.resize( num_vertices_l + 1 );
-					vertices_r.resize( num_vertices_r + 1 );
-					v_l = vertices_l.data();
-					v_r = vertices_r.data();
-					le_path_i.generate_offset_outline_for_contour( path, i, stroke_weight, tolerance, v_l, &num_vertices_l, v_r, &num_vertices_r );
+				if ( num_vertices_l == 0 || num_vertices_r == 0 ) {
+					continue;
 				}
 
 				glm::vec2 const *l_prev = v_l;
@@ -467,8 +541,8 @@ static void generate_geometry_outline_path( std::vector<VertexData2D> &geometry,
 				glm::vec2 const *l = l_prev + 1;
 				glm::vec2 const *r = r_prev + 1;
 
-				glm::vec2 const *const l_end = vertices_l.data() + num_vertices_l;
-				glm::vec2 const *const r_end = vertices_r.data() + num_vertices_r;
+				glm::vec2 const *const l_end = v_l + num_vertices_l;
+				glm::vec2 const *const r_end = v_r + num_vertices_r;
 
 				for ( ; ( l != l_end || r != r_end ); ) {
 
@@ -495,24 +569,18 @@ static void generate_geometry_outline_path( std::vector<VertexData2D> &geometry,
 			}
 		} break;
 		case 3: {
-			std::vector<glm::vec2> vertices( 1024 );
+			le_path_api::stroke_attribute_t stroke_attribs{};
+			stroke_attribs.width          = stroke_weight;
+			stroke_attribs.tolerance      = tolerance;
+			stroke_attribs.line_join_type = to_path_enum( material.stroke_join_type );
+			stroke_attribs.line_cap_type  = to_path_enum( material.stroke_cap_type );
 
 			for ( size_t i = 0; i != num_contours; ++i ) {
 
-				size_t num_vertices = vertices.size();
+				glm::vec2 const *v_data;
+				size_t           num_vertices = 0;
 
-				glm::vec2 *v_data = vertices.data();
-
-				le_path_api::stroke_attribute_t stroke_attribs{};
-				stroke_attribs.width          = stroke_weight;
-				stroke_attribs.tolerance      = tolerance;
-				stroke_attribs.line_join_type = to_path_enum( material.stroke_join_type );
-				stroke_attribs.line_cap_type  = to_path_enum( material.stroke_cap_type );
-
-				while ( false == le_path_i.tessellate_thick_contour( path, i, &stroke_attribs, v_data, &num_vertices ) ) {
-					vertices.resize( num_vertices );
-					v_data = vertices.data();
-				}
+				le_path_i.get_thick_contour_triangles( path, i, &stroke_attribs, &v_data, &num_vertices );
 
 				glm::vec2 const *      v     = v_data;
 				glm::vec2 const *const v_end = v_data + num_vertices;
@@ -633,14 +701,333 @@ static void generate_geometry_for_primitive( le_2d_primitive_o *p, std::vector<V
 	}
 }
 
+// ----------------------------------------------------------------------
+// Geometry cache
+//
+// `le_2d` contexts only live for a frame, but most primitives look the same
+// from one frame to the next. Generated geometry is therefore kept in a
+// cache shared by all contexts - see `LruCache`. Entries are keyed by the
+// bytes of a primitive which influence its shape, the same bytes which
+// `le_2d_primitive_update_hash` hashes. Unchanged primitives cost a cache
+// lookup, and no tessellation.
+//
+// Paths are not cached here: their primitive holds a pointer rather than
+// path contents, and le_path caches the geometry it generates for them.
+//
+// Use `set_cache_capacity(0)` to disable caching altogether.
+
+// Geometry for a primitive, with its bounding box in primitive space.
+struct Geometry {
+	std::vector<VertexData2D> vertices;
+	vec2f                     bbox_min{ 0 };
+	vec2f                     bbox_max{ 0 };
+};
+
+static LruCache<Geometry> &get_geometry_cache() {
+	static LruCache<Geometry> cache{ 16 << 20 };
+	return cache;
+}
+
+// ----------------------------------------------------------------------
+// Returns geometry for primitive - from cache if possible, otherwise we
+// generate geometry, and store it with the cache.
+static std::shared_ptr<Geometry const> get_geometry_for_primitive( le_2d_primitive_o *p ) {
+
+	auto &cache = get_geometry_cache();
+
+	bool const use_cache = cache.is_enabled() && p->type != le_2d_primitive_o::Type::ePath;
+
+	// Key bytes are what le_2d_primitive_update_hash hashes for primitives other than paths.
+	void const * key      = &p->type;
+	size_t const key_size = offsetof( le_2d_primitive_o, material.color );
+
+	if ( use_cache ) {
+		auto geometry = cache.find( p->hash, key, key_size );
+		if ( geometry ) {
+			return geometry;
+		}
+	}
+
+	auto geometry = std::make_shared<Geometry>();
+	generate_geometry_for_primitive( p, geometry->vertices );
+
+	if ( !geometry->vertices.empty() ) {
+		geometry->bbox_min = geometry->bbox_max = geometry->vertices.front().pos;
+		for ( auto const &v : geometry->vertices ) {
+			geometry->bbox_min = glm::min( geometry->bbox_min, v.pos );
+			geometry->bbox_max = glm::max( geometry->bbox_max, v.pos );
+		}
+	}
+
+	if ( use_cache ) {
+		cache.store( p->hash, key, key_size, geometry, sizeof( Geometry ) + sizeof( VertexData2D ) * geometry->vertices.size() );
+	}
+
+	return geometry;
+}
+
+// ----------------------------------------------------------------------
+
+static PrimitiveInstanceData2D get_instance_data( le_2d_primitive_o const *p ) {
+	PrimitiveInstanceData2D instance_data{};
+	instance_data.color        = p->material.color;
+	instance_data.rotation_ccw = p->node.rotation_ccw;
+	instance_data.scale        = p->node.scale;
+	instance_data.translation  = p->node.translation;
+	return instance_data;
+}
+
+// ----------------------------------------------------------------------
+// Calculates a conservative bounding box in primitive space, without generating
+// geometry. Returns false if bounds can't be known up front - which is the case
+// for paths, whose bounds we only know once their geometry has been generated.
+static bool get_primitive_bounding_box( le_2d_primitive_o const *p, vec2f &bbox_min, vec2f &bbox_max ) {
+
+	// Outlines extend by half their stroke weight to either side.
+	float const offset = p->material.filled ? 0.f : 0.5f * p->material.stroke_weight;
+
+	vec2f extent;
+
+	switch ( p->type ) {
+	case le_2d_primitive_o::Type::eCircle:
+		extent = vec2f( p->data.as_circle.radius + offset );
+		break;
+	case le_2d_primitive_o::Type::eEllipse:
+		extent = p->data.as_ellipse.radii + offset;
+		break;
+	case le_2d_primitive_o::Type::eArc:
+		extent = p->data.as_arc.radii + offset;
+		break;
+	case le_2d_primitive_o::Type::eLine: {
+		auto const &line        = p->data.as_line;
+		float const half_stroke = 0.5f * p->material.stroke_weight; // lines are never filled
+		bbox_min                = glm::min( line.p0, line.p1 ) - half_stroke;
+		bbox_max                = glm::max( line.p0, line.p1 ) + half_stroke;
+		return true;
+	}
+	default:
+		return false;
+	}
+
+	bbox_min = -extent;
+	bbox_max = extent;
+	return true;
+}
+
+// ----------------------------------------------------------------------
+// Calculates a conservative bounding box in canvas space for an instance of
+// something with bounding box `local_min`, `local_max` in primitive space.
+static void get_instance_bounding_box( PrimitiveInstanceData2D const &instance, vec2f const &local_min, vec2f const &local_max, vec2f &bbox_min, vec2f &bbox_max ) {
+
+	if ( instance.rotation_ccw == 0.f ) {
+		vec2f const a = local_min * instance.scale;
+		vec2f const b = local_max * instance.scale;
+		bbox_min      = instance.translation + glm::min( a, b );
+		bbox_max      = instance.translation + glm::max( a, b );
+		return;
+	}
+
+	// Any rotation: use a box around the circle which encloses all
+	// possible orientations of the scaled geometry.
+	float const extent = glm::length( glm::max( glm::abs( local_min ), glm::abs( local_max ) ) ) *
+	                     std::max( std::abs( instance.scale.x ), std::abs( instance.scale.y ) );
+
+	bbox_min = instance.translation - vec2f( extent );
+	bbox_max = instance.translation + vec2f( extent );
+}
+
+// ----------------------------------------------------------------------
+// Returns whether primitive may be drawn using signed distance functions.
+static bool is_sdf_primitive( le_2d_primitive_o const *p ) {
+	switch ( p->type ) {
+	case le_2d_primitive_o::Type::eCircle:
+	case le_2d_primitive_o::Type::eEllipse:
+	case le_2d_primitive_o::Type::eArc:
+	case le_2d_primitive_o::Type::eLine:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// ----------------------------------------------------------------------
+// Calculates sdf instance data for an instance of primitive `p`. Returns false
+// if there is nothing to draw - this mirrors cases in which tessellation would
+// not generate any geometry.
+//
+// Instance scale is baked into radii, which is why stroke weight is not scaled,
+// and why non-uniform scale only applies to ellipses, and lines along their axes.
+static bool get_sdf_instance_data( le_2d_primitive_o const *p, PrimitiveInstanceData2D const &instance, SdfInstanceData2D &sdf ) {
+
+	sdf               = {};
+	sdf.translation   = instance.translation;
+	sdf.rotation_ccw  = instance.rotation_ccw;
+	sdf.stroke_weight = p->material.stroke_weight;
+	sdf.color         = instance.color;
+	sdf.flags         = SdfInstanceData2D::eShapeEllipse;
+
+	if ( p->material.filled ) {
+		sdf.flags |= SdfInstanceData2D::bitFilled;
+		sdf.stroke_weight = 0;
+	}
+
+	switch ( p->type ) {
+	case le_2d_primitive_o::Type::eCircle:
+		sdf.radii = vec2f( p->data.as_circle.radius ) * glm::abs( instance.scale );
+		break;
+	case le_2d_primitive_o::Type::eEllipse:
+		sdf.radii = p->data.as_ellipse.radii * glm::abs( instance.scale );
+		break;
+	case le_2d_primitive_o::Type::eArc: {
+		auto const &arc = p->data.as_arc;
+		if ( std::numeric_limits<float>::epsilon() > arc.angle_end_rad - arc.angle_start_rad ) {
+			return false;
+		}
+		sdf.radii  = arc.radii * glm::abs( instance.scale );
+		sdf.angles = { arc.angle_start_rad, arc.angle_end_rad };
+		if ( arc.angle_end_rad - arc.angle_start_rad < glm::two_pi<float>() ) {
+			sdf.flags |= SdfInstanceData2D::bitArc;
+		}
+	} break;
+	case le_2d_primitive_o::Type::eLine: {
+		// Transform end points into canvas space: the line then becomes a box
+		// around its midpoint, rotated to point along the line.
+		float const s = sinf( instance.rotation_ccw );
+		float const c = cosf( instance.rotation_ccw );
+
+		auto transform = [ & ]( vec2f v ) -> vec2f {
+			v *= instance.scale;
+			return vec2f( c * v.x - s * v.y, s * v.x + c * v.y ) + instance.translation;
+		};
+
+		vec2f const p0 = transform( p->data.as_line.p0 );
+		vec2f const p1 = transform( p->data.as_line.p1 );
+
+		if ( p0 == p1 ) {
+			return false;
+		}
+
+		vec2f const d     = p1 - p0;
+		sdf.translation   = 0.5f * ( p0 + p1 );
+		sdf.radii         = { 0.5f * glm::length( d ), 0.f };
+		sdf.rotation_ccw  = atan2f( d.y, d.x );
+		sdf.stroke_weight = p->material.stroke_weight; // lines are never filled
+		sdf.flags         = SdfInstanceData2D::eShapeLine;
+		return true;
+	}
+	default:
+		return false;
+	}
+
+	return sdf.radii.x > 0 || sdf.radii.y > 0;
+}
+
+// ----------------------------------------------------------------------
+// Calculates a conservative bounding box for an sdf instance in canvas space.
+static void get_sdf_instance_bounding_box( SdfInstanceData2D const &sdf, vec2f &bbox_min, vec2f &bbox_max ) {
+	float const extent = std::max( sdf.radii.x, sdf.radii.y ) + 0.5f * sdf.stroke_weight + 1.f; // +1: anti-aliasing margin
+	bbox_min           = sdf.translation - vec2f( extent );
+	bbox_max           = sdf.translation + vec2f( extent );
+}
+
+// ----------------------------------------------------------------------
+
+static inline bool bounding_boxes_overlap( vec2f const &a_min, vec2f const &a_max, vec2f const &b_min, vec2f const &b_max ) {
+	return a_min.x <= b_max.x && b_min.x <= a_max.x &&
+	       a_min.y <= b_max.y && b_min.y <= a_max.y;
+}
+
+// ----------------------------------------------------------------------
+
+struct FetchGeometryJob {
+	le_2d_primitive_o *const *       primitives; // one primitive per geometry
+	std::shared_ptr<Geometry const> *geometry;   // one entry per primitive, filled in by job
+	size_t                           count;
+};
+
+static void fetch_geometry_job_fun( void *param ) {
+	auto job = static_cast<FetchGeometryJob *>( param );
+	for ( size_t i = 0; i != job->count; i++ ) {
+		job->geometry[ i ] = get_geometry_for_primitive( job->primitives[ i ] );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Fetches geometry for all given primitives, spreading work across le_jobs
+// worker threads if the job system has been initialised. Primitives must have
+// distinct hashes, and must not share paths, since generating geometry for a
+// path may update the path.
+static void fetch_geometry_for_primitives( le_2d_primitive_o *const *primitives, size_t count, std::shared_ptr<Geometry const> *geometry ) {
+
+	if ( count == 0 ) {
+		return;
+	}
+
+	// We create a few jobs per worker, so that workers which finish early may pick up
+	// some more work - most primitives will be cache hits, but some might be costly paths.
+
+	size_t const num_workers = le_jobs::get_worker_thread_count();
+	size_t const num_jobs    = num_workers ? std::min( count, num_workers * 4 ) : 1;
+
+	std::vector<FetchGeometryJob> jobs( num_jobs );
+
+	for ( size_t i = 0; i != num_jobs; i++ ) {
+		size_t const first = ( i * count ) / num_jobs;
+		size_t const last  = ( ( i + 1 ) * count ) / num_jobs;
+
+		jobs[ i ].primitives = primitives + first;
+		jobs[ i ].geometry   = geometry + first;
+		jobs[ i ].count      = last - first;
+	}
+
+	if ( num_jobs == 1 ) {
+		fetch_geometry_job_fun( &jobs[ 0 ] );
+		return;
+	}
+
+	std::vector<le_jobs::job_t> job_list;
+	job_list.reserve( num_jobs );
+
+	for ( auto &job : jobs ) {
+		job_list.push_back( { fetch_geometry_job_fun, &job } );
+	}
+
+	le_jobs::counter_t *counter;
+	le_jobs::run_jobs( job_list.data(), uint32_t( job_list.size() ), &counter );
+	le_jobs::wait_for_counter_and_free( counter, 0 );
+}
+
+// ----------------------------------------------------------------------
+
+static void le_2d_set_cache_capacity( size_t capacity_in_bytes ) {
+	get_geometry_cache().set_capacity( capacity_in_bytes );
+}
+
+// ----------------------------------------------------------------------
+// Drops all cache entries, and resets counters.
+static void le_2d_clear_cache() {
+	get_geometry_cache().clear();
+}
+
+// ----------------------------------------------------------------------
+
+static void le_2d_get_cache_stats( le_2d_api::cache_stats_t *stats ) {
+	auto const cache_stats   = get_geometry_cache().get_stats();
+	stats->hits              = cache_stats.hits;
+	stats->misses            = cache_stats.misses;
+	stats->evictions         = cache_stats.evictions;
+	stats->num_entries       = cache_stats.num_entries;
+	stats->size_in_bytes     = cache_stats.size_in_bytes;
+	stats->capacity_in_bytes = cache_stats.capacity_in_bytes;
+}
+
 // ----------------------------------------------------------------------
 // internal method, only triggered if le_2d is destroyed.
 static void le_2d_draw_primitives( le_2d_o *self ) {
 
-	/* We might want to do some sorting, and optimising here
-	 * Sort by pipeline for example. Also, issue draw commands
-	 * as instanced draws if more than three of the same prims
-	 * are issued.
+	/* Primitives which share geometry are drawn as instances of one
+	 * draw call, wherever this does not change the result of drawing
+	 * primitives in order - see sorting into batches below.
 	 */
 
 	le::Encoder encoder{ self->encoder };
@@ -674,6 +1061,33 @@ static void le_2d_draw_primitives( le_2d_o *self ) {
 //				.setFrontFace(le::FrontFace::eCounterClockwise)
 			.end()
 	        .build();
+
+	// Circles, ellipses, arcs, and lines, when drawn using signed distance functions:
+	// each instance is a unit quad, which the vertex shader fits around the shape.
+	static le_shader_module_o *sdf_vert = le_backend_vk::le_pipeline_manager_i.create_shader_module( pm, "./resources/shaders/2d_primitives_sdf.vert", { le::ShaderStage::eVertex }, "" );
+	static le_shader_module_o *sdf_frag = le_backend_vk::le_pipeline_manager_i.create_shader_module( pm, "./resources/shaders/2d_primitives_sdf.frag", { le::ShaderStage::eFragment }, "" );
+
+	static auto sdf_pipeline =
+	    LeGraphicsPipelineBuilder( pm )
+	        .addShaderStage( sdf_vert )
+	        .addShaderStage( sdf_frag )
+	        .withAttributeBindingState()
+	            .addBinding( sizeof( VertexData2D ) )
+	                .setInputRate( le_vertex_input_rate::ePerVertex )
+	                .addAttribute( offsetof( VertexData2D, pos ), le_num_type::eF32, 2 )
+	            .end()
+	            .addBinding( sizeof( SdfInstanceData2D ) )
+	                .setInputRate( le_vertex_input_rate::ePerInstance )
+	                .addAttribute( offsetof( SdfInstanceData2D, translation ), le_num_type::eF32, 2 )
+	                .addAttribute( offsetof( SdfInstanceData2D, radii ), le_num_type::eF32, 2 )
+	                .addAttribute( offsetof( SdfInstanceData2D, angles ), le_num_type::eF32, 2 )
+	                .addAttribute( offsetof( SdfInstanceData2D, rotation_ccw ), le_num_type::eF32, 1 )
+	                .addAttribute( offsetof( SdfInstanceData2D, stroke_weight ), le_num_type::eF32, 1 )
+	                .addAttribute( offsetof( SdfInstanceData2D, color ), le_num_type::eU32, 1 )
+	                .addAttribute( offsetof( SdfInstanceData2D, flags ), le_num_type::eU32, 1 )
+	            .end()
+	        .end()
+	        .build();
 	// clang-format on
 
 	// Note: we can use DepthCompareOp::NotEqual to prevent overdraw for individual paths.
@@ -708,100 +1122,380 @@ static void le_2d_draw_primitives( le_2d_o *self ) {
 	encoder
 	    .setArgumentData( LE_ARGUMENT_NAME( "Mvp" ), &ortho_projection, sizeof( glm::mat4 ) );
 
-	// Update sort key for all primitives
+	// Update sort key for all primitives - lines first move into their local
+	// space, so that their hash does not depend on where they are placed.
+	// Bulk lines are in local space already, and don't use their node.
 
 	for ( auto &p : self->primitives ) {
+		if ( p->type == le_2d_primitive_o::Type::eLine && p->num_bulk_instances == 0 ) {
+			le_2d_primitive_line_to_local_space( p );
+		}
 		le_2d_primitive_update_hash( p );
 	}
 
-	// Now, we do essentially run-length encoding.
+	// Cull primitives, and bulk instances, which lie entirely outside the
+	// renderpass extent - wherever we can calculate bounds up front, we do
+	// so before generating any geometry.
+	//
+	// Culling tests each instance against the viewport rectangle once per
+	// frame, which is constant cost per instance.
+
+	vec2f const viewport_min{ 0.f };
+	vec2f const viewport_max{ float( extents.width ), float( extents.height ) };
+
+	static constexpr uint32_t SDF_GEOMETRY_INDEX = ~uint32_t( 0 ); // geometry index shared by all sdf primitives
+
+	// A primitive which survived culling.
+	struct DrawItem {
+		uint32_t geometry_index; // index into geometry_data, or SDF_GEOMETRY_INDEX
+		uint32_t first_instance; // index into instances, or sdf_instances
+		uint32_t instance_count; // number of instances which survived culling
+		bool     has_bounds;     // false if bounds depend on geometry, which is not yet available
+		vec2f    bbox_min;       // union of bounding boxes of all instances, in canvas space
+		vec2f    bbox_max;
+	};
 
-	std::vector<std::vector<VertexData2D>> geometry_data;
-	std::vector<PrimitiveInstanceData2D>   per_instance_data;
-	per_instance_data.reserve( self->primitives.size() );
+	bool const use_sdf = self->render_mode == RenderMode::eRenderModeSdf;
 
-	struct InstancedDraw {
-		uint32_t geometry_data_index; // which geometry
-		uint32_t instance_data_index; // first index for instance data
-		uint32_t instance_count;      // number of instances with same geometry
-	};
+	std::vector<DrawItem>                items;         // in draw order
+	std::vector<PrimitiveInstanceData2D> instances;     // instances which survived culling, in draw order
+	std::vector<SdfInstanceData2D>       sdf_instances; // sdf instances which survived culling, in draw order
+	items.reserve( self->primitives.size() );
 
-	std::vector<InstancedDraw> instanced_draws;
+	// Geometry is fetched once for each distinct hash. Primitives which share
+	// a hash share geometry, and may be drawn as instances of a single draw.
 
-	uint32_t previous_hash = 0;
+	std::vector<le_2d_primitive_o *>       geometry_primitives; // one primitive per distinct hash
+	std::unordered_map<uint64_t, uint32_t> geometry_index_for_hash;
+	geometry_index_for_hash.reserve( self->primitives.size() );
 
 	for ( auto const &p : self->primitives ) {
 
-		if ( instanced_draws.empty() ) {
+		DrawItem item{};
+		item.bbox_min = vec2f( std::numeric_limits<float>::max() );
+		item.bbox_max = vec2f( std::numeric_limits<float>::lowest() );
 
-			std::vector<VertexData2D> geometry;
+		PrimitiveInstanceData2D const  node_instance = get_instance_data( p );
+		PrimitiveInstanceData2D const *p_instances   = &node_instance;
+		uint32_t                       num_instances = 1;
 
-			generate_geometry_for_primitive( p, geometry );
-			geometry_data.emplace_back( geometry );
+		if ( p->num_bulk_instances ) {
+			p_instances   = self->bulk_instances.data() + p->first_bulk_instance;
+			num_instances = p->num_bulk_instances;
+		}
 
-			PrimitiveInstanceData2D instance_data{};
-			instance_data.color        = p->material.color;
-			instance_data.rotation_ccw = p->node.rotation_ccw;
-			instance_data.scale        = p->node.scale;
-			instance_data.translation  = p->node.translation;
+		if ( use_sdf && is_sdf_primitive( p ) ) {
 
-			per_instance_data.emplace_back( instance_data );
+			// Sdf primitives don't need any geometry - we calculate their instance
+			// data right away instead, as this also gives us their bounding box.
 
-			instanced_draws.push_back( { 0, 0, 1 } );
-			previous_hash = p->hash;
-			continue;
+			item.geometry_index = SDF_GEOMETRY_INDEX;
+			item.first_instance = uint32_t( sdf_instances.size() );
+			item.has_bounds     = true;
+
+			for ( uint32_t j = 0; j != num_instances; j++ ) {
+				SdfInstanceData2D sdf;
+				vec2f             i_min, i_max;
+
+				if ( !get_sdf_instance_data( p, p_instances[ j ], sdf ) ) {
+					continue;
+				}
+
+				get_sdf_instance_bounding_box( sdf, i_min, i_max );
+
+				if ( !bounding_boxes_overlap( i_min, i_max, viewport_min, viewport_max ) ) {
+					continue;
+				}
+
+				item.bbox_min = glm::min( item.bbox_min, i_min );
+				item.bbox_max = glm::max( item.bbox_max, i_max );
+				sdf_instances.push_back( sdf );
+			}
+
+			item.instance_count = uint32_t( sdf_instances.size() ) - item.first_instance;
+
+		} else {
+
+			vec2f local_min, local_max;
+
+			item.has_bounds     = get_primitive_bounding_box( p, local_min, local_max );
+			item.first_instance = uint32_t( instances.size() );
+
+			for ( uint32_t j = 0; j != num_instances; j++ ) {
+
+				if ( item.has_bounds ) {
+					vec2f i_min, i_max;
+					get_instance_bounding_box( p_instances[ j ], local_min, local_max, i_min, i_max );
+
+					if ( !bounding_boxes_overlap( i_min, i_max, viewport_min, viewport_max ) ) {
+						continue;
+					}
+
+					item.bbox_min = glm::min( item.bbox_min, i_min );
+					item.bbox_max = glm::max( item.bbox_max, i_max );
+				}
+
+				instances.push_back( p_instances[ j ] );
+			}
+
+			item.instance_count = uint32_t( instances.size() ) - item.first_instance;
+
+			if ( item.instance_count ) {
+				auto [ it, was_inserted ] = geometry_index_for_hash.emplace( p->hash, uint32_t( geometry_primitives.size() ) );
+
+				if ( was_inserted ) {
+					geometry_primitives.push_back( p );
+				}
+
+				item.geometry_index = it->second;
+			}
+		}
+
+		if ( item.instance_count ) {
+			items.push_back( item );
 		}
+	}
 
-		uint32_t hash = p->hash;
+	// Generate geometry for all distinct hashes which survived culling - or
+	// fetch it from cache. Cache misses are generated on le_jobs workers.
 
-		if ( hash != previous_hash ) {
+	std::vector<std::shared_ptr<Geometry const>> geometry_data( geometry_primitives.size() );
+	fetch_geometry_for_primitives( geometry_primitives.data(), geometry_primitives.size(), geometry_data.data() );
 
-			instanced_draws.push_back( { uint32_t( geometry_data.size() ),
-			                             uint32_t( per_instance_data.size() ),
-			                             1 } );
-			// geometry has changed.
+	// Now that we have geometry, cull whatever we could not cull up front, and
+	// drop anything without geometry, as it has nothing to draw.
 
-			std::vector<VertexData2D> geometry;
+	{
+		size_t num_items = 0;
 
-			generate_geometry_for_primitive( p, geometry );
-			geometry_data.emplace_back( geometry );
+		for ( auto &item : items ) {
 
-			PrimitiveInstanceData2D instance_data{};
-			instance_data.color        = p->material.color;
-			instance_data.rotation_ccw = p->node.rotation_ccw;
-			instance_data.scale        = p->node.scale;
-			instance_data.translation  = p->node.translation;
+			if ( item.geometry_index != SDF_GEOMETRY_INDEX ) {
 
-			per_instance_data.emplace_back( instance_data );
+				Geometry const &geometry = *geometry_data[ item.geometry_index ];
 
-			previous_hash = hash;
+				if ( geometry.vertices.empty() ) {
+					continue;
+				}
+
+				if ( !item.has_bounds ) {
+					for ( uint32_t j = 0; j != item.instance_count; j++ ) {
+						vec2f i_min, i_max;
+						get_instance_bounding_box( instances[ item.first_instance + j ], geometry.bbox_min, geometry.bbox_max, i_min, i_max );
+						item.bbox_min = glm::min( item.bbox_min, i_min );
+						item.bbox_max = glm::max( item.bbox_max, i_max );
+					}
+
+					if ( !bounding_boxes_overlap( item.bbox_min, item.bbox_max, viewport_min, viewport_max ) ) {
+						continue;
+					}
+				}
+			}
+
+			items[ num_items++ ] = item;
+		}
+
+		items.resize( num_items );
+	}
+
+	// Sort primitives into batches of instances which share geometry.
+	//
+	// A primitive may join a batch which was started earlier only if it does
+	// not overlap any batch which comes after that batch in draw order -
+	// otherwise we would draw it underneath something which was drawn before
+	// it. This keeps painter's order wherever primitives overlap, while
+	// interleaved primitives which don't overlap - circle, line, circle, line
+	// - end up as a single draw per geometry. We can't use depth to resolve
+	// order instead, since primitives are alpha-blended.
+	//
+	// We only look back a limited number of batches, so that sorting stays
+	// linear in the number of primitives.
+	//
+	// Primitives drawn using signed distance functions all share the same
+	// quad, and therefore all share the same batch key, whatever their shape.
+
+	static constexpr size_t MAX_BATCH_LOOKBACK = 64;
+
+	struct Batch {
+		uint32_t geometry_index;
+		uint32_t instance_count;
+		vec2f    bbox_min; // union of bounding boxes of all instances, in canvas space
+		vec2f    bbox_max;
+	};
+
+	std::vector<Batch>    batches;
+	std::vector<uint32_t> batch_index_for_item;
+	batch_index_for_item.reserve( items.size() );
+
+	for ( auto const &item : items ) {
+
+		size_t       batch_index = batches.size();
+		size_t const lookback    = std::min( batches.size(), MAX_BATCH_LOOKBACK );
+
+		for ( size_t i = batches.size(); i-- > batches.size() - lookback; ) {
+			auto const &b = batches[ i ];
+			if ( b.geometry_index == item.geometry_index ) {
+				batch_index = i;
+				break;
+			}
+			if ( bounding_boxes_overlap( item.bbox_min, item.bbox_max, b.bbox_min, b.bbox_max ) ) {
+				break; // overlap: we must draw after this batch.
+			}
+		}
+
+		if ( batch_index == batches.size() ) {
+			batches.push_back( { item.geometry_index, item.instance_count, item.bbox_min, item.bbox_max } );
 		} else {
+			auto &b = batches[ batch_index ];
+			b.instance_count += item.instance_count;
+			b.bbox_min = glm::min( b.bbox_min, item.bbox_min );
+			b.bbox_max = glm::max( b.bbox_max, item.bbox_max );
+		}
 
-			PrimitiveInstanceData2D instance_data{};
-			instance_data.color        = p->material.color;
-			instance_data.rotation_ccw = p->node.rotation_ccw;
-			instance_data.scale        = p->node.scale;
-			instance_data.translation  = p->node.translation;
+		batch_index_for_item.push_back( uint32_t( batch_index ) );
+	}
+
+	// Lay out instance data so that instances of each batch are contiguous,
+	// and in the order in which they were drawn. Sdf instances go into an
+	// array of their own, as their layout differs.
+
+	std::vector<uint32_t> first_instance_for_batch;
+	first_instance_for_batch.reserve( batches.size() );
+
+	uint32_t num_instances     = 0;
+	uint32_t num_sdf_instances = 0;
+	for ( auto const &b : batches ) {
+		uint32_t &count = ( b.geometry_index == SDF_GEOMETRY_INDEX ) ? num_sdf_instances : num_instances;
+		first_instance_for_batch.push_back( count );
+		count += b.instance_count;
+	}
+
+	std::vector<PrimitiveInstanceData2D> per_instance_data( num_instances );
+	std::vector<SdfInstanceData2D>       sdf_instance_data( num_sdf_instances );
+
+	{
+		std::vector<uint32_t> next_instance_for_batch = first_instance_for_batch;
+
+		for ( size_t i = 0; i != items.size(); i++ ) {
+			auto const &item  = items[ i ];
+			uint32_t &  first = next_instance_for_batch[ batch_index_for_item[ i ] ];
+
+			if ( item.geometry_index == SDF_GEOMETRY_INDEX ) {
+				auto const src = sdf_instances.begin() + item.first_instance;
+				std::copy( src, src + item.instance_count, sdf_instance_data.begin() + first );
+			} else {
+				auto const src = instances.begin() + item.first_instance;
+				std::copy( src, src + item.instance_count, per_instance_data.begin() + first );
+			}
+
+			first += item.instance_count;
+		}
+	}
+
+	// Upload vertices for all geometry which is drawn, and all instance data, in
+	// one go each - draws then pick their range via first vertex, and first instance.
+	// The quad for sdf primitives goes at the end of vertex data.
+
+	static constexpr uint32_t NOT_UPLOADED = ~uint32_t( 0 );
 
-			per_instance_data.emplace_back( instance_data );
+	std::vector<uint32_t>     first_vertex_for_geometry( geometry_data.size(), NOT_UPLOADED );
+	std::vector<VertexData2D> vertex_data;
 
-			instanced_draws.back().instance_count++;
+	for ( auto const &b : batches ) {
+		if ( b.geometry_index == SDF_GEOMETRY_INDEX ) {
+			continue;
+		}
+
+		uint32_t &first_vertex = first_vertex_for_geometry[ b.geometry_index ];
+
+		if ( first_vertex == NOT_UPLOADED ) {
+			auto const &vertices = geometry_data[ b.geometry_index ]->vertices;
+			first_vertex         = uint32_t( vertex_data.size() );
+			vertex_data.insert( vertex_data.end(), vertices.begin(), vertices.end() );
 		}
 	}
 
-	for ( auto &d : instanced_draws ) {
+	static VertexData2D const sdf_quad[ 6 ] = {
+	    { { -1.f, -1.f }, { 0.f, 0.f } },
+	    { { 1.f, -1.f }, { 1.f, 0.f } },
+	    { { 1.f, 1.f }, { 1.f, 1.f } },
+	    { { -1.f, -1.f }, { 0.f, 0.f } },
+	    { { 1.f, 1.f }, { 1.f, 1.f } },
+	    { { -1.f, 1.f }, { 0.f, 1.f } },
+	};
+
+	uint32_t const first_vertex_for_sdf_quad = uint32_t( vertex_data.size() );
+
+	if ( num_sdf_instances ) {
+		vertex_data.insert( vertex_data.end(), std::begin( sdf_quad ), std::end( sdf_quad ) );
+	}
 
-		auto &geom = geometry_data[ d.geometry_data_index ];
+	if ( vertex_data.empty() ) {
+		return;
+	}
+
+	// Both pipelines read vertices from binding 0, and instances from binding 1. We
+	// keep hold of where instance data was uploaded to, so that we can re-bind binding 1
+	// whenever we switch pipelines.
+
+	le_renderer_api::command_buffer_encoder_interface_t::buffer_binding_info_o instance_buffer_for_pipeline[ 2 ]{}; // 0: tessellated, 1: sdf
+
+	encoder.setVertexData( vertex_data.data(), sizeof( VertexData2D ) * vertex_data.size(), 0 );
+
+	if ( num_sdf_instances ) {
+		encoder.setVertexData( sdf_instance_data.data(), sizeof( SdfInstanceData2D ) * sdf_instance_data.size(), 1, &instance_buffer_for_pipeline[ 1 ] );
+	}
+
+	if ( num_instances ) {
+		encoder.setVertexData( per_instance_data.data(), sizeof( PrimitiveInstanceData2D ) * per_instance_data.size(), 1, &instance_buffer_for_pipeline[ 0 ] );
+	}
+
+	// Tessellated pipeline is bound at this point, and so is its instance
+	// data, since it was uploaded last.
+	uint32_t bound_pipeline = num_instances ? 0 : ~uint32_t( 0 );
+
+	for ( size_t i = 0; i != batches.size(); i++ ) {
+
+		auto const &b = batches[ i ];
+
+		uint32_t const pipeline_index = ( b.geometry_index == SDF_GEOMETRY_INDEX ) ? 1 : 0;
+		uint32_t       vertex_count;
+		uint32_t       first_vertex;
+
+		if ( pipeline_index == 1 ) {
+			vertex_count = 6;
+			first_vertex = first_vertex_for_sdf_quad;
+		} else {
+			auto const &geom = *geometry_data[ b.geometry_index ];
+			vertex_count     = uint32_t( geom.vertices.size() );
+			first_vertex     = first_vertex_for_geometry[ b.geometry_index ];
+		}
+
+		if ( vertex_count == 0 ) {
+			continue;
+		}
+
+		if ( pipeline_index != bound_pipeline ) {
+			auto const &instance_buffer = instance_buffer_for_pipeline[ pipeline_index ];
+			encoder
+			    .bindGraphicsPipeline( pipeline_index == 1 ? sdf_pipeline : pipeline )
+			    .setArgumentData( LE_ARGUMENT_NAME( "Mvp" ), &ortho_projection, sizeof( glm::mat4 ) )
+			    .bindVertexBuffers( 1, 1, &instance_buffer.resource, &instance_buffer.offset );
+			bound_pipeline = pipeline_index;
+		}
 
-		encoder
-		    .setVertexData( geom.data(), sizeof( VertexData2D ) * geom.size(), 0 )
-		    .setVertexData( per_instance_data.data() + d.instance_data_index, d.instance_count * sizeof( PrimitiveInstanceData2D ), 1 )
-		    .draw( uint32_t( geom.size() ), d.instance_count );
+		encoder.draw( vertex_count, b.instance_count, first_vertex, first_instance_for_batch[ i ] );
 	}
 }
 
 // ----------------------------------------------------------------------
 
+static void le_2d_set_render_mode( le_2d_o *self, RenderMode mode ) {
+	self->render_mode = mode;
+}
+
+// ----------------------------------------------------------------------
+
 static void le_2d_destroy( le_2d_o *self ) {
 	//	std::cout << "destroy 2d ctx: " << std::dec << self->id << std::flush << std::endl;
 
@@ -821,22 +1515,29 @@ static void le_2d_destroy( le_2d_o *self ) {
 		default:
 			break;
 		}
-
-		delete p;
 	}
 
+	// Frees all primitives in one go.
 	delete self;
 }
 
 // ----------------------------------------------------------------------
 
 static le_2d_primitive_o *le_2d_allocate_primitive( le_2d_o *self ) {
-	le_2d_primitive_o *p = new le_2d_primitive_o();
 
-	p->hash              = 0;
-	p->node.scale        = vec2f{ 1 };
-	p->node.translation  = vec2f{ 0 };
-	p->node.rotation_ccw = 0;
+	if ( self->primitive_blocks.empty() || self->num_primitives_in_last_block == le_2d_o::PRIMITIVE_BLOCK_SIZE ) {
+		self->primitive_blocks.emplace_back( new le_2d_primitive_o[ le_2d_o::PRIMITIVE_BLOCK_SIZE ] );
+		self->num_primitives_in_last_block = 0;
+	}
+
+	le_2d_primitive_o *p = &self->primitive_blocks.back()[ self->num_primitives_in_last_block++ ];
+
+	// Primitives are hashed bytewise, padding included - see `le_2d_primitive_update_hash`.
+	// We must therefore zero the whole primitive, since blocks may be recycled memory,
+	// and constructing a primitive does not clear padding.
+	memset( static_cast<void *>( p ), 0, sizeof( le_2d_primitive_o ) );
+
+	p->node.scale = vec2f{ 1 };
 
 	p->material.color            = 0xffffffff;
 	p->material.stroke_weight    = 1.f;
@@ -844,8 +1545,6 @@ static le_2d_primitive_o *le_2d_allocate_primitive( le_2d_o *self ) {
 	p->material.stroke_cap_type  = StrokeCapType::eStrokeCapRound;
 	p->material.stroke_join_type = StrokeJoinType::eStrokeJoinRound;
 
-	memset( p->data.as_data, 0, sizeof( p->data ) );
-
 	self->primitives.push_back( p );
 
 	return p;
@@ -929,6 +1628,78 @@ static le_2d_primitive_o *le_2d_primitive_create_path( le_2d_o *context ) {
 	return p;
 }
 
+// ----------------------------------------------------------------------
+// Adds `count` filled circles as instances of a single bulk primitive. All
+// circles share one unit circle, which is scaled by each circle's radius,
+// and tessellated finely enough for the largest circle.
+static void le_2d_add_circles( le_2d_o *self, size_t count, vec2f const *positions, float const *radii, uint32_t const *colors ) {
+
+	if ( count == 0 ) {
+		return;
+	}
+
+	float max_radius = 0;
+	for ( size_t i = 0; i != count; i++ ) {
+		max_radius = std::max( max_radius, radii[ i ] );
+	}
+
+	if ( max_radius <= 0 ) {
+		return;
+	}
+
+	auto p = le_2d_allocate_primitive( self );
+
+	p->type                     = le_2d_primitive_o::Type::eCircle;
+	p->data.as_circle.radius    = 1.f;
+	p->data.as_circle.tolerance = 0.5f / max_radius;
+	p->material.filled          = true;
+	p->first_bulk_instance      = uint32_t( self->bulk_instances.size() );
+	p->num_bulk_instances       = uint32_t( count );
+
+	self->bulk_instances.resize( self->bulk_instances.size() + count );
+
+	auto *instance = self->bulk_instances.data() + p->first_bulk_instance;
+
+	for ( size_t i = 0; i != count; i++, instance++ ) {
+		instance->translation  = positions[ i ];
+		instance->scale        = vec2f( radii[ i ] );
+		instance->rotation_ccw = 0;
+		instance->color        = colors ? colors[ i ] : 0xffffffff;
+	}
+}
+
+// ----------------------------------------------------------------------
+// Adds `count` lines as instances of a single bulk primitive. All lines
+// share one line of unit length, which is scaled to length, and rotated
+// into place for each line.
+static void le_2d_add_lines( le_2d_o *self, size_t count, vec2f const *p0, vec2f const *p1, float stroke_weight, uint32_t const *colors ) {
+
+	if ( count == 0 ) {
+		return;
+	}
+
+	auto p = le_2d_allocate_primitive( self );
+
+	p->type                   = le_2d_primitive_o::Type::eLine;
+	p->data.as_line.p0        = { 0.f, 0.f };
+	p->data.as_line.p1        = { 1.f, 0.f };
+	p->material.stroke_weight = stroke_weight;
+	p->first_bulk_instance    = uint32_t( self->bulk_instances.size() );
+	p->num_bulk_instances     = uint32_t( count );
+
+	self->bulk_instances.resize( self->bulk_instances.size() + count );
+
+	auto *instance = self->bulk_instances.data() + p->first_bulk_instance;
+
+	for ( size_t i = 0; i != count; i++, instance++ ) {
+		vec2f const d          = p1[ i ] - p0[ i ];
+		instance->translation  = p0[ i ];
+		instance->scale        = { glm::length( d ), 1.f };
+		instance->rotation_ccw = atan2f( d.y, d.x );
+		instance->color        = colors ? colors[ i ] : 0xffffffff;
+	}
+}
+
 // ----------------------------------------------------------------------
 
 static void le_2d_primitive_path_move_to( le_2d_primitive_o *p, vec2f const *pos ) {
@@ -1069,6 +1840,12 @@ LE_MODULE_REGISTER_IMPL( le_2d, api ) {
 	le_2d_i.create  = le_2d_create;
 	le_2d_i.destroy = le_2d_destroy;
 
+	le_2d_i.set_render_mode = le_2d_set_render_mode;
+
+	le_2d_i.get_cache_stats    = le_2d_get_cache_stats;
+	le_2d_i.set_cache_capacity = le_2d_set_cache_capacity;
+	le_2d_i.clear_cache        = le_2d_clear_cache;
+
 	auto &le_2d_primitive_i = static_cast<le_2d_api *>( api )->le_2d_primitive_i;
 
 #define SET_PRIMITIVE_FPTR( prim_type, field_name ) \
@@ -1107,6 +1884,9 @@ LE_MODULE_REGISTER_IMPL( le_2d, api ) {
 	le_2d_primitive_i.create_circle  = le_2d_primitive_create_circle;
 	le_2d_primitive_i.create_line    = le_2d_primitive_create_line;
 
+	le_2d_primitive_i.add_circles = le_2d_add_circles;
+	le_2d_primitive_i.add_lines   = le_2d_add_lines;
+
 	le_2d_primitive_i.set_node_position    = le_2d_primitive_set_node_position;
 	le_2d_primitive_i.set_stroke_weight    = le_2d_primitive_set_stroke_weight;
 	le_2d_primitive_i.set_stroke_cap_type  = le_2d_primitive_set_stroke_cap_type;
@@ -38,6 +38,10 @@ struct le_2d_api {
 		eStrokeCapRound,
 		eStrokeCapSquare,
 	};
+	enum RenderMode : uint32_t {
+		eRenderModeTessellated = 0, // all primitives are tessellated on the cpu
+		eRenderModeSdf,             // circles, ellipses, arcs, and lines are drawn as quads, shaded using signed distance functions
+	};
 	
 
 	struct le_2d_primitive_interface_t{
@@ -76,6 +80,11 @@ struct le_2d_api {
 
 		le_2d_primitive_o* (*create_path)(le_2d_o* context);
 
+		// Bulk primitives: add `count` filled circles, or lines, in one go. These are drawn as instances of a single
+		// primitive, and don't create individual primitive objects. `colors` may be nullptr, in which case all are white.
+		void ( *add_circles )( le_2d_o* context, size_t count, glm::vec2 const* positions, float const* radii, uint32_t const* colors );
+		void ( *add_lines   )( le_2d_o* context, size_t count, glm::vec2 const* p0, glm::vec2 const* p1, float stroke_weight, uint32_t const* colors );
+
 		SETTER_DECLARE( path, float, tolerance);
 
 		void (*path_move_to)(le_2d_primitive_o* p, glm::vec2 const * pos);
@@ -93,11 +102,32 @@ struct le_2d_api {
 		#undef SETTER_DECLARE
 	};
 
+	struct cache_stats_t {
+		uint64_t hits;              // number of primitives which found their geometry in cache
+		uint64_t misses;            // number of primitives which had to generate their geometry
+		uint64_t evictions;         // number of entries evicted to stay within capacity
+		uint64_t num_entries;       // number of entries currently held by cache
+		uint64_t size_in_bytes;     // approximate memory used by entries currently held by cache
+		uint64_t capacity_in_bytes; // maximum memory cache may use, 0 if cache is disabled
+	};
+
 	struct le_2d_interface_t {
 
 		le_2d_o *    ( * create                   ) ( le_command_buffer_encoder_o* encoder);
 		void         ( * destroy                  ) ( le_2d_o* self );
 
+		// Applies to all primitives drawn via this context, defaults to eRenderModeTessellated.
+		// Paths are always tessellated.
+		void         ( * set_render_mode          ) ( le_2d_o* self, RenderMode mode );
+
+		// Geometry generated for primitives is cached across frames, keyed by everything
+		// which influences the shape of a primitive. The cache is shared by all contexts,
+		// and evicts least recently used entries once it would grow beyond its capacity.
+		// Set capacity to 0 to disable it. Paths are not cached here, but by le_path.
+		void         ( * get_cache_stats          ) ( cache_stats_t* stats );
+		void         ( * set_cache_capacity       ) ( size_t capacity_in_bytes );
+		void         ( * clear_cache              ) ( ); // drops all entries, and resets counters
+
 	};
 
 	le_2d_interface_t			le_2d_i;
@@ -121,6 +151,7 @@ class Le2D : NoCopy, NoMove {
 
 	using StrokeJoinType = le_2d_api::StrokeJoinType;
 	using StrokeCapType  = le_2d_api::StrokeCapType;
+	using RenderMode     = le_2d_api::RenderMode;
 
 #	define BUILDER_IMPLEMENT_VEC( builder_type, obj_name, field_type, field_name ) \
 		builder_type &set_##field_name( field_type field_name ) {                   \
@@ -144,6 +175,11 @@ class Le2D : NoCopy, NoMove {
 		le_2d::le_2d_i.destroy( self );
 	}
 
+	Le2D &set_render_mode( RenderMode mode ) {
+		le_2d::le_2d_i.set_render_mode( self, mode );
+		return *this;
+	}
+
 	// ---
 
 	class CircleBuilder {
@@ -481,6 +517,18 @@ class Le2D : NoCopy, NoMove {
 	PathBuilder &path() {
 		return mPathBuilder.create();
 	}
+
+	// ---
+
+	Le2D &add_circles( size_t count, glm::vec2 const *positions, float const *radii, uint32_t const *colors = nullptr ) {
+		le_2d::le_2d_prim_i.add_circles( self, count, positions, radii, colors );
+		return *this;
+	}
+
+	Le2D &add_lines( size_t count, glm::vec2 const *p0, glm::vec2 const *p1, float stroke_weight = 1.f, uint32_t const *colors = nullptr ) {
+		le_2d::le_2d_prim_i.add_lines( self, count, p0, p1, stroke_weight, colors );
+		return *this;
+	}
 #	undef BUILDER_IMPLEMENT
 #	undef BUILDER_IMPLEMENT_VEC
 };
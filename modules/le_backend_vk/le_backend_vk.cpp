@@ -9,6 +9,7 @@
 #include "le_window/le_window.h"
 #include "le_renderer/le_renderer.h"
 #include "le_renderer/private/le_renderer_types.h"
+#include "le_trace/le_trace.h"
 
 #include "3rdparty/src/spooky/SpookyV2.h" // for hashing renderpass gestalt
 
@@ -859,12 +860,15 @@ static uint32_t backend_get_swapchain_count( le_backend_o *self ) {
 
 // ----------------------------------------------------------------------
 
-static void backend_reset_swapchain( le_backend_o *self, uint32_t index ) {
+// Re-creates swapchain with given settings - if settings is nullptr, the
+// swapchain is re-created using its current settings.
+// Caller must make sure that no frames which use this swapchain are in flight.
+static void backend_reset_swapchain_with_settings( le_backend_o *self, uint32_t index, le_swapchain_settings_t const *settings ) {
 	using namespace le_swapchain_vk;
 
 	assert( index < self->swapchains.size() );
 
-	swapchain_i.reset( self->swapchains[ index ], nullptr );
+	swapchain_i.reset( self->swapchains[ index ], settings );
 
 	std::cout << "NOTICE: Resetting swapchain with index: " << index << std::flush << std::endl;
 
@@ -874,6 +878,20 @@ static void backend_reset_swapchain( le_backend_o *self, uint32_t index ) {
 	self->swapchainHeight[ index ] = swapchain_i.get_image_height( self->swapchains[ index ] );
 }
 
+// ----------------------------------------------------------------------
+
+static void backend_reset_swapchain( le_backend_o *self, uint32_t index ) {
+	backend_reset_swapchain_with_settings( self, index, nullptr );
+}
+
+// ----------------------------------------------------------------------
+
+static bool backend_get_swapchain_stats( le_backend_o *self, uint32_t index, le_swapchain_stats_t *stats ) {
+	using namespace le_swapchain_vk;
+	assert( index < self->swapchains.size() );
+	return swapchain_i.get_stats( self->swapchains[ index ], stats );
+}
+
 // ----------------------------------------------------------------------
 /// \brief reset any swapchains for which at least one swapchain_state
 /// did not present successfully
@@ -1048,6 +1066,8 @@ static void backend_setup( le_backend_o *self, le_backend_vk_settings_t *setting
 
 	// -- setup backend memory objects
 
+	// Number of frames is fixed from here on - it does not follow the image count
+	// of swapchains which get re-created with different settings later.
 	auto frameCount = backend_get_num_swapchain_images( self );
 
 	self->mFrames.reserve( frameCount );
@@ -4069,6 +4089,8 @@ static void debug_print_command( void *&cmd ) {
 // translate into vk specific commands.
 static void backend_process_frame( le_backend_o *self, size_t frameIndex ) {
 
+	LE_TRACE_ZONE( "backend_process_frame" );
+
 	if ( PRINT_DEBUG_MESSAGES ) {
 		std::cout << "** Process Frame #" << std::dec << std::setw( 8 ) << frameIndex << " **" << std::endl
 		          << std::flush;
@@ -5568,6 +5590,7 @@ LE_MODULE_REGISTER_IMPL( le_backend_vk, api_ ) {
 	vk_backend_i.setup                      = backend_setup;
 	vk_backend_i.get_num_swapchain_images   = backend_get_num_swapchain_images;
 	vk_backend_i.reset_swapchain            = backend_reset_swapchain;
+	vk_backend_i.reset_swapchain_with_settings = backend_reset_swapchain_with_settings;
 	vk_backend_i.reset_failed_swapchains    = backend_reset_failed_swapchains;
 	vk_backend_i.get_transient_allocators   = backend_get_transient_allocators;
 	vk_backend_i.get_staging_allocator      = backend_get_staging_allocator;
@@ -5585,6 +5608,7 @@ LE_MODULE_REGISTER_IMPL( le_backend_vk, api_ ) {
 	vk_backend_i.get_swapchain_extent   = backend_get_swapchain_extent;
 	vk_backend_i.get_swapchain_count    = backend_get_swapchain_count;
 	vk_backend_i.get_swapchain_info     = backend_get_swapchain_info;
+	vk_backend_i.get_swapchain_stats    = backend_get_swapchain_stats;
 
 	vk_backend_i.create_rtx_blas_info = backend_create_rtx_blas_info;
 	vk_backend_i.create_rtx_tlas_info = backend_create_rtx_tlas_info;
@@ -8,6 +8,7 @@ struct le_backend_o;
 struct le_backend_vk_api;
 
 struct le_swapchain_settings_t;
+struct le_swapchain_stats_t;
 struct le_window_o;
 
 struct le_backend_vk_instance_o; // defined in le_instance_vk.cpp
@@ -99,6 +100,7 @@ struct le_backend_vk_api {
 
 		size_t                 ( *get_num_swapchain_images   ) ( le_backend_o *self );
 		void                   ( *reset_swapchain            ) ( le_backend_o *self, uint32_t index );
+		void                   ( *reset_swapchain_with_settings ) ( le_backend_o *self, uint32_t index, le_swapchain_settings_t const * settings );
 		void                   ( *reset_failed_swapchains    ) ( le_backend_o *self );
 		le_allocator_o**       ( *get_transient_allocators   ) ( le_backend_o* self, size_t frameIndex);
 		le_staging_allocator_o*( *get_staging_allocator      ) ( le_backend_o* self, size_t frameIndex);
@@ -112,6 +114,7 @@ struct le_backend_vk_api {
 		le_resource_handle_t   ( *get_swapchain_resource    ) ( le_backend_o* self, uint32_t index );
 		uint32_t			   ( *get_swapchain_count       ) ( le_backend_o* self );
 		bool                   ( *get_swapchain_info        ) ( le_backend_o* self, uint32_t *count, uint32_t* p_width, uint32_t * p_height, le_resource_handle_t* p_handlle );
+		bool                   ( *get_swapchain_stats       ) ( le_backend_o* self, uint32_t index, le_swapchain_stats_t* stats );
 
 		le_rtx_blas_info_handle( *create_rtx_blas_info )(le_backend_o* self, le_rtx_geometry_t const * geometries, uint32_t geometries_count, struct LeBuildAccelerationStructureFlags const * flags);
 		le_rtx_tlas_info_handle( *create_rtx_tlas_info )(le_backend_o* self,  uint32_t instances_count, struct LeBuildAccelerationStructureFlags const * flags);
@@ -188,6 +191,7 @@ struct le_backend_vk_api {
 		bool                                     ( *introduce_graphics_pipeline_state ) ( le_pipeline_manager_o *self, graphics_pipeline_state_o* gpso, le_gpso_handle gpsoHandle);
 		bool                                     ( *introduce_compute_pipeline_state  ) ( le_pipeline_manager_o *self, compute_pipeline_state_o* cpso, le_cpso_handle cpsoHandle);
 		bool                                     ( *introduce_rtx_pipeline_state      ) ( le_pipeline_manager_o *self, rtx_pipeline_state_o* cpso, le_rtxpso_handle cpsoHandle);
+		bool                                     ( *has_graphics_pipeline_state       ) ( le_pipeline_manager_o *self, le_gpso_handle gpsoHandle);
 
 		le_pipeline_and_layout_info_t            ( *produce_graphics_pipeline         ) ( le_pipeline_manager_o *self, le_gpso_handle gpsoHandle, const LeRenderPass &pass, uint32_t subpass ) ;
 		le_pipeline_and_layout_info_t            ( *produce_rtx_pipeline              ) ( le_pipeline_manager_o *self, le_rtxpso_handle rtxpsoHandle, char ** shader_group_data);
@@ -262,6 +262,11 @@ le_device_o *device_create( le_backend_vk_instance_o *instance_, const char **ex
 #ifdef LE_FEATURE_RTX
 	    ,
 	    vk::PhysicalDeviceMeshShaderFeaturesNV // Optional, based on #define
+#endif
+#ifdef LE_FEATURE_PRESENT_WAIT
+	    ,
+	    vk::PhysicalDevicePresentIdFeaturesKHR, // Optional, based on #define
+	    vk::PhysicalDevicePresentWaitFeaturesKHR // Optional, based on #define
 #endif
 	    >
 	    featuresChain{};
@@ -304,6 +309,14 @@ le_device_o *device_create( le_backend_vk_instance_o *instance_, const char **ex
 	    ;
 #endif
 
+#ifdef LE_FEATURE_PRESENT_WAIT
+	// Used by khr and direct swapchains to measure when presented images reach the display.
+	featuresChain.get<vk::PhysicalDevicePresentIdFeaturesKHR>()
+	    .setPresentId( true );
+	featuresChain.get<vk::PhysicalDevicePresentWaitFeaturesKHR>()
+	    .setPresentWait( true );
+#endif
+
 //ms I had to disable this on my nvidia 1070 as it was failing 
 	featuresChain.get<vk::PhysicalDeviceVulkan12Features>()
 	    //    .setShaderInt8( true )
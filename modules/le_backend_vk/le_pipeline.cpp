@@ -11,11 +11,12 @@
 #include <filesystem> // for parsing shader source file paths
 #include <fstream>    // for reading shader source files
 #include <cstring>    // for memcpy
-#include <shared_mutex>
+#include <atomic>
 
 #include "le_shader_compiler/le_shader_compiler.h"
 #include "util/spirv-cross/spirv_cross.hpp"
 #include "le_file_watcher/le_file_watcher.h" // for watching shader source files
+#include "le_core/concurrent_hash_table.h"   // for pipeline caches
 #include "3rdparty/src/spooky/SpookyV2.h"    // for hashing renderpass gestalt, so that we can test for *compatible* renderpasses
 
 struct le_shader_module_o {
@@ -45,152 +46,69 @@ struct le_shader_manager_o {
 	le_file_watcher_o *   shaderFileWatcher = nullptr; // owning
 };
 
-// A table from `handle` -> `object*`, protected by mutex.
+// A table from `handle` -> `object*`, safe for many concurrent readers
+// and writers - see `ConcurrentHashTable` for synchronisation guarantees.
 //
-// Access is internally synchronised.
+// Handles are expected to already be hash values, which is why we use them
+// directly as hash, and why handles with equal bits are equal.
 //
-// lookup time will deteriorate linearly with number of elements,
-// but cache locality is very good for lookups, so this should work
-// fairly well for small number of resources such as pipelines.
+// `iterator()` and `clear()` must not be called concurrently with any other
+// method - they are meant for teardown.
 template <typename T, typename U>
 class HashTable : NoCopy, NoMove {
 
-	std::shared_mutex mtx;
-	std::vector<T>    handles;
-	std::vector<U *>  objects; // owning, object is copied on add_entry
+	struct Entry {
+		T handle;
+		U obj;
+	};
+
+	ConcurrentHashTable<Entry> table;
+
+	static uint64_t get_hash( T const &handle ) {
+		uint64_t key;
+		static_assert( sizeof( T ) == sizeof( uint64_t ), "handle must be 64 bit wide" );
+		memcpy( &key, &handle, sizeof( uint64_t ) );
+		return key;
+	}
 
   public:
 	// Insert a new obj into table, object is copied.
 	// return true if successful, false if entry aready existed.
 	// in case return value is false, object was not copied.
-	bool try_insert( T const &handle, U *obj ) {
-		mtx.lock();
-		size_t i = 0;
-		for ( auto const &h : handles ) {
-			if ( h == handle ) {
-				break;
-			}
-			i++;
-		}
-		if ( i != handles.size() ) {
-			// entry already existed - this is strange.
-			mtx.unlock();
-			return false;
-		}
-		// -------| invariant: i == handles.size()
-		handles.push_back( handle );
-		objects.emplace_back( new U( *obj ) ); // make a copy
-		mtx.unlock();
-		return true;
+	//
+	// If two threads race to insert the same handle, exactly one of them succeeds.
+	bool try_insert( T const &handle, U const *obj ) {
+		bool was_inserted = false;
+		table.find_or_insert(
+		    get_hash( handle ),
+		    []( Entry const & ) { return true; },
+		    [ & ]() { return Entry{ handle, *obj }; }, // make a copy
+		    &was_inserted );
+		return was_inserted;
 	}
 
 	// Looks up table entry under `needle`,
 	// returns nullptr if not found.
-	U *const try_find( T const &needle ) {
-		mtx.lock_shared();
-		U *const *obj = objects.data();
-		for ( auto const &h : handles ) {
-			if ( h == needle ) {
-				mtx.unlock();
-				return *obj;
-			}
-			obj++;
-		}
-		// --------| Invariant: no handle matching needle found
-		mtx.unlock();
-		return nullptr;
+	U *try_find( T const &needle ) {
+		Entry *e = table.find( get_hash( needle ), []( Entry const & ) { return true; } );
+		return e ? &e->obj : nullptr;
 	}
 
 	typedef void ( *iterator_fun )( U *e, void *user_data );
 
 	// do something on all objects
 	void iterator( iterator_fun fun, void *user_data ) {
-		mtx.lock();
-		for ( auto &e : objects ) {
-			fun( e, user_data );
-		}
-		mtx.unlock();
+		table.for_each( [ & ]( Entry &e ) { fun( &e.obj, user_data ); } );
 	}
 
 	void clear() {
-		mtx.lock();
-		for ( auto &obj : objects ) {
-			delete obj;
-		}
-		handles.clear();
-		objects.clear();
-		mtx.unlock();
-	}
-
-	~HashTable() {
-		clear();
+		table.clear();
 	}
 };
 
-//
+// A table from `hash` -> `object*` - see HashTable for synchronisation guarantees.
 template <typename T>
-class HashMap : NoCopy, NoMove {
-
-	std::shared_mutex                               mtx;
-	std::unordered_map<uint64_t, T *, IdentityHash> store; // owning
-
-  public:
-	T const *try_find( uint64_t needle ) {
-		mtx.lock_shared();
-		auto e = store.find( needle );
-		if ( e == store.end() ) {
-			mtx.unlock();
-			return nullptr;
-		} else {
-			auto ret = e->second;
-			mtx.unlock();
-			return ret;
-		}
-	}
-	bool try_insert( uint64_t handle, T const *obj ) {
-
-		mtx.lock();
-
-		// we attempt an insertion - a nullptr will go in as a placeholder
-		// because we cannot tell at this point whether the insertion will
-		// be successful.
-		auto result = store.emplace( handle, nullptr );
-
-		if ( result.second ) {
-			// Insertion was successful - replace the placeholder with a copy of the actual object.
-			result.first->second = new T( *obj );
-		}
-
-		mtx.unlock();
-
-		return result.second;
-	}
-
-	typedef void ( *iterator_fun )( T *e, void *user_data );
-
-	// do something on all objects
-	void iterator( iterator_fun fun, void *user_data ) {
-		mtx.lock();
-		for ( auto &e : store ) {
-			fun( e.second, user_data );
-		}
-		mtx.unlock();
-	}
-
-	void clear() {
-		mtx.lock();
-		for ( auto &e : store ) {
-			if ( e.second ) {
-				delete e.second;
-			}
-		}
-		store.clear();
-		mtx.unlock();
-	}
-	~HashMap() {
-		clear();
-	}
-};
+using HashMap = HashTable<uint64_t, T>;
 
 // NOTE: It might make sense to have one pipeline manager per worker thread, and
 //       to consolidate after the frame has been processed.
@@ -1627,7 +1545,15 @@ static uint64_t le_pipeline_cache_produce_descriptor_set_layout( le_pipeline_man
 
 		bool result = descriptorSetLayouts.try_insert( set_layout_hash, &le_layout_info );
 
-		assert( result && "descriptorSetLayout insertion must be successful" );
+		if ( false == result ) {
+			// Another thread inserted an equivalent layout while we were creating ours -
+			// we must dispose of our vulkan objects, and use the ones from the cache.
+			self->device.destroyDescriptorSetLayout( le_layout_info.vk_descriptor_set_layout );
+			if ( le_layout_info.vk_descriptor_update_template ) {
+				self->device.destroyDescriptorUpdateTemplate( le_layout_info.vk_descriptor_update_template );
+			}
+			*layout = descriptorSetLayouts.try_find( set_layout_hash )->vk_descriptor_set_layout;
+		}
 	}
 
 	return set_layout_hash;
@@ -1749,9 +1675,9 @@ static inline bool le_pipeline_manager_get_pipeline_layout_info(
 	} else {
 		// this will also create vulkan objects for pipeline layout / descriptor set layout and cache them
 		*pipeline_layout_info = le_pipeline_cache_produce_pipeline_layout_info( self, shader_modules, shader_modules_count );
-		// store in cache
-		bool result = self->pipelineLayoutInfos.try_insert( *pipeline_layout_hash, pipeline_layout_info );
-		assert( result && "pipeline layout info insertion must succeed" );
+		// store in cache - if another thread has stored this layout info in the meantime,
+		// insertion fails, which is fine, since layout info does not own any vulkan objects.
+		self->pipelineLayoutInfos.try_insert( *pipeline_layout_hash, pipeline_layout_info );
 	}
 
 	return result;
@@ -1819,7 +1745,12 @@ static le_pipeline_and_layout_info_t le_pipeline_manager_produce_graphics_pipeli
 
 		bool result = self->pipelines.try_insert( pipeline_hash, &pipeline_and_layout_info.pipeline );
 
-		assert( result && " pipeline insertion must be successful " );
+		if ( false == result ) {
+			// Another thread created the same pipeline while we were creating ours -
+			// dispose of ours, and use the one from the cache.
+			self->device.destroyPipeline( pipeline_and_layout_info.pipeline );
+			pipeline_and_layout_info.pipeline = *self->pipelines.try_find( pipeline_hash );
+		}
 	}
 
 	return pipeline_and_layout_info;
@@ -1888,7 +1819,12 @@ static le_pipeline_and_layout_info_t le_pipeline_manager_produce_rtx_pipeline( l
 		// Store pipeline in pipeline cache
 		bool result = self->pipelines.try_insert( pipeline_hash, &pipeline_and_layout_info.pipeline );
 
-		assert( result && "pipeline insertion must be successful" );
+		if ( false == result ) {
+			// Another thread created the same pipeline while we were creating ours -
+			// dispose of ours, and use the one from the cache.
+			self->device.destroyPipeline( pipeline_and_layout_info.pipeline );
+			pipeline_and_layout_info.pipeline = *self->pipelines.try_find( pipeline_hash );
+		}
 	}
 
 	if ( maybe_shader_group_data ) {
@@ -1929,7 +1865,11 @@ static le_pipeline_and_layout_info_t le_pipeline_manager_produce_rtx_pipeline( l
 			    0, uint32_t( pso->shaderGroups.size() ),
 			    dataSize, handles + sizeof( LeShaderGroupDataHeader ) );
 
-			self->rtx_shader_group_data.try_insert( pipeline_hash, &handles );
+			if ( false == self->rtx_shader_group_data.try_insert( pipeline_hash, &handles ) ) {
+				// Another thread stored shader group data for this pipeline in the meantime.
+				free( handles );
+				handles = *self->rtx_shader_group_data.try_find( pipeline_hash );
+			}
 
 			// we need to store this buffer with the pipeline - or at least associate is to the pso
 
@@ -2003,7 +1943,13 @@ static le_pipeline_and_layout_info_t le_pipeline_manager_produce_compute_pipelin
 		          << std::flush;
 
 		bool result = self->pipelines.try_insert( pipeline_hash, &pipeline_and_layout_info.pipeline );
-		assert( result && "insertion must be successful" );
+
+		if ( false == result ) {
+			// Another thread created the same pipeline while we were creating ours -
+			// dispose of ours, and use the one from the cache.
+			self->device.destroyPipeline( pipeline_and_layout_info.pipeline );
+			pipeline_and_layout_info.pipeline = *self->pipelines.try_find( pipeline_hash );
+		}
 	}
 
 	return pipeline_and_layout_info;
@@ -2017,6 +1963,13 @@ bool le_pipeline_manager_introduce_graphics_pipeline_state( le_pipeline_manager_
 	return self->graphicsPso.try_insert( handle, pso );
 };
 
+// ----------------------------------------------------------------------
+// Returns whether a graphics pipeline state object with the given handle
+// has already been introduced - never blocks, since lookups are lock-free.
+static bool le_pipeline_manager_has_graphics_pipeline_state( le_pipeline_manager_o *self, le_gpso_handle handle ) {
+	return nullptr != self->graphicsPso.try_find( handle );
+}
+
 // ----------------------------------------------------------------------
 // This method may get called through the pipeline builder -
 // via RECORD in command buffer recording state
@@ -2166,6 +2119,7 @@ void register_le_pipeline_vk_api( void *api_ ) {
 		i.introduce_graphics_pipeline_state = le_pipeline_manager_introduce_graphics_pipeline_state;
 		i.introduce_compute_pipeline_state  = le_pipeline_manager_introduce_compute_pipeline_state;
 		i.introduce_rtx_pipeline_state      = le_pipeline_manager_introduce_rtx_pipeline_state;
+		i.has_graphics_pipeline_state       = le_pipeline_manager_has_graphics_pipeline_state;
 		i.get_pipeline_layout               = le_pipeline_manager_get_pipeline_layout;
 		i.get_descriptor_set_layout         = le_pipeline_manager_get_descriptor_set_layout;
 		i.produce_graphics_pipeline         = le_pipeline_manager_produce_graphics_pipeline;
@@ -0,0 +1,137 @@
+#ifndef GUARD_LE_CONCURRENT_HASH_TABLE_H
+#define GUARD_LE_CONCURRENT_HASH_TABLE_H
+
+#include "le_core.h"
+#include <atomic>
+#include <utility>
+
+// A concurrent, append-only hash table, safe for many concurrent readers
+// and writers.
+//
+// Each bucket holds a singly linked list of entries, and a new entry is
+// published by atomically swapping it in as the head of its bucket's list.
+// Entries are never removed (other than via `clear()`), and are immutable
+// once published. This means that:
+//
+// * lookups never take a lock, and never block inserts - a lookup walks at
+//   most the entries which were in its bucket at the time of the lookup,
+// * a pointer to a value stays valid for the lifetime of the table,
+// * if an insert loses a race against another thread, it only needs to check
+//   the entries which were prepended since it last looked at the bucket.
+//
+// Values are looked up by a 64 bit hash, whose lower bits are used directly
+// as bucket index, and a predicate, which is only called for values with a
+// matching hash. If hash equality implies value equality, pass a predicate
+// which always returns true.
+//
+// `for_each()`, and `clear()` must not be called concurrently with any
+// other method - they are meant for teardown.
+template <typename T, size_t NUM_BUCKETS = 1024>
+class ConcurrentHashTable : NoCopy, NoMove {
+
+	static_assert( ( NUM_BUCKETS & ( NUM_BUCKETS - 1 ) ) == 0, "number of buckets must be a power of two" );
+
+	struct Entry {
+		uint64_t hash;
+		Entry *  next; // next entry in same bucket, immutable once entry has been published
+		T        value;
+	};
+
+	std::atomic<Entry *> buckets[ NUM_BUCKETS ]{};
+
+	// Walks list starting at `e` until reaching `end`, returns
+	// first entry with `hash` for which `matches` is true, or nullptr.
+	template <typename Matches>
+	static Entry *find_in_list( Entry *e, Entry const *end, uint64_t hash, Matches &matches ) {
+		for ( ; e != end; e = e->next ) {
+			if ( e->hash == hash && matches( e->value ) ) {
+				return e;
+			}
+		}
+		return nullptr;
+	}
+
+  public:
+	// Returns value with `hash` for which `matches( value )` is true, or nullptr.
+	template <typename Matches>
+	T *find( uint64_t hash, Matches &&matches ) const {
+		Entry *e = find_in_list( buckets[ hash & ( NUM_BUCKETS - 1 ) ].load( std::memory_order_acquire ), nullptr, hash, matches );
+		return e ? &e->value : nullptr;
+	}
+
+	// Returns value with `hash` for which `matches( value )` is true. If there is
+	// no such value, inserts the value returned by `make()`, and returns that.
+	//
+	// If two threads race to insert matching values, exactly one of them succeeds,
+	// and both get the value which was inserted. `make()` may be called even if
+	// nothing gets inserted. `was_inserted` is optional.
+	template <typename Matches, typename Make>
+	T *find_or_insert( uint64_t hash, Matches &&matches, Make &&make, bool *was_inserted = nullptr ) {
+
+		auto &bucket = buckets[ hash & ( NUM_BUCKETS - 1 ) ];
+
+		Entry *head     = bucket.load( std::memory_order_acquire );
+		Entry *searched = nullptr; // entries from here onwards have already been searched
+		Entry *entry    = nullptr;
+
+		for ( ;; ) {
+
+			if ( Entry *found = find_in_list( head, searched, hash, matches ) ) {
+				// Another thread may have published a matching entry while we were
+				// preparing ours - in which case we must discard ours.
+				delete entry;
+				if ( was_inserted ) {
+					*was_inserted = false;
+				}
+				return &found->value;
+			}
+
+			// --------| invariant: no matching entry in bucket
+
+			if ( nullptr == entry ) {
+				entry = new Entry{ hash, nullptr, make() };
+			}
+
+			searched    = head;
+			entry->next = head;
+
+			if ( bucket.compare_exchange_weak( head, entry, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+				if ( was_inserted ) {
+					*was_inserted = true;
+				}
+				return &entry->value;
+			}
+
+			// Another thread changed the bucket - head now points to its most recent entry,
+			// and we must search all entries up until the one which we have already searched.
+		}
+	}
+
+	// Calls `fun( value )` for all values.
+	template <typename Fun>
+	void for_each( Fun &&fun ) {
+		for ( auto &bucket : buckets ) {
+			for ( Entry *e = bucket.load( std::memory_order_acquire ); e != nullptr; e = e->next ) {
+				fun( e->value );
+			}
+		}
+	}
+
+	// Removes, and destroys all values.
+	void clear() {
+		for ( auto &bucket : buckets ) {
+			Entry *e = bucket.exchange( nullptr, std::memory_order_acq_rel );
+			while ( e ) {
+				Entry *next = e->next;
+				delete e;
+				e = next;
+			}
+		}
+	}
+
+	~ConcurrentHashTable() {
+		clear();
+	}
+};
+
+#endif
@@ -55,27 +55,33 @@ inline uint32_t hash_32_fnv1a( char const *const input ) noexcept {
 
 } //hash_32_fnv1a
 
-#ifndef NDEBUG
+// ----------------------------------------------------------------------
+// Mixes the 8 bytes of `v` into the 64 bit fnv1a hash `value`, lowest byte
+// first - may be evaluated at compile time.
+inline constexpr uint64_t hash_64_fnv1a_mix_const( uint64_t value, uint64_t v ) noexcept {
+	for ( int i = 0; i != 8; ++i ) {
+		value = ( value ^ ( v & 0xff ) ) * FNV1A_PRIME_64_CONST;
+		v >>= 8;
+	}
+	return value;
+}
 
 // Shader argument names are internally stored / looked up as their hashes.
 // We define alias method for shader argument name so that we may decide to
 // point it to a different hashing algorithm at a later time.
-#	define LE_ARGUMENT_NAME( x ) []() -> uint64_t {									\
-	static uint64_t hash_value = 0;													\
-	if (hash_value != 0) return hash_value;											\
-	hash_value = hash_64_fnv1a( x );												\
-	le_update_argument_name_table(x, hash_value);								    \
+//
+// The name gets registered with the argument name table exactly once, on first
+// use, in debug and release builds alike - registering is what detects hash
+// collisions. Initialisation of a function-local static is thread-safe, so this
+// may be first used from more than one thread at a time. Any later use costs
+// only the check whether the static has been initialised.
+#define LE_ARGUMENT_NAME( x ) []() -> uint64_t {									\
+	static uint64_t const hash_value = []() -> uint64_t {							\
+		constexpr uint64_t h = hash_64_fnv1a_const( x );							\
+		le_update_argument_name_table( x, h );										\
+		return h; }();																\
 	return hash_value; }()
 
-#else
-
-// Shader argument names are internally stored / looked up as their hashes.
-// We define alias method for shader argument name so that we may decide to
-// point it to a different hashing algorithm at a later time.
-#	define LE_ARGUMENT_NAME( x ) hash_64_fnv1a_const( x )
-
-#endif
-
 // ----------------------------------------------------------------------
 // Returns itself value of key as hash value; useful if you
 // want to enforce key and hash value to be identical.
@@ -10,6 +10,7 @@
 #include "assert.h"
 #include <string>
 #include <iostream>
+#include <chrono>
 
 struct le_file_watcher_o;
 
@@ -24,10 +25,19 @@ struct le_module_loader_o {
 	std::string        mPath;
 	void *             mLibraryHandle = nullptr;
 	le_file_watcher_o *mFileWatcher   = nullptr;
+	uint64_t           mLoadNs        = 0; // duration of most recent library load
+	uint64_t           mResolveNs     = 0; // duration of most recent register function symbol lookup
+	uint64_t           mRegisterNs    = 0; // duration of most recent call to register function
 };
 
 // ----------------------------------------------------------------------
 
+static uint64_t nanoseconds_since( std::chrono::steady_clock::time_point t ) {
+	return uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - t ).count() );
+}
+
+// ----------------------------------------------------------------------
+
 static void unload_library( void *handle_, const char *path ) {
 	if ( handle_ ) {
 #ifdef _MSC_VER
@@ -152,7 +162,9 @@ static void instance_destroy( le_module_loader_o *obj ) {
 
 static bool load( le_module_loader_o *obj ) {
 	unload_library( obj->mLibraryHandle, obj->mPath.c_str() );
+	auto t_start        = std::chrono::steady_clock::now();
 	obj->mLibraryHandle = load_library( obj->mPath.c_str() );
+	obj->mLoadNs        = nanoseconds_since( t_start );
 	return ( obj->mLibraryHandle != nullptr );
 }
 
@@ -166,17 +178,23 @@ static bool register_api( le_module_loader_o *obj, void *api_interface, const ch
 #ifdef _MSC_VER
 	FARPROC fp;
 
-	fp = GetProcAddress( ( HINSTANCE )obj->mLibraryHandle, register_api_fun_name );
+	auto t_start = std::chrono::steady_clock::now();
+	fp           = GetProcAddress( ( HINSTANCE )obj->mLibraryHandle, register_api_fun_name );
 	if ( !fp ) {
 		std::cerr << LOG_PREFIX_STR "ERROR: " << GetLastError() << std::endl;
 		assert( false );
 		return false;
 	}
-	fptr = ( register_api_fun_p_t )fp;
+	fptr            = ( register_api_fun_p_t )fp;
+	obj->mResolveNs = nanoseconds_since( t_start );
+
+	t_start = std::chrono::steady_clock::now();
 	( *fptr )( api_interface );
+	obj->mRegisterNs = nanoseconds_since( t_start );
 	return true;
 #else
-	fptr = reinterpret_cast<register_api_fun_p_t>( dlsym( obj->mLibraryHandle, register_api_fun_name ) );
+	auto t_start = std::chrono::steady_clock::now();
+	fptr         = reinterpret_cast<register_api_fun_p_t>( dlsym( obj->mLibraryHandle, register_api_fun_name ) );
 	if ( !fptr ) {
 		std::cerr << LOG_PREFIX_STR "ERROR: " << dlerror() << std::endl;
 		assert( false );
@@ -184,15 +202,27 @@ static bool register_api( le_module_loader_o *obj, void *api_interface, const ch
 	}
 	// Initialize the API. This means telling the API to populate function
 	// pointers inside the struct which we are passing as parameter.
+	obj->mResolveNs = nanoseconds_since( t_start );
+
 	fprintf( stderr, "[ %-20.20s ] %10s %-20s: %s\n", LOG_PREFIX_STR, "", "Register Module", register_api_fun_name );
 
+	t_start = std::chrono::steady_clock::now();
 	( *fptr )( api_interface );
+	obj->mRegisterNs = nanoseconds_since( t_start );
 	return true;
 #endif
 }
 
 // ----------------------------------------------------------------------
 
+static void get_last_timings( le_module_loader_o const *obj, uint64_t *load_ns, uint64_t *resolve_ns, uint64_t *register_ns ) {
+	*load_ns     = obj->mLoadNs;
+	*resolve_ns  = obj->mResolveNs;
+	*register_ns = obj->mRegisterNs;
+}
+
+// ----------------------------------------------------------------------
+
 LE_MODULE_REGISTER_IMPL( le_module_loader, p_api ) {
 	auto  api                          = static_cast<le_module_loader_api *>( p_api );
 	auto &loader_i                     = api->le_module_loader_i;
@@ -201,6 +231,7 @@ LE_MODULE_REGISTER_IMPL( le_module_loader, p_api ) {
 	loader_i.load                      = load;
 	loader_i.register_api              = register_api;
 	loader_i.load_library_persistently = load_library_persistent;
+	loader_i.get_last_timings          = get_last_timings;
 }
 
 // ----------------------------------------------------------------------
@@ -34,6 +34,10 @@ struct le_module_loader_api {
 	bool               ( *register_api )         ( le_module_loader_o *obj, void *api_interface, const char *api_registry_name );
 	bool               ( *load )                 ( le_module_loader_o *obj );
 	bool               ( *load_library_persistently) (const char* libName_);
+
+	// Returns durations in nanoseconds for the most recent call to `load` (library
+	// load), and `register_api` (symbol resolution, and call to register function).
+	void               ( *get_last_timings )     ( le_module_loader_o const *obj, uint64_t *load_ns, uint64_t *resolve_ns, uint64_t *register_ns );
 	};
 	
 	le_module_loader_interface_t le_module_loader_i;
@@ -2,6 +2,7 @@
 #include "le_core/le_api_loader.h"
 #include "le_file_watcher/le_file_watcher.h"
 #include "hash_util.h"
+#include "concurrent_hash_table.h"
 #include <vector>
 #include <string>
 #include <stdio.h>
@@ -12,6 +13,7 @@
 #include <atomic>
 #include <algorithm>
 #include <string.h> // for memcpy
+#include <chrono>
 
 #ifndef _WIN32
 #	include <sys/mman.h>
@@ -22,6 +24,7 @@ struct ApiStore {
 	std::vector<std::string> names{};      // Api names (used for debugging)
 	std::vector<uint64_t>    nameHashes{}; // Hashed api names (used for lookup)
 	std::vector<void *>      ptrs{};       // Pointer to struct holding api for each api name
+	std::vector<uint32_t>    index{};      // Open-addressing hash index: slot -> (entry index + 1), 0 marks an empty slot. Size is power of two.
 	~ApiStore() {
 		// We must free any api table entry for which memory was been allocated.
 		for ( auto p : ptrs ) {
@@ -72,6 +75,22 @@ struct DeferDelete {
 
 static DeferDelete defer_delete; // Any elements referenced in this pool will get deleted when program unloads.
 
+// ----------------------------------------------------------------------
+// Adds entry with given index to apiStore hash index - index must have at least one empty slot.
+static void api_store_index_insert( size_t entry_index ) {
+
+	size_t const mask = apiStore.index.size() - 1;
+
+	// Api ids are already hash values, which is why we may use their lower bits as slot index.
+	size_t slot = apiStore.nameHashes[ entry_index ] & mask;
+
+	while ( apiStore.index[ slot ] != 0 ) {
+		slot = ( slot + 1 ) & mask; // linear probing
+	}
+
+	apiStore.index[ slot ] = uint32_t( entry_index + 1 );
+}
+
 // ----------------------------------------------------------------------
 /// \returns index into apiStore entry for api with given id
 /// \param id        Hashed api name string
@@ -79,27 +98,194 @@ static DeferDelete defer_delete; // Any elements referenced in this pool will ge
 /// \note  In case a given id is not found in apiStore, a new entry is appended to apiStore
 static size_t produce_api_index( uint64_t id, const char *debugName ) {
 
-	size_t foundElement = 0;
+	if ( apiStore.index.empty() ) {
+		apiStore.index.resize( 64, 0 );
+	}
+
+	size_t const mask = apiStore.index.size() - 1;
 
-	for ( const auto &n : apiStore.nameHashes ) {
-		if ( n == id ) {
-			break;
+	for ( size_t slot = id & mask; apiStore.index[ slot ] != 0; slot = ( slot + 1 ) & mask ) {
+		size_t const entry_index = apiStore.index[ slot ] - 1;
+		if ( apiStore.nameHashes[ entry_index ] == id ) {
+			return entry_index;
 		}
-		++foundElement;
 	}
 
-	if ( foundElement == apiStore.nameHashes.size() ) {
-		// no element found, we need to add an element
-		apiStore.nameHashes.emplace_back( id );
-		apiStore.ptrs.emplace_back( nullptr );    // initialise to nullptr
-		apiStore.names.emplace_back( debugName ); // implicitly creates a string
-	}
+	// --------| invariant: no element found, we need to add an element
 
-	// --------| invariant: foundElement points to correct element
+	size_t const foundElement = apiStore.nameHashes.size();
+
+	apiStore.nameHashes.emplace_back( id );
+	apiStore.ptrs.emplace_back( nullptr );    // initialise to nullptr
+	apiStore.names.emplace_back( debugName ); // implicitly creates a string
+
+	if ( apiStore.nameHashes.size() * 2 > apiStore.index.size() ) {
+		// Keep load factor at or below 0.5, so that probe sequences stay short:
+		// double size of index, and re-insert all entries.
+		apiStore.index.assign( apiStore.index.size() * 2, 0 );
+		for ( size_t i = 0; i != apiStore.nameHashes.size(); i++ ) {
+			api_store_index_insert( i );
+		}
+	} else {
+		api_store_index_insert( foundElement );
+	}
 
 	return foundElement;
 }
 
+// ----------------------------------------------------------------------
+// Startup profile: we record a timing entry for the first load of each
+// module. Module loads may be nested (a module may load other modules while
+// it gets loaded), which is why we keep a stack of loads in progress.
+struct StartupProfile {
+	using clock = std::chrono::steady_clock;
+
+	std::vector<le_core_startup_profile_entry_t> entries;
+	std::vector<std::string>                     names;       // one per entry, entry.name gets patched up on query
+	std::vector<uint64_t>                        children_ns; // one per entry, sum of total_ns of nested loads
+	std::vector<size_t>                          open_loads;  // stack of indices of entries for loads in progress
+	clock::time_point                            t_first = {};
+};
+
+// Function-local static, since modules may be loaded from static initialisers.
+static StartupProfile &get_startup_profile() {
+	static StartupProfile profile{};
+	return profile;
+}
+
+// ----------------------------------------------------------------------
+
+static uint64_t startup_profile_ns_since_first( StartupProfile const &profile ) {
+	return uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( StartupProfile::clock::now() - profile.t_first ).count() );
+}
+
+// ----------------------------------------------------------------------
+// Returns index of new profile entry, which must be passed to `startup_profile_end`.
+static size_t startup_profile_begin( char const *name, le_core_startup_profile_entry_kind kind ) {
+
+	auto &profile = get_startup_profile();
+
+	if ( profile.entries.empty() ) {
+		profile.t_first = StartupProfile::clock::now();
+	}
+
+	le_core_startup_profile_entry_t entry{};
+	entry.kind     = kind;
+	entry.depth    = uint32_t( profile.open_loads.size() );
+	entry.start_ns = startup_profile_ns_since_first( profile );
+
+	size_t const entry_index = profile.entries.size();
+
+	profile.entries.push_back( entry );
+	profile.names.emplace_back( name );
+	profile.children_ns.push_back( 0 );
+	profile.open_loads.push_back( entry_index );
+
+	return entry_index;
+}
+
+// ----------------------------------------------------------------------
+
+static void startup_profile_end( size_t entry_index, uint64_t load_ns, uint64_t resolve_ns, uint64_t register_ns ) {
+
+	auto &profile = get_startup_profile();
+
+	assert( !profile.open_loads.empty() && profile.open_loads.back() == entry_index && "startup profile entries must be ended in reverse order of beginning" );
+	profile.open_loads.pop_back();
+
+	auto &entry       = profile.entries[ entry_index ];
+	entry.load_ns     = load_ns;
+	entry.resolve_ns  = resolve_ns;
+	entry.register_ns = register_ns;
+	entry.total_ns    = startup_profile_ns_since_first( profile ) - entry.start_ns;
+	entry.self_ns     = entry.total_ns - std::min( entry.total_ns, profile.children_ns[ entry_index ] );
+
+	if ( !profile.open_loads.empty() ) {
+		profile.children_ns[ profile.open_loads.back() ] += entry.total_ns;
+	}
+}
+
+// ----------------------------------------------------------------------
+
+static bool startup_profile_has_entry( char const *name, le_core_startup_profile_entry_kind kind ) {
+
+	auto const &profile = get_startup_profile();
+
+	for ( size_t i = 0; i != profile.entries.size(); i++ ) {
+		if ( profile.entries[ i ].kind == kind && profile.names[ i ] == name ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// ----------------------------------------------------------------------
+
+ISL_API_ATTR void le_core_get_startup_profile( le_core_startup_profile_entry_t const **entries, size_t *num_entries ) {
+
+	auto &profile = get_startup_profile();
+
+	for ( size_t i = 0; i != profile.entries.size(); i++ ) {
+		profile.entries[ i ].name = profile.names[ i ].c_str();
+	}
+
+	*entries     = profile.entries.data();
+	*num_entries = profile.entries.size();
+}
+
+// ----------------------------------------------------------------------
+
+ISL_API_ATTR void le_core_print_startup_profile() {
+
+	le_core_startup_profile_entry_t const *entries;
+	size_t                                 num_entries;
+
+	le_core_get_startup_profile( &entries, &num_entries );
+
+	static char const *kind_names[] = { "static", "dynamic", "library" };
+
+	uint64_t total_ns = 0;
+	for ( size_t i = 0; i != num_entries; i++ ) {
+		if ( entries[ i ].depth == 0 ) {
+			total_ns += entries[ i ].total_ns;
+		}
+	}
+
+	auto to_ms = []( uint64_t ns ) -> double { return double( ns ) / 1'000'000.0; };
+
+	fprintf( stdout, "[ %-20.20s ] Startup profile: %zu entries, %.3f ms total\n", "CORE", num_entries, to_ms( total_ns ) );
+	fprintf( stdout, "%10s %10s %10s %10s %10s %10s  %-8s %s\n", "start ms", "total ms", "self ms", "load ms", "resolve ms", "reg ms", "kind", "name" );
+
+	for ( size_t i = 0; i != num_entries; i++ ) {
+		auto const &e = entries[ i ];
+		fprintf( stdout, "%10.3f %10.3f %10.3f %10.3f %10.3f %10.3f  %-8s %*s%s\n",
+		         to_ms( e.start_ns ), to_ms( e.total_ns ), to_ms( e.self_ns ),
+		         to_ms( e.load_ns ), to_ms( e.resolve_ns ), to_ms( e.register_ns ),
+		         kind_names[ e.kind ], int( e.depth * 2 ), "", e.name );
+	}
+
+	// List the most expensive entries by self time, so that it's obvious where to look first.
+
+	std::vector<size_t> by_self_time( num_entries );
+	for ( size_t i = 0; i != num_entries; i++ ) {
+		by_self_time[ i ] = i;
+	}
+	std::sort( by_self_time.begin(), by_self_time.end(), [ entries ]( size_t lhs, size_t rhs ) {
+		return entries[ lhs ].self_ns > entries[ rhs ].self_ns;
+	} );
+
+	size_t const num_top_entries = std::min<size_t>( 5, num_entries );
+
+	fprintf( stdout, "[ %-20.20s ] Most expensive by self time:\n", "CORE" );
+	for ( size_t i = 0; i != num_top_entries; i++ ) {
+		auto const &e = entries[ by_self_time[ i ] ];
+		fprintf( stdout, "%10.3f ms  %5.1f%%  %s\n", to_ms( e.self_ns ), total_ns ? 100.0 * double( e.self_ns ) / double( total_ns ) : 0.0, e.name );
+	}
+
+	fflush( stdout );
+}
+
 // ----------------------------------------------------------------------
 
 static void *le_core_get_api( uint64_t id, const char *debugName ) {
@@ -134,7 +320,22 @@ static void *le_core_create_api( uint64_t id, size_t apiStructSize, const char *
 
 ISL_API_ATTR void *le_core_load_module_static( char const *module_name, void ( *module_reg_fun )( void * ), uint64_t api_size_in_bytes ) {
 	void *api = le_core_create_api( hash_64_fnv1a_const( module_name ), api_size_in_bytes, module_name );
+
+	if ( startup_profile_has_entry( module_name, LE_CORE_STARTUP_PROFILE_STATIC_MODULE ) ) {
+		// Module was registered before - every translation unit which uses a module
+		// loads it statically, but we only want to record the first registration.
+		module_reg_fun( api );
+		return api;
+	}
+
+	size_t profile_entry = startup_profile_begin( module_name, LE_CORE_STARTUP_PROFILE_STATIC_MODULE );
+	auto   t_start       = std::chrono::steady_clock::now();
+
 	module_reg_fun( api );
+
+	uint64_t register_ns = uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - t_start ).count() );
+	startup_profile_end( profile_entry, 0, 0, register_ns );
+
 	return api;
 };
 
@@ -181,9 +382,17 @@ ISL_API_ATTR void *le_core_load_module_dynamic( char const *module_name, uint64_
 		//
 		api = le_core_create_api( hash_64_fnv1a_const( module_name ), api_size_in_bytes, module_name );
 
+		size_t profile_entry = startup_profile_begin( module_name, LE_CORE_STARTUP_PROFILE_DYNAMIC_MODULE );
+
 		module_loader_i.load( loader );
 		module_loader_i.register_api( loader, api, api_register_fun_name );
 
+		{
+			uint64_t load_ns, resolve_ns, register_ns;
+			module_loader_i.get_last_timings( loader, &load_ns, &resolve_ns, &register_ns );
+			startup_profile_end( profile_entry, load_ns, resolve_ns, register_ns );
+		}
+
 		// ----
 		if ( should_watch ) {
 			loader_callback_params_o *callbackParams = new loader_callback_params_o{};
@@ -217,72 +426,65 @@ ISL_API_ATTR void *le_core_load_module_dynamic( char const *module_name, uint64_
 // ----------------------------------------------------------------------
 
 ISL_API_ATTR bool le_core_load_library_persistently( char const *library_name ) {
-	return le_module_loader_api_i->le_module_loader_i.load_library_persistently( library_name );
+
+	if ( startup_profile_has_entry( library_name, LE_CORE_STARTUP_PROFILE_LIBRARY ) ) {
+		// Library was loaded before - modules which depend on a library will request it again
+		// whenever they get registered, but we only want to record the first load.
+		return le_module_loader_api_i->le_module_loader_i.load_library_persistently( library_name );
+	}
+
+	size_t profile_entry = startup_profile_begin( library_name, LE_CORE_STARTUP_PROFILE_LIBRARY );
+	auto   t_start       = std::chrono::steady_clock::now();
+
+	bool result = le_module_loader_api_i->le_module_loader_i.load_library_persistently( library_name );
+
+	uint64_t load_ns = uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - t_start ).count() );
+	startup_profile_end( profile_entry, load_ns, 0, 0 );
+
+	return result;
 }
 
 // ----------------------------------------------------------------------
 
 /* Provide storage for a lookup table for uniform arguments - any argument  
- * set via the LE_ARGUMENT_NAME macro will be placed in this table should
- * we run in Debug mode. 
- * 
- * In Release mode the macro evaluates to a constexpr, and argument ids are 
- * resolved at compile-time, therefore will not be
- * placed in table.
+ * set via the LE_ARGUMENT_NAME macro will be placed in this table the first
+ * time it is used.
  * 
+ * Arguments may get registered from any thread (e.g. from threads which
+ * record renderpasses), which is why the table is a concurrent, append-only
+ * hash table - see `ConcurrentHashTable`. Entries are never removed while
+ * the program runs, which means that names returned by lookups remain valid.
  */
-struct ArgumentNameTable {
-	// std::mutex mtx; // TODO: consider: do we want to add a mutex so that any modifications to this table are protected when multithreading?
-	std::vector<std::string> names;
-	std::vector<uint64_t>    hashes;
-};
-
-static ArgumentNameTable argument_names_table{};
+static ConcurrentHashTable<std::string> argument_names_table{}; // hash -> argument name
 
 // ----------------------------------------------------------------------
 
 ISL_API_ATTR void le_update_argument_name_table( const char *name, uint64_t value ) {
 
-	// find index of entry with current value in table
-
-	uint64_t const *hashes_begin = argument_names_table.hashes.data();
-	auto            hashes_end   = hashes_begin + argument_names_table.hashes.size();
-
-	size_t name_index = 0;
-	for ( auto h = hashes_begin; h != hashes_end; h++, name_index++ ) {
-		if ( *h == value ) {
-			break;
-		}
+	// Any entry with the same hash is a match - if its name differs, we have
+	// found a hash collision.
+	auto const entry = argument_names_table.find_or_insert(
+	    value,
+	    []( std::string const & ) { return true; },
+	    [ & ]() { return std::string( name ); } );
+
+	// We don't rely on assert for this test, so that collisions get reported in release builds, too.
+	if ( *entry != name ) {
+		std::cerr << "ERROR: Argument name hash collision: '" << name << "' and '" << *entry
+		          << "' both hash to 0x" << std::hex << value << std::dec << std::endl
+		          << std::flush;
+		assert( false && "Possible hash collision, names for hashes don't match!" );
 	}
-
-	if ( name_index == argument_names_table.names.size() ) {
-		// not found, we must add a new entry
-		argument_names_table.names.push_back( name );
-		argument_names_table.hashes.push_back( value );
-		// std::cout << "Argument: '" << std::setw( 30 ) << source << "' : 0x" << std::hex << value << std::endl
-		//           << std::flush;
-	} else {
-		// entry already exists - test whether the names match
-		assert( argument_names_table.names.at( name_index ) == std::string( name ) && "Possible hash collision, names for hashes don't match!" );
-	}
-};
+}
 
 // ----------------------------------------------------------------------
 
 ISL_API_ATTR char const *le_get_argument_name_from_hash( uint64_t value ) {
 
-	if ( argument_names_table.hashes.empty() ) {
-		return "<< Argument name table empty. >>";
-	}
-
-	uint64_t const *hashes_begin = argument_names_table.hashes.data();
-	auto            hashes_end   = hashes_begin + argument_names_table.hashes.size();
+	auto const entry = argument_names_table.find( value, []( std::string const & ) { return true; } );
 
-	size_t name_index = 0;
-	for ( auto h = hashes_begin; h != hashes_end; h++, name_index++ ) {
-		if ( *h == value ) {
-			return argument_names_table.names.at( name_index ).c_str();
-		}
+	if ( entry ) {
+		return entry->c_str();
 	}
 
 	return "<< Argument name could not be resolved. >>";
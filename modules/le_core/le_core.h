@@ -42,6 +42,40 @@ ISL_API_ATTR DLL_CORE_API void *le_core_load_module_static( char const *module_n
 ISL_API_ATTR DLL_CORE_API void *le_core_load_module_dynamic( char const *module_name, uint64_t api_size_in_bytes, bool should_watch );
 ISL_API_ATTR DLL_CORE_API bool  le_core_load_library_persistently( char const *library );
 
+// Startup profile - records how long it took to load each module.
+//
+// For dynamic modules, time is split into loading the module's library
+// (which includes running its static initialisers), resolving its register
+// function, and calling its register function. Static modules only record
+// registration. Loading a module may trigger loading other modules - times
+// are inclusive, and `self_ns` gives the time which is not attributed to
+// any nested load.
+//
+// Only the first load of each module is recorded, hot-reloads are not.
+
+enum le_core_startup_profile_entry_kind {
+	LE_CORE_STARTUP_PROFILE_STATIC_MODULE = 0,
+	LE_CORE_STARTUP_PROFILE_DYNAMIC_MODULE,
+	LE_CORE_STARTUP_PROFILE_LIBRARY, // library loaded via le_core_load_library_persistently
+};
+
+struct le_core_startup_profile_entry_t {
+	char const *name;        // module or library name
+	uint32_t    kind;        // enum le_core_startup_profile_entry_kind
+	uint32_t    depth;       // nesting depth, 0 for loads not triggered by another load
+	uint64_t    start_ns;    // time since first recorded load
+	uint64_t    load_ns;     // time spent loading library
+	uint64_t    resolve_ns;  // time spent resolving register function symbol
+	uint64_t    register_ns; // time spent calling register function
+	uint64_t    total_ns;    // total time, including nested loads
+	uint64_t    self_ns;     // total time, minus time spent in nested loads
+};
+
+// Returns entries in the order in which loads started - entries are owned by core and
+// remain valid until the next module gets loaded.
+ISL_API_ATTR DLL_CORE_API void le_core_get_startup_profile( struct le_core_startup_profile_entry_t const **entries, size_t *num_entries );
+ISL_API_ATTR DLL_CORE_API void le_core_print_startup_profile();
+
 // For debug purposes
 
 ISL_API_ATTR DLL_CORE_API void le_update_argument_name_table( const char *source, uint64_t value );
@@ -0,0 +1,177 @@
+#ifndef GUARD_LE_LRU_CACHE_H
+#define GUARD_LE_LRU_CACHE_H
+
+#include "le_core.h"
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// A bounded, thread-safe, least-recently-used cache of immutable values.
+//
+// Values are looked up by a 64 bit hash, and a key, which is the full
+// sequence of bytes which the hash was calculated from. The key is compared
+// on every hit, so that a hash collision can never return another key's value.
+//
+// Values are reference-counted: a value which was found stays valid for as
+// long as the caller holds on to it, even if it gets evicted in the meantime.
+// The cache lock is only held for bookkeeping - callers read, or copy values
+// without holding it.
+//
+// Once adding an entry would grow the cache beyond its capacity, least
+// recently used entries get evicted. A capacity of 0 disables the cache.
+template <typename Value>
+class LruCache : NoCopy, NoMove {
+  public:
+	using ValuePtr = std::shared_ptr<Value const>;
+
+	struct Stats {
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+		uint64_t num_entries;
+		uint64_t size_in_bytes;
+		uint64_t capacity_in_bytes;
+	};
+
+  private:
+	struct Entry {
+		uint64_t             hash;
+		std::vector<uint8_t> key;
+		ValuePtr             value;
+		size_t               size_in_bytes; // includes key, and bookkeeping
+	};
+
+	std::mutex                                                        mtx;     // protects everything but `capacity_in_bytes`
+	std::list<Entry>                                                  entries; // most recently used first
+	std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index;   // hash -> entry
+
+	std::atomic<size_t> capacity_in_bytes; // 0 means cache is disabled
+	size_t              size_in_bytes = 0;
+
+	uint64_t hits      = 0;
+	uint64_t misses    = 0;
+	uint64_t evictions = 0;
+
+	// Evicts least recently used entries until cache size is at most `capacity`.
+	// Cache must be locked. Evicted entries are moved to `evicted`, so that
+	// callers may free them once they have released the lock.
+	void evict_to( size_t capacity, std::list<Entry> &evicted ) {
+		while ( size_in_bytes > capacity && !entries.empty() ) {
+			auto const &entry = entries.back();
+			size_in_bytes -= entry.size_in_bytes;
+			index.erase( entry.hash );
+			evicted.splice( evicted.end(), entries, std::prev( entries.end() ) );
+			evictions++;
+		}
+	}
+
+	static bool key_equals( Entry const &entry, void const *key, size_t key_size ) {
+		return entry.key.size() == key_size && 0 == memcmp( entry.key.data(), key, key_size );
+	}
+
+  public:
+	explicit LruCache( size_t capacity_in_bytes_ )
+	    : capacity_in_bytes( capacity_in_bytes_ ) {
+	}
+
+	bool is_enabled() const {
+		return capacity_in_bytes.load( std::memory_order_relaxed ) != 0;
+	}
+
+	// Returns value stored under `hash`, and `key`, or nullptr. Counts as one hit, or one miss.
+	ValuePtr find( uint64_t hash, void const *key, size_t key_size ) {
+
+		std::scoped_lock lock( mtx );
+
+		auto it = index.find( hash );
+
+		if ( it == index.end() || !key_equals( *it->second, key, key_size ) ) {
+			misses++;
+			return nullptr;
+		}
+
+		hits++;
+
+		// Mark entry as most recently used
+		entries.splice( entries.begin(), entries, it->second );
+
+		return it->second->value;
+	}
+
+	// Stores `value` under `hash`, and `key`. `value_size_in_bytes` is what the
+	// value counts towards the capacity of the cache.
+	//
+	// If another thread stored a value under the same key in the meantime, we
+	// keep that value. An entry with the same hash, but a different key gets
+	// replaced - hash collisions are rare enough that we only keep the most
+	// recent of the colliding entries.
+	void store( uint64_t hash, void const *key, size_t key_size, ValuePtr value, size_t value_size_in_bytes ) {
+
+		std::list<Entry> evicted; // declared before lock, so that evicted entries get freed after unlocking
+
+		evicted.emplace_back();
+
+		Entry &entry = evicted.back();
+		entry.hash   = hash;
+		entry.key.assign( static_cast<uint8_t const *>( key ), static_cast<uint8_t const *>( key ) + key_size );
+		entry.value         = std::move( value );
+		entry.size_in_bytes = sizeof( Entry ) + key_size + value_size_in_bytes;
+
+		std::scoped_lock lock( mtx );
+
+		size_t const capacity = capacity_in_bytes.load( std::memory_order_relaxed );
+
+		if ( entry.size_in_bytes > capacity ) {
+			// Entry would never fit.
+			return;
+		}
+
+		auto it = index.find( hash );
+
+		if ( it != index.end() ) {
+			if ( key_equals( *it->second, key, key_size ) ) {
+				return;
+			}
+			size_in_bytes -= it->second->size_in_bytes;
+			evicted.splice( evicted.end(), entries, it->second );
+			index.erase( it );
+		}
+
+		evict_to( capacity - entry.size_in_bytes, evicted );
+
+		size_in_bytes += entry.size_in_bytes;
+		entries.splice( entries.begin(), evicted, evicted.begin() ); // our new entry is still the first element of `evicted`
+		index[ hash ] = entries.begin();
+	}
+
+	void set_capacity( size_t capacity ) {
+		std::list<Entry> evicted;
+		std::scoped_lock lock( mtx );
+		capacity_in_bytes.store( capacity, std::memory_order_relaxed );
+		evict_to( capacity, evicted );
+	}
+
+	// Drops all entries, and resets counters.
+	void clear() {
+		std::list<Entry> evicted;
+		std::scoped_lock lock( mtx );
+		evicted.swap( entries );
+		index.clear();
+		size_in_bytes = 0;
+		hits          = 0;
+		misses        = 0;
+		evictions     = 0;
+	}
+
+	Stats get_stats() {
+		std::scoped_lock lock( mtx );
+		return { hits, misses, evictions, entries.size(), size_in_bytes, capacity_in_bytes.load( std::memory_order_relaxed ) };
+	}
+};
+
+#endif
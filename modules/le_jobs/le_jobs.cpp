@@ -10,6 +10,7 @@
 #include "assert.h"
 
 #include "private/lockfree_ring_buffer.h"
+#include "le_trace/le_trace.h"
 
 struct le_fiber_o;
 struct le_worker_thread_o;
@@ -247,6 +248,12 @@ static inline int32_t get_current_worker_thread_id() {
 	return result;
 }
 
+// ----------------------------------------------------------------------
+// return number of worker threads, or 0 if job system has not been initialised.
+static size_t le_job_manager_get_worker_thread_count() {
+	return job_manager ? job_manager->worker_thread_count : 0;
+}
+
 // ----------------------------------------------------------------------
 // return pointer to current worker thread providing context,
 // or nullptr if no current worker thread could be found.
@@ -386,7 +393,13 @@ static void le_worker_thread_dispatch( le_worker_thread_o *self ) {
 	assert( self->guest_fiber->stack ); // address of stack must not be 0
 
 	// switch to guest fiber
-	asm_switch( self->guest_fiber, &self->host_fiber, 1 );
+	{
+		// Zone covers the time the fiber executes on this worker thread - until it
+		// either completes or yields. We don't place zones inside fibers, since a
+		// yielding fiber would interleave its zones with other fibers' zones.
+		LE_TRACE_ZONE( "le_jobs::run_fiber" );
+		asm_switch( self->guest_fiber, &self->host_fiber, 1 );
+	}
 
 	// If we're back here, this means that the fiber in current_fiber has
 	// finished executing for now. This can have two reasons:
@@ -413,6 +426,8 @@ static void le_worker_thread_loop( le_worker_thread_o *self ) {
 
 	self->thread_id = std::this_thread::get_id();
 
+	le_trace::le_trace_i.set_thread_name( "le_jobs worker" );
+
 	while ( 0 == self->stop_thread ) {
 		le_worker_thread_dispatch( self );
 	}
@@ -586,6 +601,7 @@ LE_MODULE_REGISTER_IMPL( le_jobs, api ) {
 	static_cast<le_jobs_api *>( api )->initialize                = le_job_manager_initialize;
 	static_cast<le_jobs_api *>( api )->terminate                 = le_job_manager_terminate;
 	static_cast<le_jobs_api *>( api )->wait_for_counter_and_free = le_job_manager_wait_for_counter_and_free;
+	static_cast<le_jobs_api *>( api )->get_worker_thread_count   = le_job_manager_get_worker_thread_count;
 
 	//	le_core_load_library_persistently( "libpthread.so" );
 }
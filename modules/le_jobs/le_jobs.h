@@ -53,6 +53,9 @@ struct le_jobs_api {
 	// return id of current worker thread (0..MAX_THREADS), or -1 if called from outside job system.
 	int32_t (* get_current_worker_id)(void); 
 
+	// return number of worker threads, or 0 if job system has not been initialised.
+	size_t (* get_worker_thread_count)(void);
+
 };
 // clang-format on
 LE_MODULE( le_jobs );
@@ -71,8 +74,9 @@ static const auto &terminate                 = api -> terminate;
 static const auto &run_jobs                  = api -> run_jobs;
 static const auto &wait_for_counter_and_free = api -> wait_for_counter_and_free;
 
-static const auto &yield                 = api -> yield;
-static const auto &get_current_worker_id = api -> get_current_worker_id;
+static const auto &yield                   = api -> yield;
+static const auto &get_current_worker_id   = api -> get_current_worker_id;
+static const auto &get_worker_thread_count = api -> get_worker_thread_count;
 
 } // namespace le_jobs
 
@@ -0,0 +1,23 @@
+#ifndef GUARD_le_path_benchmark_stubs_H
+#define GUARD_le_path_benchmark_stubs_H
+
+// Benchmarks don't link le_core - this is all that's needed to load le_path
+// statically. Modules le_path depends on, but which benchmarks don't use,
+// are registered as empty apis.
+
+#include "le_core/le_core.h"
+#include <stdlib.h>
+
+ISL_API_ATTR void *le_core_load_module_static( char const *, void ( *module_reg_fun )( void * ), uint64_t api_size_in_bytes ) {
+	void *api = calloc( 1, api_size_in_bytes );
+	module_reg_fun( api );
+	return api;
+}
+
+ISL_API_ATTR void le_module_register_le_jobs( void * ) {
+}
+
+ISL_API_ATTR void le_module_register_le_tessellator( void * ) {
+}
+
+#endif
@@ -0,0 +1,158 @@
+/*
+
+  Benchmark: batched flattening vs. scalar reference flattening.
+
+  This is a standalone program, and not part of the build - it includes
+  le_path.cpp directly, so that it can call the scalar reference
+  implementation, which is not exposed via the api. Build from the island
+  root directory with:
+
+      c++ -std=c++17 -O2 -DNDEBUG -I . -I modules -I 3rdparty/src/glm \
+          modules/le_path/benchmark/le_path_flatten_benchmark.cpp \
+          3rdparty/src/spooky/SpookyV2.cpp -o le_path_flatten_benchmark
+
+  Then run:
+
+      ./le_path_flatten_benchmark [num_paths] [num_iterations] [tolerance]
+
+  The test scene is made of glyph-like closed paths, each a mix of cubic
+  and quadratic bezier segments with a few straight lines thrown in.
+
+  The geometry cache is disabled while we compare flattening methods, and
+  then enabled for a last run, in which every path is a cache hit.
+
+*/
+
+#include "../le_path.cpp"
+#include "le_path_benchmark_stubs.h"
+
+#include <chrono>
+#include <random>
+
+// ----------------------------------------------------------------------
+
+static void build_scene( std::vector<le_path_o *> &paths, size_t num_paths ) {
+
+	std::mt19937                          rng( 12345 );
+	std::uniform_real_distribution<float> offset( -20.f, 20.f );
+	std::uniform_int_distribution<int>    kind( 0, 9 );
+
+	for ( size_t i = 0; i != num_paths; i++ ) {
+
+		le_path_o *path = le_path_create();
+
+		glm::vec2 origin{ float( i % 32 ) * 100.f, float( i / 32 ) * 100.f };
+		glm::vec2 p = origin;
+
+		le_path_move_to( path, &p );
+
+		// Walk around a circle, so that the contour closes without a long jump.
+		constexpr int num_segments = 48;
+
+		for ( int s = 1; s <= num_segments; s++ ) {
+			float const     angle = glm::two_pi<float>() * float( s ) / float( num_segments );
+			glm::vec2 const p1    = origin + 40.f * glm::vec2{ cosf( angle ), sinf( angle ) };
+			glm::vec2 const c1    = p + glm::vec2{ offset( rng ), offset( rng ) };
+			glm::vec2 const c2    = p1 + glm::vec2{ offset( rng ), offset( rng ) };
+
+			int const k = kind( rng );
+			if ( k < 5 ) {
+				le_path_cubic_bezier_to( path, &p1, &c1, &c2 );
+			} else if ( k < 9 ) {
+				le_path_quad_bezier_to( path, &p1, &c1 );
+			} else {
+				le_path_line_to( path, &p1 );
+			}
+			p = p1;
+		}
+
+		le_path_close_path( path );
+		paths.push_back( path );
+	}
+}
+
+// ----------------------------------------------------------------------
+
+static size_t count_vertices( std::vector<le_path_o *> const &paths ) {
+	size_t result = 0;
+	for ( auto const &p : paths ) {
+		for ( auto const &polyline : p->polylines ) {
+			result += polyline.vertices.size();
+		}
+	}
+	return result;
+}
+
+// ----------------------------------------------------------------------
+
+template <typename Fun>
+static double measure_ms( size_t num_iterations, Fun &&fun ) {
+	fun(); // warm up
+	auto t0 = std::chrono::steady_clock::now();
+	for ( size_t i = 0; i != num_iterations; i++ ) {
+		fun();
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>( t1 - t0 ).count() / double( num_iterations );
+}
+
+// ----------------------------------------------------------------------
+
+int main( int argc, char const **argv ) {
+
+	size_t const num_paths      = argc > 1 ? size_t( atol( argv[ 1 ] ) ) : 1024;
+	size_t const num_iterations = argc > 2 ? size_t( atol( argv[ 2 ] ) ) : 20;
+	float const  tolerance      = argc > 3 ? float( atof( argv[ 3 ] ) ) : 0.25f;
+
+	std::vector<le_path_o *> paths;
+	build_scene( paths, num_paths );
+
+	le_path_set_cache_capacity( 0 );
+
+	double const ms_scalar = measure_ms( num_iterations, [ & ]() {
+		for ( auto &p : paths ) {
+			le_path_flatten_path_scalar( p, tolerance );
+		}
+	} );
+	size_t const vertices_scalar = count_vertices( paths );
+
+	double const ms_batched = measure_ms( num_iterations, [ & ]() {
+		for ( auto &p : paths ) {
+			le_path_flatten_path( p, tolerance );
+		}
+	} );
+	size_t const vertices_batched = count_vertices( paths );
+
+	double const ms_batched_many = measure_ms( num_iterations, [ & ]() {
+		le_path_flatten_paths( paths.data(), paths.size(), tolerance );
+	} );
+
+	le_path_set_cache_capacity( size_t( 1 ) << 30 );
+
+	double const ms_cached = measure_ms( num_iterations, [ & ]() {
+		le_path_flatten_paths( paths.data(), paths.size(), tolerance );
+	} );
+
+	le_path_api::cache_stats_t stats{};
+	le_path_get_cache_stats( &stats );
+
+	printf( "le_path flatten: %zu paths, tolerance %.3f, %s\n", num_paths, double( tolerance ),
+#ifdef LE_PATH_FLATTEN_BATCH_USE_SSE2
+	        "sse2"
+#else
+	        "scalar fallback"
+#endif
+	);
+	printf( "%-28s %10.3f ms/iteration, %10zu vertices\n", "scalar (reference)", ms_scalar, vertices_scalar );
+	printf( "%-28s %10.3f ms/iteration, %10zu vertices\n", "batched, one path per call", ms_batched, vertices_batched );
+	printf( "%-28s %10.3f ms/iteration, %10zu vertices\n", "batched, all paths at once", ms_batched_many, vertices_batched );
+	printf( "%-28s %10.3f ms/iteration, %10llu hits, %llu misses\n", "batched, cached", ms_cached,
+	        ( unsigned long long )stats.hits, ( unsigned long long )stats.misses );
+	printf( "speedup: %.2fx\n", ms_scalar / ms_batched_many );
+
+	for ( auto &p : paths ) {
+		le_path_destroy( p );
+	}
+
+	return 0;
+}
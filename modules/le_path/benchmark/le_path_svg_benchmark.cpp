@@ -0,0 +1,208 @@
+/*
+
+  Benchmark: SVG path data parsing throughput.
+
+  This is a standalone program, and not part of the build. Build from the
+  island root directory with:
+
+      c++ -std=c++17 -O2 -DNDEBUG -I . -I modules -I 3rdparty/src/glm \
+          modules/le_path/benchmark/le_path_svg_benchmark.cpp \
+          3rdparty/src/spooky/SpookyV2.cpp -o le_path_svg_benchmark
+
+  Then run:
+
+      ./le_path_svg_benchmark [num_iterations] [file.svg ...]
+
+  Without files, we parse a synthetic corpus of about a million path
+  commands, which mixes all command types, absolute and relative
+  coordinates, implicit command repeats, compact number separators, and
+  numbers with exponents - similar to what map data exports look like.
+
+  With files, we parse the path data of every `d="..."` attribute found in
+  the given files instead.
+
+  Each iteration parses the whole corpus into one path, which is cleared
+  between iterations, so that we measure parsing, and not allocation.
+
+*/
+
+#include "../le_path.cpp"
+#include "le_path_benchmark_stubs.h"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <fstream>
+#include <sstream>
+
+// ----------------------------------------------------------------------
+
+static void build_synthetic_corpus( std::vector<std::string> &corpus ) {
+
+	std::mt19937                          rng( 12345 );
+	std::uniform_real_distribution<float> coord( -500.f, 500.f );
+	std::uniform_real_distribution<float> delta( -20.f, 20.f );
+	std::uniform_int_distribution<int>    kind( 0, 11 );
+
+	char buf[ 256 ];
+
+	constexpr size_t num_paths            = 10000;
+	constexpr size_t num_commands_per_path = 100;
+
+	for ( size_t i = 0; i != num_paths; i++ ) {
+
+		std::string d;
+
+		snprintf( buf, sizeof( buf ), "M%.3f,%.3f", double( coord( rng ) ), double( coord( rng ) ) );
+		d += buf;
+
+		for ( size_t j = 0; j != num_commands_per_path; j++ ) {
+			switch ( kind( rng ) ) {
+			case 0:
+				snprintf( buf, sizeof( buf ), "L%.3f %.3f", double( coord( rng ) ), double( coord( rng ) ) );
+				break;
+			case 1:
+				snprintf( buf, sizeof( buf ), "l%.2f%+.2f", double( delta( rng ) ), double( delta( rng ) ) ); // compact separators
+				break;
+			case 2:
+				snprintf( buf, sizeof( buf ), "h%.2f", double( delta( rng ) ) );
+				break;
+			case 3:
+				snprintf( buf, sizeof( buf ), "V%.2f", double( coord( rng ) ) );
+				break;
+			case 4:
+				snprintf( buf, sizeof( buf ), "c%.2f,%.2f %.2f,%.2f %.2f,%.2f",
+				          double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ),
+				          double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			case 5:
+				snprintf( buf, sizeof( buf ), "C%.3f %.3f %.3f %.3f %.3f %.3f",
+				          double( coord( rng ) ), double( coord( rng ) ), double( coord( rng ) ),
+				          double( coord( rng ) ), double( coord( rng ) ), double( coord( rng ) ) );
+				break;
+			case 6:
+				snprintf( buf, sizeof( buf ), "s%.2f,%.2f %.2f,%.2f",
+				          double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			case 7:
+				snprintf( buf, sizeof( buf ), "q%.2f,%.2f %.2f,%.2f",
+				          double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			case 8:
+				snprintf( buf, sizeof( buf ), "t%.2f,%.2f", double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			case 9:
+				snprintf( buf, sizeof( buf ), "a%.1f,%.1f %.1f 0,1 %.2f,%.2f",
+				          double( 5.f + fabsf( delta( rng ) ) ), double( 5.f + fabsf( delta( rng ) ) ), double( delta( rng ) ),
+				          double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			case 10:
+				snprintf( buf, sizeof( buf ), "l%.4e,%.4e %.4e,%.4e", // exponents, and an implicit repeat
+				          double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			default:
+				snprintf( buf, sizeof( buf ), "zm%.2f,%.2f", double( delta( rng ) ), double( delta( rng ) ) );
+				break;
+			}
+			d += buf;
+		}
+
+		d += 'z';
+
+		corpus.emplace_back( std::move( d ) );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Appends contents of all `d="..."` attributes found in file to corpus.
+static bool add_svg_file_to_corpus( char const *file_path, std::vector<std::string> &corpus ) {
+
+	std::ifstream file( file_path, std::ios::binary );
+
+	if ( !file.is_open() ) {
+		fprintf( stderr, "ERROR: Could not open file '%s'\n", file_path );
+		return false;
+	}
+
+	std::stringstream contents;
+	contents << file.rdbuf();
+	std::string const str = contents.str();
+
+	for ( size_t pos = str.find( " d=\"" ); pos != std::string::npos; pos = str.find( " d=\"", pos ) ) {
+		pos += 4;
+		size_t const end = str.find( '"', pos );
+		if ( end == std::string::npos ) {
+			break;
+		}
+		corpus.emplace_back( str.substr( pos, end - pos ) );
+		pos = end;
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+int main( int argc, char const **argv ) {
+
+	size_t const num_iterations = argc > 1 ? size_t( atol( argv[ 1 ] ) ) : 10;
+
+	std::vector<std::string> corpus;
+
+	if ( argc > 2 ) {
+		for ( int i = 2; i < argc; i++ ) {
+			if ( !add_svg_file_to_corpus( argv[ i ], corpus ) ) {
+				return 1;
+			}
+		}
+	} else {
+		build_synthetic_corpus( corpus );
+	}
+
+	size_t num_bytes = 0;
+	for ( auto const &d : corpus ) {
+		num_bytes += d.size();
+	}
+
+	le_path_o *path = le_path_create();
+
+	size_t num_commands = 0;
+	size_t num_errors   = 0;
+
+	auto parse_corpus = [ & ]() {
+		le_path_clear( path );
+		num_errors = 0;
+		for ( auto const &d : corpus ) {
+			num_errors += !le_path_add_from_svg( path, d.data(), d.size() );
+		}
+	};
+
+	parse_corpus(); // warm up, and size retained storage
+
+	for ( auto const &c : path->contours ) {
+		num_commands += c.commands.size();
+	}
+
+	auto t0 = std::chrono::steady_clock::now();
+	for ( size_t i = 0; i != num_iterations; i++ ) {
+		parse_corpus();
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	double const ms = std::chrono::duration<double, std::milli>( t1 - t0 ).count() / double( num_iterations );
+
+	printf( "le_path svg: %zu paths, %.2f MB, %zu commands, %zu paths with errors, %s\n",
+	        corpus.size(), double( num_bytes ) / ( 1024. * 1024. ), num_commands, num_errors,
+#ifdef LE_PATH_SVG_PARSER_USE_FROM_CHARS
+	        "from_chars"
+#else
+	        "strtof"
+#endif
+	);
+	printf( "%10.3f ms/iteration, %8.1f MB/s, %8.2f million commands/s\n",
+	        ms, double( num_bytes ) / ( 1024. * 1024. ) / ( ms / 1000. ), double( num_commands ) / 1e6 / ( ms / 1000. ) );
+
+	le_path_destroy( path );
+
+	return 0;
+}
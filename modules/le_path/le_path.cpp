@@ -1,7 +1,15 @@
 #include "le_path.h"
 #include "le_core/le_core.h"
+#include "le_core/lru_cache.h"
+#include "private/le_path_flatten_batch.h"
+#include "private/le_path_svg_parser.h"
+#include "private/le_path_rasterizer.h"
+#include "3rdparty/src/spooky/SpookyV2.h"
+#include "le_jobs/le_jobs.h"
+#include "le_tessellator/le_tessellator.h"
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 #include <cstring>
 #include <cstdio>
@@ -80,9 +88,35 @@ struct Polyline {
 	float                  total_distance = 0;
 };
 
+// Key for generated geometry - see geometry_cache_calculate_key.
+struct GeometryCacheKey {
+	uint64_t             hash = 0;
+	std::vector<uint8_t> bytes; // everything which influences generated geometry, compared in full on cache hits
+
+	bool operator==( GeometryCacheKey const &rhs ) const {
+		return hash == rhs.hash && bytes == rhs.bytes;
+	}
+	bool operator!=( GeometryCacheKey const &rhs ) const {
+		return !( *this == rhs );
+	}
+};
+
 struct le_path_o {
-	std::vector<Contour>  contours;  // an array of sub-paths, a contour must start with a moveto instruction
-	std::vector<Polyline> polylines; // an array of polylines, each corresponding to a sub-path.
+	std::vector<Contour>   contours;             // an array of sub-paths, a contour must start with a moveto instruction
+	std::vector<Polyline>  polylines;            // an array of polylines, each corresponding to a sub-path.
+	std::vector<glm::vec2> generated_vertices;   // thick contour triangles, or left offset outline, from most recent path_update_generated_*
+	std::vector<glm::vec2> generated_vertices_r; // right offset outline from most recent path_update_generated_offset_outline
+	GeometryCacheKey       generated_key;        // key for contents of generated_vertices, and generated_vertices_r - empty if unknown
+
+	// Retained storage: storage of anything we clear is kept here, and handed
+	// out again whenever we need new storage, so that a path which is rebuilt
+	// every frame stops allocating once it has reached its high-water mark.
+	std::vector<std::vector<PathCommand>> spare_commands;  // command storage of contours which were cleared
+	std::vector<Polyline>                 spare_polylines; // empty polylines, each keeping its capacity
+	le_path_cubic_batch_t                 flatten_batch;   // scratch storage for batch flattening
+
+	// Created on first fill, and reused for every fill after, so that it keeps its storage.
+	le_tessellator_o *tessellator = nullptr;
 };
 
 struct CubicBezier {
@@ -236,6 +270,325 @@ inline static bool is_contained_0_1( float f ) {
 	return ( f >= 0.f && f <= 1.f );
 }
 
+// ----------------------------------------------------------------------
+// Removes all contours, keeping their command storage for re-use.
+static void path_release_contours( le_path_o *self ) {
+	for ( auto &c : self->contours ) {
+		c.commands.clear();
+		self->spare_commands.emplace_back( std::move( c.commands ) );
+	}
+	self->contours.clear();
+}
+
+// ----------------------------------------------------------------------
+// Adds an empty contour, re-using retained command storage if possible.
+static Contour &path_add_contour( le_path_o *self ) {
+	auto &contour = self->contours.emplace_back();
+	if ( !self->spare_commands.empty() ) {
+		contour.commands = std::move( self->spare_commands.back() );
+		self->spare_commands.pop_back();
+	}
+	return contour;
+}
+
+// ----------------------------------------------------------------------
+// Removes all polylines, keeping their storage for re-use.
+static void path_release_polylines( le_path_o *self ) {
+	for ( auto &p : self->polylines ) {
+		p.vertices.clear();
+		p.tangents.clear();
+		p.distances.clear();
+		p.total_distance = 0;
+		self->spare_polylines.emplace_back( std::move( p ) );
+	}
+	self->polylines.clear();
+}
+
+// ----------------------------------------------------------------------
+// Returns an empty polyline, re-using retained storage if possible.
+static Polyline path_acquire_polyline( le_path_o *self ) {
+	if ( self->spare_polylines.empty() ) {
+		return {};
+	}
+	Polyline result = std::move( self->spare_polylines.back() );
+	self->spare_polylines.pop_back();
+	return result;
+}
+
+// ----------------------------------------------------------------------
+// Sets polylines for path to a copy of `polylines`, re-using retained storage.
+static void path_assign_polylines( le_path_o *self, std::vector<Polyline> const &polylines ) {
+	path_release_polylines( self );
+	for ( auto const &src : polylines ) {
+		Polyline p = path_acquire_polyline( self );
+		p.vertices.assign( src.vertices.begin(), src.vertices.end() );
+		p.tangents.assign( src.tangents.begin(), src.tangents.end() );
+		p.distances.assign( src.distances.begin(), src.distances.end() );
+		p.total_distance = src.total_distance;
+		self->polylines.emplace_back( std::move( p ) );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Geometry cache
+//
+// Generating geometry from path commands is expensive, but paths are often
+// rebuilt with identical commands, frame after frame. We therefore keep a
+// bounded, least-recently-used cache of generated geometry, shared by all
+// paths, and keyed by a hash over the commands which were used to generate
+// the geometry, and all parameters which influence generation.
+//
+// Cache hits copy geometry out of the cache, so that paths never reference
+// cache entries. Copies happen outside the cache lock, so that parallel
+// tessellation, and rasterization don't queue up behind each other.
+//
+// Use `set_cache_capacity(0)` to disable caching altogether.
+
+enum GeometryCacheEntryKind : uint32_t {
+	eGeometryFlatten = 1,
+	eGeometryTrace,
+	eGeometryOffsetOutline,
+	eGeometryThickContour,
+	eGeometryFill,
+};
+
+struct CachedGeometry {
+	std::vector<Polyline>  polylines;  // used for eGeometryFlatten, eGeometryTrace
+	std::vector<glm::vec2> vertices;   // used for eGeometryThickContour, eGeometryFill (triangles), eGeometryOffsetOutline (left outline)
+	std::vector<glm::vec2> vertices_r; // used for eGeometryOffsetOutline (right outline)
+};
+
+static LruCache<CachedGeometry> &get_geometry_cache() {
+	static LruCache<CachedGeometry> cache{ 32 << 20 };
+	return cache;
+}
+
+// ----------------------------------------------------------------------
+
+static inline bool geometry_cache_is_enabled() {
+	return get_geometry_cache().is_enabled();
+}
+
+// ----------------------------------------------------------------------
+
+static size_t cached_geometry_calculate_size( CachedGeometry const &geometry ) {
+	size_t result = sizeof( CachedGeometry ) +
+	                sizeof( glm::vec2 ) * ( geometry.vertices.size() + geometry.vertices_r.size() ) +
+	                sizeof( Polyline ) * geometry.polylines.size();
+	for ( auto const &p : geometry.polylines ) {
+		result += sizeof( glm::vec2 ) * ( p.vertices.size() + p.tangents.size() ) +
+		          sizeof( float ) * p.distances.size();
+	}
+	return result;
+}
+
+// ----------------------------------------------------------------------
+// Returns true on cache hit, in which case any non-null parameters receive
+// a copy of the corresponding geometry stored with the cache entry - cached
+// polylines are copied into the polylines of `polylines_path`.
+static bool geometry_cache_fetch( GeometryCacheKey const &key, le_path_o *polylines_path, std::vector<glm::vec2> *vertices, std::vector<glm::vec2> *vertices_r ) {
+
+	auto const geometry = get_geometry_cache().find( key.hash, key.bytes.data(), key.bytes.size() );
+
+	if ( nullptr == geometry ) {
+		return false;
+	}
+
+	if ( polylines_path ) {
+		path_assign_polylines( polylines_path, geometry->polylines );
+	}
+	if ( vertices ) {
+		*vertices = geometry->vertices;
+	}
+	if ( vertices_r ) {
+		*vertices_r = geometry->vertices_r;
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+// Stores a copy of the given geometry under `key` - any parameter may be null.
+static void geometry_cache_store( GeometryCacheKey const &key, std::vector<Polyline> const *polylines, std::vector<glm::vec2> const *vertices, std::vector<glm::vec2> const *vertices_r ) {
+
+	auto geometry = std::make_shared<CachedGeometry>();
+
+	if ( polylines ) {
+		geometry->polylines = *polylines;
+	}
+	if ( vertices ) {
+		geometry->vertices = *vertices;
+	}
+	if ( vertices_r ) {
+		geometry->vertices_r = *vertices_r;
+	}
+
+	size_t const size_in_bytes = cached_geometry_calculate_size( *geometry );
+
+	get_geometry_cache().store( key.hash, key.bytes.data(), key.bytes.size(), std::move( geometry ), size_in_bytes );
+}
+
+// ----------------------------------------------------------------------
+
+static void le_path_set_cache_capacity( size_t capacity_in_bytes ) {
+	get_geometry_cache().set_capacity( capacity_in_bytes );
+}
+
+// ----------------------------------------------------------------------
+// Drops all cache entries, and resets counters.
+static void le_path_clear_cache() {
+	get_geometry_cache().clear();
+}
+
+// ----------------------------------------------------------------------
+
+static void le_path_get_cache_stats( le_path_api::cache_stats_t *stats ) {
+	auto const cache_stats   = get_geometry_cache().get_stats();
+	stats->hits              = cache_stats.hits;
+	stats->misses            = cache_stats.misses;
+	stats->evictions         = cache_stats.evictions;
+	stats->num_entries       = cache_stats.num_entries;
+	stats->size_in_bytes     = cache_stats.size_in_bytes;
+	stats->capacity_in_bytes = cache_stats.capacity_in_bytes;
+}
+
+// ----------------------------------------------------------------------
+// Path commands, packed so that they may be hashed, and compared as raw
+// memory. We can't do this with commands themselves, since unused bytes in
+// `PathCommand::data` are not initialised.
+struct PackedPathCommand {
+	uint32_t type;
+	float    values[ 7 ];
+};
+
+static void pack_path_command( PackedPathCommand &d, PathCommand const &command ) {
+
+	d             = {};
+	d.type        = command.type;
+	d.values[ 0 ] = command.p.x;
+	d.values[ 1 ] = command.p.y;
+
+	switch ( command.type ) {
+	case PathCommand::eQuadBezierTo:
+		d.values[ 2 ] = command.data.as_quad_bezier.c1.x;
+		d.values[ 3 ] = command.data.as_quad_bezier.c1.y;
+		break;
+	case PathCommand::eCubicBezierTo:
+		d.values[ 2 ] = command.data.as_cubic_bezier.c1.x;
+		d.values[ 3 ] = command.data.as_cubic_bezier.c1.y;
+		d.values[ 4 ] = command.data.as_cubic_bezier.c2.x;
+		d.values[ 5 ] = command.data.as_cubic_bezier.c2.y;
+		break;
+	case PathCommand::eArcTo:
+		d.values[ 2 ] = command.data.as_arc.radii.x;
+		d.values[ 3 ] = command.data.as_arc.radii.y;
+		d.values[ 4 ] = command.data.as_arc.phi;
+		d.values[ 5 ] = command.data.as_arc.large_arc ? 1.f : 0.f;
+		d.values[ 6 ] = command.data.as_arc.sweep ? 1.f : 0.f;
+		break;
+	default:
+		break;
+	}
+}
+
+// ----------------------------------------------------------------------
+// Adds all commands of contour to hash. We pack commands into a buffer
+// first, and hash the buffer in one go whenever it is full, as each call
+// to Update has a fixed cost.
+static void hash_contour_commands( SpookyHash &hash, Contour const &contour ) {
+
+	static constexpr size_t BUFFER_SIZE = 64;
+
+	PackedPathCommand buffer[ BUFFER_SIZE ];
+	size_t            num_buffered = 0;
+
+	uint64_t const num_commands = contour.commands.size();
+	hash.Update( &num_commands, sizeof( num_commands ) );
+
+	for ( auto const &command : contour.commands ) {
+
+		pack_path_command( buffer[ num_buffered++ ], command );
+
+		if ( num_buffered == BUFFER_SIZE ) {
+			hash.Update( buffer, sizeof( PackedPathCommand ) * num_buffered );
+			num_buffered = 0;
+		}
+	}
+
+	if ( num_buffered ) {
+		hash.Update( buffer, sizeof( PackedPathCommand ) * num_buffered );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Appends `num_bytes` bytes starting at `data` to `bytes`.
+static void append_bytes( std::vector<uint8_t> &bytes, void const *data, size_t num_bytes ) {
+	size_t const offset = bytes.size();
+	bytes.resize( offset + num_bytes );
+	memcpy( bytes.data() + offset, data, num_bytes );
+}
+
+// ----------------------------------------------------------------------
+// Appends all commands of contour, packed, to `bytes`.
+static void append_contour_commands( std::vector<uint8_t> &bytes, Contour const &contour ) {
+
+	uint64_t const num_commands = contour.commands.size();
+	append_bytes( bytes, &num_commands, sizeof( num_commands ) );
+
+	size_t const offset = bytes.size();
+	bytes.resize( offset + sizeof( PackedPathCommand ) * contour.commands.size() );
+
+	uint8_t *packed = bytes.data() + offset; // not necessarily aligned for PackedPathCommand, which is why we memcpy
+
+	for ( auto const &command : contour.commands ) {
+		PackedPathCommand d;
+		pack_path_command( d, command );
+		memcpy( packed, &d, sizeof( d ) );
+		packed += sizeof( d );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Sets `key` to cache key for geometry of `kind`, generated from either all
+// contours of a path, or a single contour if `contour_index` is given.
+// `params` must point to all parameters which influence generation.
+//
+// The key holds everything which influences generation, so that a cache hit
+// can be verified in full, and is not just a matching hash.
+static void geometry_cache_calculate_key( GeometryCacheKey &key, GeometryCacheEntryKind kind, le_path_o const *self, size_t const *contour_index, void const *params, size_t params_size ) {
+
+	key.bytes.clear();
+
+	append_bytes( key.bytes, &kind, sizeof( kind ) );
+	append_bytes( key.bytes, params, params_size );
+
+	if ( contour_index ) {
+		append_contour_commands( key.bytes, self->contours[ *contour_index ] );
+	} else {
+		for ( auto const &contour : self->contours ) {
+			append_contour_commands( key.bytes, contour );
+		}
+	}
+
+	key.hash = SpookyHash::Hash64( key.bytes.data(), key.bytes.size(), 0 );
+}
+
+// ----------------------------------------------------------------------
+// Paths built from the same commands have the same hash.
+static uint64_t le_path_get_hash( le_path_o *self ) {
+
+	SpookyHash hash;
+	hash.Init( 0, 0 );
+
+	for ( auto const &contour : self->contours ) {
+		hash_contour_commands( hash, contour );
+	}
+
+	uint64_t h1, h2;
+	hash.Final( &h1, &h2 );
+	return h1;
+}
+
 // ----------------------------------------------------------------------
 
 static le_path_o *le_path_create() {
@@ -246,14 +599,21 @@ static le_path_o *le_path_create() {
 // ----------------------------------------------------------------------
 
 static void le_path_destroy( le_path_o *self ) {
+	if ( self->tessellator ) {
+		le_tessellator::le_tessellator_i.destroy( self->tessellator );
+	}
 	delete self;
 }
 
 // ----------------------------------------------------------------------
 
+// Keeps all storage, so that the path may be rebuilt without allocating.
 static void le_path_clear( le_path_o *self ) {
-	self->contours.clear();
-	self->polylines.clear();
+	path_release_contours( self );
+	path_release_polylines( self );
+	self->generated_vertices.clear();
+	self->generated_vertices_r.clear();
+	self->generated_key = {};
 }
 
 // ----------------------------------------------------------------------
@@ -560,12 +920,23 @@ static void trace_arc_to( Polyline &       polyline,
 //
 static void le_path_trace_path( le_path_o *self, size_t resolution ) {
 
-	self->polylines.clear();
+	bool const       use_cache = geometry_cache_is_enabled();
+	GeometryCacheKey cache_key;
+
+	if ( use_cache ) {
+		uint64_t const params = resolution;
+		geometry_cache_calculate_key( cache_key, eGeometryTrace, self, nullptr, &params, sizeof( params ) );
+		if ( geometry_cache_fetch( cache_key, self, nullptr, nullptr ) ) {
+			return;
+		}
+	}
+
+	path_release_polylines( self );
 	self->polylines.reserve( self->contours.size() );
 
 	for ( auto const &s : self->contours ) {
 
-		Polyline polyline;
+		Polyline polyline = path_acquire_polyline( self );
 
 		for ( auto const &command : s.commands ) {
 
@@ -612,7 +983,11 @@ static void le_path_trace_path( le_path_o *self, size_t resolution ) {
 
 		assert( polyline.vertices.size() == polyline.distances.size() );
 
-		self->polylines.emplace_back( polyline );
+		self->polylines.emplace_back( std::move( polyline ) );
+	}
+
+	if ( use_cache ) {
+		geometry_cache_store( cache_key, &self->polylines, nullptr, nullptr );
 	}
 }
 
@@ -1224,15 +1599,17 @@ static void flatten_arc_to( Polyline &       polyline,
 }
 
 // ----------------------------------------------------------------------
+// Reference implementation: flattens one segment at a time, adaptively
+// subdividing cubic bezier curves. Not used by the api - we keep it so that
+// `benchmark/le_path_flatten_benchmark.cpp` may compare against it.
+[[maybe_unused]] static void le_path_flatten_path_scalar( le_path_o *self, float tolerance ) {
 
-static void le_path_flatten_path( le_path_o *self, float tolerance ) {
-
-	self->polylines.clear();
+	path_release_polylines( self );
 	self->polylines.reserve( self->contours.size() );
 
 	for ( auto const &s : self->contours ) {
 
-		Polyline polyline;
+		Polyline polyline = path_acquire_polyline( self );
 
 		glm::vec2 prev_point = {};
 
@@ -1281,12 +1658,252 @@ static void le_path_flatten_path( le_path_o *self, float tolerance ) {
 
 		assert( polyline.vertices.size() == polyline.distances.size() );
 
-		self->polylines.emplace_back( polyline );
+		self->polylines.emplace_back( std::move( polyline ) );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Gathers cubic bezier curves - and quadratic bezier curves, which we
+// elevate to cubics - for all contours of all given paths into `batch`,
+// in command order.
+static void flatten_paths_gather_curves( le_path_o *const *paths, size_t num_paths, le_path_cubic_batch_t &batch ) {
+
+	for ( size_t i = 0; i != num_paths; i++ ) {
+		for ( auto const &s : paths[ i ]->contours ) {
+
+			// `prev_point` follows the same rules as in the scalar implementation,
+			// `last_vertex` tracks what would be the last vertex of the polyline -
+			// that's where each curve starts.
+
+			glm::vec2 prev_point  = {};
+			glm::vec2 last_vertex = {};
+			glm::vec2 first_point = {};
+			bool      has_first   = false;
+
+			for ( auto const &command : s.commands ) {
+				switch ( command.type ) {
+				case PathCommand::eMoveTo:
+					if ( !has_first ) {
+						first_point = command.p;
+						has_first   = true;
+					}
+					prev_point  = command.p;
+					last_vertex = command.p;
+					break;
+				case PathCommand::eLineTo: // fall-through
+				case PathCommand::eArcTo:
+					prev_point  = command.p;
+					last_vertex = command.p;
+					break;
+				case PathCommand::eQuadBezierTo: {
+					auto const &    bez = command.data.as_quad_bezier;
+					glm::vec2 const c1  = prev_point + 2 / 3.f * ( bez.c1 - prev_point );
+					glm::vec2 const c2  = command.p + 2 / 3.f * ( bez.c1 - command.p );
+					batch.push_back( last_vertex.x, last_vertex.y, c1.x, c1.y, c2.x, c2.y, command.p.x, command.p.y );
+					prev_point  = command.p;
+					last_vertex = command.p;
+				} break;
+				case PathCommand::eCubicBezierTo: {
+					auto const &bez = command.data.as_cubic_bezier;
+					batch.push_back( last_vertex.x, last_vertex.y, bez.c1.x, bez.c1.y, bez.c2.x, bez.c2.y, command.p.x, command.p.y );
+					prev_point  = command.p;
+					last_vertex = command.p;
+				} break;
+				case PathCommand::eClosePath:
+					last_vertex = first_point;
+					break;
+				case PathCommand::eUnknown:
+					assert( false );
+					break;
+				}
+			}
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+// Appends curve at `curve_index` in batch to polyline, using the number of
+// segments calculated for this curve.
+static void flatten_batched_cubic_bezier_to( Polyline &polyline, le_path_cubic_batch_t const &batch, size_t curve_index ) {
+
+	static_assert( sizeof( glm::vec2 ) == 2 * sizeof( float ), "glm::vec2 must be tightly packed, as we write to it as an array of floats" );
+
+	uint32_t const n = batch.num_segments[ curve_index ];
+
+	if ( n == 1 ) {
+		// A straight line - this filters out zero-length segments
+		trace_line_to( polyline, { batch.p1_x[ curve_index ], batch.p1_y[ curve_index ] } );
+		return;
+	}
+
+	size_t const vertex_offset  = polyline.vertices.size();
+	size_t const tangent_offset = polyline.tangents.size();
+
+	polyline.vertices.resize( vertex_offset + n );
+	polyline.tangents.resize( tangent_offset + n );
+
+	cubic_batch_evaluate_curve( batch, curve_index, &polyline.vertices[ vertex_offset ].x, &polyline.tangents[ tangent_offset ].x );
+
+	static constexpr float epsilon2 = std::numeric_limits<float>::epsilon() * std::numeric_limits<float>::epsilon();
+
+	glm::vec2 const *v = polyline.vertices.data() + vertex_offset - 1; // starts at last vertex before this curve
+	glm::vec2 *      t = polyline.tangents.data() + tangent_offset;
+
+	for ( uint32_t i = 0; i != n; i++ ) {
+		glm::vec2 const chord = v[ i + 1 ] - v[ i ];
+		polyline.total_distance += glm::length( chord );
+		polyline.distances.push_back( polyline.total_distance );
+
+		// If a control point coincides with an end point, the derivative
+		// vanishes at that end point - we use the chord direction instead.
+		if ( glm::dot( t[ i ], t[ i ] ) <= epsilon2 ) {
+			t[ i ] = chord;
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+// Flattens all given paths in one go: all curves for all paths are first
+// gathered, so that their subdivision counts may be calculated as a batch,
+// and so that each curve may be evaluated straight into pre-sized polylines.
+//
+// Each curve is subdivided uniformly into as many segments as are needed so
+// that no segment deviates from the curve by more than `tolerance`.
+//
+// Curves are gathered into scratch storage owned by the first path, which
+// means that flattening the same path again does not need to allocate.
+static void flatten_paths_uncached( le_path_o *const *paths, size_t num_paths, float tolerance ) {
+
+	if ( num_paths == 0 ) {
+		return;
+	}
+
+	le_path_cubic_batch_t &batch = paths[ 0 ]->flatten_batch;
+	batch.clear();
+
+	flatten_paths_gather_curves( paths, num_paths, batch );
+	cubic_batch_calculate_num_segments( batch, tolerance );
+
+	size_t curve_index = 0; // we visit curves in the same order in which they were gathered
+
+	for ( size_t i = 0; i != num_paths; i++ ) {
+
+		le_path_o *self = paths[ i ];
+
+		path_release_polylines( self );
+		self->polylines.reserve( self->contours.size() );
+
+		for ( auto const &s : self->contours ) {
+
+			// Pre-size polyline - we know exactly how many vertices we will need, apart from arcs.
+
+			size_t num_vertices = 0;
+			{
+				size_t c = curve_index;
+				for ( auto const &command : s.commands ) {
+					if ( command.type == PathCommand::eQuadBezierTo || command.type == PathCommand::eCubicBezierTo ) {
+						num_vertices += batch.num_segments[ c++ ];
+					} else {
+						num_vertices += 1;
+					}
+				}
+			}
+
+			Polyline polyline = path_acquire_polyline( self );
+
+			polyline.vertices.reserve( num_vertices );
+			polyline.tangents.reserve( num_vertices );
+			polyline.distances.reserve( num_vertices );
+
+			for ( auto const &command : s.commands ) {
+
+				switch ( command.type ) {
+				case PathCommand::eMoveTo:
+					trace_move_to( polyline, command.p );
+					break;
+				case PathCommand::eLineTo:
+					trace_line_to( polyline, command.p );
+					break;
+				case PathCommand::eQuadBezierTo: // fall-through
+				case PathCommand::eCubicBezierTo:
+					assert( !polyline.vertices.empty() ); // Contour vertices must not be empty.
+					flatten_batched_cubic_bezier_to( polyline, batch, curve_index++ );
+					break;
+				case PathCommand::eArcTo: {
+					auto &arc = command.data.as_arc;
+					flatten_arc_to( polyline, command.p, arc.radii, arc.phi, arc.large_arc, arc.sweep, tolerance );
+				} break;
+				case PathCommand::eClosePath:
+					trace_close_path( polyline );
+					break;
+				case PathCommand::eUnknown:
+					assert( false );
+					break;
+				}
+			}
+
+			assert( polyline.vertices.size() == polyline.distances.size() );
+
+			self->polylines.emplace_back( std::move( polyline ) );
+		}
+	}
+
+	assert( curve_index == batch.size() );
+}
+
+// ----------------------------------------------------------------------
+// Fetches polylines for paths which can be found in the geometry cache, and
+// flattens all others in one batch.
+static void le_path_flatten_paths( le_path_o *const *paths, size_t num_paths, float tolerance ) {
+
+	if ( !geometry_cache_is_enabled() ) {
+		flatten_paths_uncached( paths, num_paths, tolerance );
+		return;
+	}
+
+	if ( num_paths == 1 ) {
+		// Common case - we don't need to keep a list of misses.
+		GeometryCacheKey key;
+		geometry_cache_calculate_key( key, eGeometryFlatten, paths[ 0 ], nullptr, &tolerance, sizeof( tolerance ) );
+		if ( !geometry_cache_fetch( key, paths[ 0 ], nullptr, nullptr ) ) {
+			flatten_paths_uncached( paths, 1, tolerance );
+			geometry_cache_store( key, &paths[ 0 ]->polylines, nullptr, nullptr );
+		}
+		return;
+	}
+
+	std::vector<le_path_o *>       missed_paths;
+	std::vector<GeometryCacheKey> missed_keys;
+
+	GeometryCacheKey key;
+
+	for ( size_t i = 0; i != num_paths; i++ ) {
+		geometry_cache_calculate_key( key, eGeometryFlatten, paths[ i ], nullptr, &tolerance, sizeof( tolerance ) );
+		if ( !geometry_cache_fetch( key, paths[ i ], nullptr, nullptr ) ) {
+			missed_paths.push_back( paths[ i ] );
+			missed_keys.push_back( key );
+		}
+	}
+
+	if ( missed_paths.empty() ) {
+		return;
+	}
+
+	flatten_paths_uncached( missed_paths.data(), missed_paths.size(), tolerance );
+
+	for ( size_t i = 0; i != missed_paths.size(); i++ ) {
+		geometry_cache_store( missed_keys[ i ], &missed_paths[ i ]->polylines, nullptr, nullptr );
 	}
 }
 
 // ----------------------------------------------------------------------
 
+static void le_path_flatten_path( le_path_o *self, float tolerance ) {
+	le_path_flatten_paths( &self, 1, tolerance );
+}
+
+// ----------------------------------------------------------------------
+
 static void generate_offset_outline_line_to( std::vector<glm::vec2> &outline, glm::vec2 const &p0, glm::vec2 const &p1, float offset ) {
 
 	if ( p1 == p0 ) {
@@ -1642,32 +2259,15 @@ static void generate_offset_outline_arc_to( std::vector<glm::vec2> &outline_l,
 // paper from 2005:
 // "Fast, Precise Flattening of Cubic Bézier Segment Offset Curves"
 // <https://doi.org/10.1016/j.cag.2005.08.002>
-static bool le_path_generate_offset_outline_for_contour(
-    le_path_o *self, size_t contour_index,
-    float      line_weight,
-    float      tolerance,
-    glm::vec2 *outline_l_, size_t *max_count_outline_l,
-    glm::vec2 *outline_r_, size_t *max_count_outline_r ) {
-
-	// We allocate space internally to store the results of our outline generation.
-	// We do this because if we were to directly write back to the caller, we would
-	// have to bounds-check against `max_count_outline[l|r]` on every write.
-	//
-	// This way, we do the bounds-check only at the very end, and if the bounds check
-	// fails, we can at least tell the caller how many elements to reserve next time.
-
-	std::vector<glm::vec2> outline_l;
-	std::vector<glm::vec2> outline_r;
-
-	outline_l.reserve( *max_count_outline_l );
-	outline_r.reserve( *max_count_outline_r );
-
-	// Now process the commands for this contour
+static void generate_offset_outline_for_contour( std::vector<glm::vec2> &outline_l,
+                                                std::vector<glm::vec2> &outline_r,
+                                                Contour const &         s,
+                                                float                   line_weight,
+                                                float                   tolerance ) {
 
 	glm::vec2 prev_point  = {};
 	float     line_offset = line_weight * 0.5f;
 
-	auto &s = self->contours[ contour_index ];
 	for ( auto const &command : s.commands ) {
 
 		switch ( command.type ) {
@@ -1723,19 +2323,81 @@ static bool le_path_generate_offset_outline_for_contour(
 			break;
 		}
 	}
+}
 
-	// Copy generated vertices back to caller
+// ----------------------------------------------------------------------
 
-	bool success = true;
+// Sets `outline_l`, and `outline_r` of path to offset outlines for contour -
+// fetches outlines from geometry cache if possible.
+//
+// The count-then-fill api calls this twice in a row with the same arguments,
+// first to query counts, then to fetch vertices. We keep outlines with the
+// path, together with their key, so that the second call neither generates
+// geometry, nor queries the cache again.
+static void path_update_generated_offset_outline( le_path_o *self, size_t contour_index, float line_weight, float tolerance ) {
 
-	if ( outline_l_ && outline_l.size() <= *max_count_outline_l ) {
-		memcpy( outline_l_, outline_l.data(), sizeof( glm::vec2 ) * outline_l.size() );
-	} else {
-		success = false;
+	float const params[] = { line_weight, tolerance };
+
+	GeometryCacheKey key;
+	geometry_cache_calculate_key( key, eGeometryOffsetOutline, self, &contour_index, params, sizeof( params ) );
+
+	if ( key == self->generated_key ) {
+		return;
 	}
 
-	if ( outline_r_ && outline_r.size() <= *max_count_outline_r ) {
-		memcpy( outline_r_, outline_r.data(), sizeof( glm::vec2 ) * outline_r.size() );
+	auto &outline_l = self->generated_vertices;
+	auto &outline_r = self->generated_vertices_r;
+
+	bool const use_cache = geometry_cache_is_enabled();
+
+	if ( !use_cache || !geometry_cache_fetch( key, nullptr, &outline_l, &outline_r ) ) {
+
+		outline_l.clear();
+		outline_r.clear();
+
+		generate_offset_outline_for_contour( outline_l, outline_r, self->contours[ contour_index ], line_weight, tolerance );
+
+		if ( use_cache ) {
+			geometry_cache_store( key, nullptr, &outline_l, &outline_r );
+		}
+	}
+
+	self->generated_key = std::move( key );
+}
+
+// ----------------------------------------------------------------------
+
+static bool le_path_generate_offset_outline_for_contour(
+    le_path_o *self, size_t contour_index,
+    float      line_weight,
+    float      tolerance,
+    glm::vec2 *outline_l_, size_t *max_count_outline_l,
+    glm::vec2 *outline_r_, size_t *max_count_outline_r ) {
+
+	// We generate outlines into storage owned by the path, rather than writing
+	// directly back to the caller, where we would have to bounds-check against
+	// `max_count_outline[l|r]` on every write.
+	//
+	// This way, we do the bounds-check only at the very end, and if the bounds check
+	// fails, we can at least tell the caller how many elements to reserve next time.
+
+	path_update_generated_offset_outline( self, contour_index, line_weight, tolerance );
+
+	auto const &outline_l = self->generated_vertices;
+	auto const &outline_r = self->generated_vertices_r;
+
+	// Copy generated vertices back to caller
+
+	bool success = true;
+
+	if ( outline_l_ && outline_l.size() <= *max_count_outline_l ) {
+		memcpy( outline_l_, outline_l.data(), sizeof( glm::vec2 ) * outline_l.size() );
+	} else {
+		success = false;
+	}
+
+	if ( outline_r_ && outline_r.size() <= *max_count_outline_r ) {
+		memcpy( outline_r_, outline_r.data(), sizeof( glm::vec2 ) * outline_r.size() );
 	} else {
 		success = false;
 	}
@@ -1973,12 +2635,10 @@ static bool path_command_iterator( std::vector<PathCommand> const &cmds,
 
 	*cmd_next = ( *cmd ) + 1;
 
-	if ( ( *cmd_next )->type == PathCommand::eClosePath ) {
-		*cmd_next = cmds_start;
-	}
-
 	if ( *cmd_next == cmds_end ) {
 		*cmd_next = nullptr;
+	} else if ( ( *cmd_next )->type == PathCommand::eClosePath ) {
+		*cmd_next = cmds_start;
 	}
 
 	return true;
@@ -2095,19 +2755,7 @@ void tessellate_outline_l_r( std::vector<glm::vec2> &triangles, std::vector<glm:
 
 // ----------------------------------------------------------------------
 
-bool le_path_tessellate_thick_contour( le_path_o *self, size_t contour_index, le_path_api::stroke_attribute_t const *stroke_attributes, glm::vec2 *vertices, size_t *num_vertices ) {
-	std::vector<glm::vec2> triangles;
-
-	triangles.reserve( *num_vertices );
-
-	auto &contour = self->contours[ contour_index ];
-
-	if ( contour.commands.empty() ) {
-		*num_vertices = 0;
-		return true;
-	}
-
-	// ---------| Invariant: There are commands to render
+static void tessellate_thick_contour( std::vector<glm::vec2> &triangles, Contour const &contour, stroke_attribute_t const *stroke_attributes ) {
 
 	PathCommand const *command      = nullptr;
 	PathCommand const *command_prev = nullptr;
@@ -2234,8 +2882,8 @@ bool le_path_tessellate_thick_contour( le_path_o *self, size_t contour_index, le
 
 			// we must find out tangent into the path
 
-			PathCommand *tail = &contour.commands.front();
-			PathCommand *head = &contour.commands.back();
+			PathCommand const *tail = &contour.commands.front();
+			PathCommand const *head = &contour.commands.back();
 
 			glm::vec2 tangent_head{};
 			glm::vec2 tangent_tail{};
@@ -2251,8 +2899,72 @@ bool le_path_tessellate_thick_contour( le_path_o *self, size_t contour_index, le
 			}
 		}
 	}
+}
 
-	//
+// ----------------------------------------------------------------------
+
+// Sets `key` to cache key for triangles of thick contour.
+static void thick_contour_cache_key( GeometryCacheKey &key, le_path_o const *self, size_t contour_index, stroke_attribute_t const *stroke_attributes ) {
+	// Note that all fields of stroke_attribute_t are 4 bytes wide, which means there is no padding.
+	geometry_cache_calculate_key( key, eGeometryThickContour, self, &contour_index, stroke_attributes, sizeof( stroke_attribute_t ) );
+}
+
+// ----------------------------------------------------------------------
+
+// Sets `triangles` to triangles for thick contour - fetches triangles from
+// geometry cache if possible. If the cache is enabled, `key` must have been
+// set via `thick_contour_cache_key`, it is ignored otherwise.
+static void get_thick_contour_triangles( le_path_o *self, size_t contour_index, stroke_attribute_t const *stroke_attributes, GeometryCacheKey const &key, std::vector<glm::vec2> &triangles ) {
+
+	bool const use_cache = geometry_cache_is_enabled();
+
+	if ( use_cache && geometry_cache_fetch( key, nullptr, &triangles, nullptr ) ) {
+		return;
+	}
+
+	triangles.clear();
+
+	tessellate_thick_contour( triangles, self->contours[ contour_index ], stroke_attributes );
+
+	if ( use_cache ) {
+		geometry_cache_store( key, nullptr, &triangles, nullptr );
+	}
+}
+
+// ----------------------------------------------------------------------
+
+// Sets generated vertices of path to triangles for thick contour - see
+// `path_update_generated_offset_outline` for why we keep these with the path.
+static void path_update_generated_thick_contour_triangles( le_path_o *self, size_t contour_index, stroke_attribute_t const *stroke_attributes ) {
+
+	GeometryCacheKey key;
+	thick_contour_cache_key( key, self, contour_index, stroke_attributes );
+
+	if ( key == self->generated_key ) {
+		return;
+	}
+
+	get_thick_contour_triangles( self, contour_index, stroke_attributes, key, self->generated_vertices );
+
+	self->generated_key = std::move( key );
+}
+
+// ----------------------------------------------------------------------
+
+bool le_path_tessellate_thick_contour( le_path_o *self, size_t contour_index, le_path_api::stroke_attribute_t const *stroke_attributes, glm::vec2 *vertices, size_t *num_vertices ) {
+
+	auto const &contour = self->contours[ contour_index ];
+
+	if ( contour.commands.empty() ) {
+		*num_vertices = 0;
+		return true;
+	}
+
+	// ---------| Invariant: There are commands to render
+
+	path_update_generated_thick_contour_triangles( self, contour_index, stroke_attributes );
+
+	auto const &triangles = self->generated_vertices;
 
 	bool success = true;
 
@@ -2268,6 +2980,339 @@ bool le_path_tessellate_thick_contour( le_path_o *self, size_t contour_index, le
 	return success;
 }
 
+// ----------------------------------------------------------------------
+// Generates offset outlines in one pass, into storage owned by path.
+static void le_path_get_offset_outline_for_contour( le_path_o *self, size_t contour_index, float line_weight, float tolerance,
+                                                    glm::vec2 const **outline_l, size_t *num_vertices_l,
+                                                    glm::vec2 const **outline_r, size_t *num_vertices_r ) {
+
+	path_update_generated_offset_outline( self, contour_index, line_weight, tolerance );
+
+	*outline_l      = self->generated_vertices.data();
+	*num_vertices_l = self->generated_vertices.size();
+	*outline_r      = self->generated_vertices_r.data();
+	*num_vertices_r = self->generated_vertices_r.size();
+}
+
+// ----------------------------------------------------------------------
+// Tessellates thick contour in one pass, into storage owned by path.
+static void le_path_get_thick_contour_triangles( le_path_o *self, size_t contour_index, stroke_attribute_t const *stroke_attributes, glm::vec2 const **vertices, size_t *num_vertices ) {
+
+	if ( self->contours[ contour_index ].commands.empty() ) {
+		self->generated_vertices.clear();
+		self->generated_key = {};
+	} else {
+		path_update_generated_thick_contour_triangles( self, contour_index, stroke_attributes );
+	}
+
+	*vertices     = self->generated_vertices.data();
+	*num_vertices = self->generated_vertices.size();
+}
+
+// ----------------------------------------------------------------------
+// Sets `triangles` to triangles which fill all contours of path, using the
+// geometry cache if possible. Contours are flattened first, then tessellated
+// using le_tessellator.
+static void get_fill_triangles( le_path_o *self, float tolerance, uint64_t tessellator_options, std::vector<glm::vec2> &triangles ) {
+
+	using namespace le_tessellator;
+
+	bool const       use_cache = geometry_cache_is_enabled();
+	GeometryCacheKey cache_key;
+
+	if ( use_cache ) {
+		struct FillParams {
+			float    tolerance;
+			uint32_t reserved;
+			uint64_t tessellator_options;
+		} const params{ tolerance, 0, tessellator_options };
+
+		geometry_cache_calculate_key( cache_key, eGeometryFill, self, nullptr, &params, sizeof( params ) );
+		if ( geometry_cache_fetch( cache_key, nullptr, &triangles, nullptr ) ) {
+			return;
+		}
+	}
+
+	triangles.clear();
+
+	le_path_flatten_path( self, tolerance );
+
+	if ( self->tessellator == nullptr ) {
+		self->tessellator = le_tessellator_i.create();
+	}
+
+	auto tess = self->tessellator;
+	le_tessellator_i.reset( tess );
+	le_tessellator_i.set_options( tess, tessellator_options );
+
+	for ( auto const &polyline : self->polylines ) {
+		if ( !polyline.vertices.empty() ) {
+			le_tessellator_i.add_polyline( tess, polyline.vertices.data(), polyline.vertices.size() );
+		}
+	}
+
+	if ( le_tessellator_i.tessellate( tess ) ) {
+
+		le_tessellator_api::IndexType const *indices;
+		size_t                               num_indices = 0;
+		glm::vec2 const *                    vertices;
+		size_t                               num_vertices = 0;
+
+		le_tessellator_i.get_indices( tess, &indices, &num_indices );
+		le_tessellator_i.get_vertices( tess, &vertices, &num_vertices );
+
+		triangles.reserve( num_indices );
+
+		for ( size_t i = 0; i + 2 < num_indices; i += 3 ) {
+			triangles.push_back( vertices[ indices[ i + 0 ] ] );
+			triangles.push_back( vertices[ indices[ i + 1 ] ] );
+			triangles.push_back( vertices[ indices[ i + 2 ] ] );
+		}
+	}
+
+	if ( use_cache ) {
+		geometry_cache_store( cache_key, nullptr, &triangles, nullptr );
+	}
+}
+
+// ----------------------------------------------------------------------
+
+struct TessellateManyJob {
+	le_path_o *const *                          paths;     // first path for this job
+	size_t                                      num_paths; // number of paths for this job
+	le_path_api::tessellation_settings_t const *settings;
+	std::vector<glm::vec2>                      vertices;              // triangle vertices for all paths of this job, in path order
+	std::vector<size_t>                         num_vertices_per_path; // one entry per path
+};
+
+// ----------------------------------------------------------------------
+
+static void tessellate_many_job_fun( void *param ) {
+
+	auto        job      = static_cast<TessellateManyJob *>( param );
+	auto const &settings = *job->settings;
+
+	std::vector<glm::vec2> triangles;
+	GeometryCacheKey       key;
+
+	bool const use_cache = geometry_cache_is_enabled();
+
+	job->num_vertices_per_path.reserve( job->num_paths );
+
+	for ( size_t i = 0; i != job->num_paths; i++ ) {
+
+		le_path_o *  path                 = job->paths[ i ];
+		size_t const num_vertices_initial = job->vertices.size();
+
+		if ( settings.mode == le_path_api::tessellation_settings_t::eStroke ) {
+			for ( size_t c = 0; c != path->contours.size(); c++ ) {
+				if ( path->contours[ c ].commands.empty() ) {
+					continue;
+				}
+				if ( use_cache ) {
+					thick_contour_cache_key( key, path, c, &settings.stroke );
+				}
+				get_thick_contour_triangles( path, c, &settings.stroke, key, triangles );
+				job->vertices.insert( job->vertices.end(), triangles.begin(), triangles.end() );
+			}
+		} else {
+			get_fill_triangles( path, settings.fill_tolerance, settings.fill_options, triangles );
+			job->vertices.insert( job->vertices.end(), triangles.begin(), triangles.end() );
+		}
+
+		job->num_vertices_per_path.push_back( job->vertices.size() - num_vertices_initial );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Tessellates all given paths, spreading work across le_jobs worker threads
+// if the job system has been initialised. Paths must be distinct, since
+// tessellating a path may update its polylines.
+static bool le_path_tessellate_many( le_path_o *const *paths, size_t num_paths, le_path_api::tessellation_settings_t const *settings, le_path_api::vertex_buffer_alloc_cb alloc_cb, void *user_data, size_t *path_offsets ) {
+
+	path_offsets[ 0 ] = 0;
+
+	if ( num_paths == 0 ) {
+		return true;
+	}
+
+	// We create a few jobs per worker, so that workers which finish early may pick
+	// up some more work - paths may differ wildly in how costly they are to tessellate.
+
+	size_t const num_workers = le_jobs::get_worker_thread_count();
+	size_t const num_jobs    = num_workers ? std::min( num_paths, num_workers * 4 ) : 1;
+
+	std::vector<TessellateManyJob> jobs( num_jobs );
+
+	for ( size_t i = 0; i != num_jobs; i++ ) {
+		size_t const first = ( i * num_paths ) / num_jobs;
+		size_t const last  = ( ( i + 1 ) * num_paths ) / num_jobs;
+
+		jobs[ i ].paths     = paths + first;
+		jobs[ i ].num_paths = last - first;
+		jobs[ i ].settings  = settings;
+	}
+
+	if ( num_jobs == 1 ) {
+		tessellate_many_job_fun( &jobs[ 0 ] );
+	} else {
+		std::vector<le_jobs::job_t> job_list;
+		job_list.reserve( num_jobs );
+
+		for ( auto &job : jobs ) {
+			job_list.push_back( { tessellate_many_job_fun, &job } );
+		}
+
+		le_jobs::counter_t *counter;
+		le_jobs::run_jobs( job_list.data(), uint32_t( job_list.size() ), &counter );
+		le_jobs::wait_for_counter_and_free( counter, 0 );
+	}
+
+	// Jobs hold consecutive ranges of paths, which means that we can
+	// calculate offsets, and then copy job by job.
+
+	size_t *offset = path_offsets;
+
+	for ( auto const &job : jobs ) {
+		for ( auto const &count : job.num_vertices_per_path ) {
+			offset[ 1 ] = offset[ 0 ] + count;
+			offset++;
+		}
+	}
+
+	size_t const num_vertices_total = path_offsets[ num_paths ];
+
+	if ( num_vertices_total == 0 ) {
+		return true;
+	}
+
+	glm::vec2 *vertices = alloc_cb( user_data, num_vertices_total );
+
+	if ( nullptr == vertices ) {
+		return false;
+	}
+
+	for ( auto const &job : jobs ) {
+		memcpy( vertices, job.vertices.data(), sizeof( glm::vec2 ) * job.vertices.size() );
+		vertices += job.vertices.size();
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+struct RasterizeJob {
+	le_path_raster_bins_t const *bins;
+	le_path_raster_edge_t const *edges;
+	uint32_t                     first_band;
+	uint32_t                     last_band;
+	bool                         even_odd;
+	uint8_t *                    pixels;
+	uint32_t                     width;
+	uint32_t                     height;
+	size_t                       row_stride;
+};
+
+// ----------------------------------------------------------------------
+
+static void rasterize_job_fun( void *param ) {
+	auto job = static_cast<RasterizeJob *>( param );
+
+	std::vector<float> acc; // each job needs its own accumulation buffer
+
+	raster_rasterize_bands( *job->bins, job->edges, job->first_band, job->last_band, job->even_odd,
+	                        job->pixels, job->width, job->height, job->row_stride, acc );
+}
+
+// ----------------------------------------------------------------------
+// Rasterizes all contours of path as filled shapes, and writes anti-aliased,
+// 8-bit coverage for every pixel into `pixels`. Contours are flattened first,
+// which updates the polylines of the path, just as `flatten` does, and are
+// implicitly closed.
+//
+// Bands of rows are rasterized in parallel if the job system has been
+// initialised.
+static void le_path_rasterize( le_path_o *self, le_path_api::raster_settings_t const *settings, uint8_t *pixels, uint32_t width, uint32_t height, size_t row_stride ) {
+
+	if ( width == 0 || height == 0 ) {
+		return;
+	}
+
+	assert( settings->scale > 0.f );
+
+	float const     scale  = settings->scale;
+	glm::vec2 const offset = { settings->offset_x, settings->offset_y };
+
+	// -- Flatten, and collect edges in pixel coordinates
+
+	le_path_flatten_path( self, settings->tolerance / scale );
+
+	std::vector<le_path_raster_edge_t> edges;
+
+	for ( auto const &polyline : self->polylines ) {
+
+		size_t const num_vertices = polyline.vertices.size();
+
+		if ( num_vertices < 2 ) {
+			continue;
+		}
+
+		glm::vec2 const first = polyline.vertices[ 0 ] * scale + offset;
+		glm::vec2       prev  = first;
+
+		for ( size_t i = 1; i != num_vertices; i++ ) {
+			glm::vec2 const p = polyline.vertices[ i ] * scale + offset;
+			raster_add_edge( edges, prev.x, prev.y, p.x, p.y, float( width ) );
+			prev = p;
+		}
+
+		// close contour
+		raster_add_edge( edges, prev.x, prev.y, first.x, first.y, float( width ) );
+	}
+
+	// -- Bin edges into bands, and rasterize bands
+
+	static constexpr int BAND_HEIGHT = 16;
+
+	le_path_raster_bins_t bins;
+	raster_bin_edges( bins, edges.data(), edges.size(), height, BAND_HEIGHT );
+
+	bool const even_odd = ( settings->fill_rule == le_path_api::raster_settings_t::eEvenOdd );
+
+	size_t const num_workers = le_jobs::get_worker_thread_count();
+	size_t const num_jobs    = num_workers ? std::min( size_t( bins.num_bands ), num_workers * 4 ) : 1;
+
+	std::vector<RasterizeJob> jobs( num_jobs );
+
+	for ( size_t i = 0; i != num_jobs; i++ ) {
+		jobs[ i ].bins       = &bins;
+		jobs[ i ].edges      = edges.data();
+		jobs[ i ].first_band = uint32_t( ( i * bins.num_bands ) / num_jobs );
+		jobs[ i ].last_band  = uint32_t( ( ( i + 1 ) * bins.num_bands ) / num_jobs );
+		jobs[ i ].even_odd   = even_odd;
+		jobs[ i ].pixels     = pixels;
+		jobs[ i ].width      = width;
+		jobs[ i ].height     = height;
+		jobs[ i ].row_stride = row_stride;
+	}
+
+	if ( num_jobs == 1 ) {
+		rasterize_job_fun( &jobs[ 0 ] );
+	} else {
+		std::vector<le_jobs::job_t> job_list;
+		job_list.reserve( num_jobs );
+
+		for ( auto &job : jobs ) {
+			job_list.push_back( { rasterize_job_fun, &job } );
+		}
+
+		le_jobs::counter_t *counter;
+		le_jobs::run_jobs( job_list.data(), uint32_t( job_list.size() ), &counter );
+		le_jobs::wait_for_counter_and_free( counter, 0 );
+	}
+}
+
 // ----------------------------------------------------------------------
 
 static void le_path_iterate_vertices_for_contour( le_path_o *self, size_t const &contour_index, le_path_api::contour_vertex_cb callback, void *user_data ) {
@@ -2334,6 +3379,14 @@ static void le_path_iterate_quad_beziers_for_contour( le_path_o *self, size_t co
 	}
 }
 
+// ----------------------------------------------------------------------
+// Returns index of the end vertex of the polyline segment which contains
+// distance `d`: the first vertex after the start vertex with a distance
+// larger than `d`, or the last vertex if there is no such vertex.
+static inline size_t polyline_find_segment_end( float const *distances, size_t num_distances, float d ) {
+	return size_t( std::upper_bound( distances + 1, distances + num_distances - 1, d ) - distances );
+}
+
 // ----------------------------------------------------------------------
 // Updates `result` to the vertex position on polyline
 // at normalized position `t`
@@ -2342,19 +3395,13 @@ static void le_polyline_get_at( Polyline const &polyline, float t, glm::vec2 *re
 	// -- Calculate unnormalised distance
 	float d = t * float( polyline.total_distance );
 
-	// find the first element in polyline which has a position larger than pos
-
-	size_t       a = 0, b = 1;
 	size_t const n = polyline.distances.size();
 
 	assert( n >= 2 ); // we must have at least two elements for this to work.
 
-	for ( ; b < n - 1; ++a, ++b ) {
-		if ( polyline.distances[ b ] > d ) {
-			// find the second distance which is larger than our test distance
-			break;
-		}
-	}
+	// find the first element in polyline which has a position larger than pos
+	size_t const b = polyline_find_segment_end( polyline.distances.data(), n, d );
+	size_t const a = b - 1;
 
 	assert( b < n ); // b must not overshoot.
 
@@ -2369,6 +3416,109 @@ static void le_polyline_get_at( Polyline const &polyline, float t, glm::vec2 *re
 	*result = start_vertex + scalar * ( end_vertex - start_vertex );
 }
 
+// ----------------------------------------------------------------------
+// Updates `results` to vertex positions on polyline at normalized positions `t`.
+//
+// If `t` is sorted in ascending order, segments are found in one linear sweep
+// over the polyline, which means that sampling k positions on a polyline with
+// n vertices costs O(n + k). Any position which is smaller than its predecessor
+// is found via binary search, so that unsorted positions still give correct
+// results.
+//
+// Positions are processed four at a time: we first find the segment for each
+// position, and then interpolate all four positions in one go.
+static void le_polyline_get_at_many( Polyline const &polyline, float const *t, size_t num_t, glm::vec2 *results ) {
+
+	size_t const n = polyline.distances.size();
+
+	assert( n >= 2 ); // we must have at least two elements for this to work.
+
+	float const *const     distances      = polyline.distances.data();
+	glm::vec2 const *const vertices       = polyline.vertices.data();
+	float const            total_distance = float( polyline.total_distance );
+
+	size_t b = 1; // end vertex of current segment
+
+	for ( size_t i = 0; i < num_t; i += 4 ) {
+
+		size_t const num_lanes = std::min( size_t( 4 ), num_t - i );
+
+		// Gather segment data for each lane - unused lanes repeat the first lane.
+
+		alignas( 16 ) float d[ 4 ];
+		alignas( 16 ) float dist_start[ 4 ];
+		alignas( 16 ) float dist_end[ 4 ];
+		alignas( 16 ) float start_x[ 4 ];
+		alignas( 16 ) float start_y[ 4 ];
+		alignas( 16 ) float end_x[ 4 ];
+		alignas( 16 ) float end_y[ 4 ];
+
+		for ( size_t j = 0; j != 4; j++ ) {
+
+			if ( j < num_lanes ) {
+
+				d[ j ] = t[ i + j ] * total_distance;
+
+				if ( d[ j ] < distances[ b - 1 ] ) {
+					// position is not sorted - we must search from the start.
+					b = polyline_find_segment_end( distances, n, d[ j ] );
+				} else {
+					while ( b < n - 1 && distances[ b ] <= d[ j ] ) {
+						++b;
+					}
+				}
+
+				dist_start[ j ] = distances[ b - 1 ];
+				dist_end[ j ]   = distances[ b ];
+				start_x[ j ]    = vertices[ b - 1 ].x;
+				start_y[ j ]    = vertices[ b - 1 ].y;
+				end_x[ j ]      = vertices[ b ].x;
+				end_y[ j ]      = vertices[ b ].y;
+			} else {
+				d[ j ]          = d[ 0 ];
+				dist_start[ j ] = dist_start[ 0 ];
+				dist_end[ j ]   = dist_end[ 0 ];
+				start_x[ j ]    = start_x[ 0 ];
+				start_y[ j ]    = start_y[ 0 ];
+				end_x[ j ]      = end_x[ 0 ];
+				end_y[ j ]      = end_y[ 0 ];
+			}
+		}
+
+		// Interpolate - this is the same calculation as in le_polyline_get_at,
+		// for four lanes at a time.
+
+		alignas( 16 ) float xy[ 8 ]; // interleaved x,y for each lane
+
+#ifdef LE_PATH_FLATTEN_BATCH_USE_SSE2
+		__m128 const ds = _mm_load_ps( dist_start );
+		__m128 const de = _mm_load_ps( dist_end );
+		__m128 const dc = _mm_min_ps( _mm_max_ps( _mm_load_ps( d ), ds ), de );
+
+		__m128 scalar = _mm_div_ps( _mm_sub_ps( dc, ds ), _mm_sub_ps( de, ds ) );
+		scalar        = _mm_min_ps( _mm_max_ps( scalar, _mm_setzero_ps() ), _mm_set1_ps( 1.f ) );
+
+		__m128 const x0 = _mm_load_ps( start_x );
+		__m128 const y0 = _mm_load_ps( start_y );
+		__m128 const x  = _mm_add_ps( x0, _mm_mul_ps( scalar, _mm_sub_ps( _mm_load_ps( end_x ), x0 ) ) );
+		__m128 const y  = _mm_add_ps( y0, _mm_mul_ps( scalar, _mm_sub_ps( _mm_load_ps( end_y ), y0 ) ) );
+
+		_mm_store_ps( xy, _mm_unpacklo_ps( x, y ) );
+		_mm_store_ps( xy + 4, _mm_unpackhi_ps( x, y ) );
+#else
+		for ( size_t j = 0; j != 4; j++ ) {
+			float const scalar = map( d[ j ], dist_start[ j ], dist_end[ j ], 0.f, 1.f );
+			xy[ 2 * j + 0 ]    = start_x[ j ] + scalar * ( end_x[ j ] - start_x[ j ] );
+			xy[ 2 * j + 1 ]    = start_y[ j ] + scalar * ( end_y[ j ] - start_y[ j ] );
+		}
+#endif
+
+		for ( size_t j = 0; j != num_lanes; j++ ) {
+			results[ i + j ] = { xy[ 2 * j ], xy[ 2 * j + 1 ] };
+		}
+	}
+}
+
 // ----------------------------------------------------------------------
 // return calculated position on polyline
 static void le_path_get_polyline_at_pos_interpolated( le_path_o *self, size_t const &polyline_index, float t, glm::vec2 *result ) {
@@ -2376,6 +3526,13 @@ static void le_path_get_polyline_at_pos_interpolated( le_path_o *self, size_t co
 	le_polyline_get_at( self->polylines[ polyline_index ], t, result );
 }
 
+// ----------------------------------------------------------------------
+// return calculated positions on polyline - see le_polyline_get_at_many
+static void le_path_get_polyline_at_positions_interpolated( le_path_o *self, size_t const &polyline_index, float const *t, size_t num_positions, glm::vec2 *results ) {
+	assert( polyline_index < self->polylines.size() );
+	le_polyline_get_at_many( self->polylines[ polyline_index ], t, num_positions, results );
+}
+
 // ----------------------------------------------------------------------
 
 static void le_polyline_resample( Polyline &polyline, float interval ) {
@@ -2400,19 +3557,24 @@ static void le_polyline_resample( Polyline &polyline, float interval ) {
 	poly_resampled.distances.reserve( n_segments + 1 );
 	poly_resampled.tangents.reserve( n_segments + 1 );
 
-	// Find first point
-	glm::vec2 vertex;
-	le_polyline_get_at( polyline, 0.f, &vertex );
-	trace_move_to( poly_resampled, vertex );
+	// Sample all points in one sweep - note that we must add an extra
+	// vertex at the end so that we capture the correct number of segments.
+	std::vector<float>     positions( n_segments + 1 );
+	std::vector<glm::vec2> samples( n_segments + 1 );
+
+	for ( size_t i = 0; i <= n_segments; ++i ) {
+		positions[ i ] = i * delta;
+	}
+
+	le_polyline_get_at_many( polyline, positions.data(), positions.size(), samples.data() );
+
+	trace_move_to( poly_resampled, samples[ 0 ] );
 
-	// Note that we must add an extra vertex at the end so that we
-	// capture the correct number of segments.
 	for ( size_t i = 1; i <= n_segments; ++i ) {
-		le_polyline_get_at( polyline, i * delta, &vertex );
 		// We use trace_line_to, because this will get us more accurate distance
 		// calculations - trace_line_to updates the distances as a side-effect,
 		// effectively redrawing the polyline as if it was a series of `line_to`s.
-		trace_line_to( poly_resampled, vertex );
+		trace_line_to( poly_resampled, samples[ i ] );
 	}
 
 	std::swap( polyline, poly_resampled );
@@ -2446,8 +3608,8 @@ static void le_path_resample( le_path_o *self, float interval ) {
 
 static void le_path_move_to( le_path_o *self, glm::vec2 const *p ) {
 	// move_to means a new subpath, unless the last command was a
-	self->contours.emplace_back(); // add empty subpath
-	self->contours.back().commands.emplace_back( PathCommand::eMoveTo, *p );
+	auto &contour = path_add_contour( self ); // add empty subpath
+	contour.commands.emplace_back( PathCommand::eMoveTo, *p );
 }
 
 // ----------------------------------------------------------------------
@@ -2463,65 +3625,6 @@ static void le_path_line_to( le_path_o *self, glm::vec2 const *p ) {
 
 // ----------------------------------------------------------------------
 
-// Fetch the current pen point by grabbing the previous target point
-// from the command stream.
-static glm::vec2 const *le_path_get_previous_p( le_path_o *self ) {
-	assert( !self->contours.empty() );                 // Subpath must exist
-	assert( !self->contours.back().commands.empty() ); // previous command must exist
-
-	glm::vec2 const *p = nullptr;
-
-	auto const &c = self->contours.back().commands.back(); // fetch last command
-
-	switch ( c.type ) {
-	case PathCommand::eMoveTo:        // fall-through
-	case PathCommand::eLineTo:        // fall-through
-	case PathCommand::eQuadBezierTo:  // fall-through
-	case PathCommand::eCubicBezierTo: // fall-through
-	case PathCommand::eArcTo:         // fall-through
-		p = &c.p;
-		break;
-	default:
-		// Error. Previous command must be one of above
-		fprintf( stderr, "Warning: Relative path instruction requires absolute position to be known. In %s:%i\n", __FILE__, __LINE__ );
-		break;
-	}
-
-	return p;
-}
-
-// ----------------------------------------------------------------------
-
-static void le_path_line_horiz_to( le_path_o *self, float px ) {
-	assert( !self->contours.empty() );                 // Subpath must exist
-	assert( !self->contours.back().commands.empty() ); // previous command must exist
-
-	auto p = le_path_get_previous_p( self );
-
-	if ( p ) {
-		glm::vec2 p2 = *p;
-		p2.x         = px;
-		le_path_line_to( self, &p2 );
-	}
-}
-
-// ----------------------------------------------------------------------
-
-static void le_path_line_vert_to( le_path_o *self, float py ) {
-	assert( !self->contours.empty() );                 // Subpath must exist
-	assert( !self->contours.back().commands.empty() ); // previous command must exist
-
-	auto p = le_path_get_previous_p( self );
-
-	if ( p ) {
-		glm::vec2 p2 = *p;
-		p2.y         = py;
-		le_path_line_to( self, &p2 );
-	}
-}
-
-// ----------------------------------------------------------------------
-
 static void le_path_quad_bezier_to( le_path_o *self, glm::vec2 const *p, glm::vec2 const *c1 ) {
 	assert( !self->contours.empty() ); //contour must exist
 	self->contours.back().commands.emplace_back( *p, PathCommand::Data::AsQuadBezier{ *c1 } );
@@ -2831,353 +3934,69 @@ static bool le_path_get_tangents_for_polyline( le_path_o *self, size_t const &po
 
 // ----------------------------------------------------------------------
 
-// Accumulates `*offset_local` into `*offset_total`.
-// Always returns true.
-static bool add_offsets( int *offset_local, int *offset_total ) {
-	( *offset_total ) += ( *offset_local );
-	return true;
-}
-
-// Returns true if string c may be interpreted as
-// a number,
-// If true,
-// + increases *offset by the count of characters forming the number.
-// + sets *f to value of parsed number.
-//
-static bool is_float_number( char const *c, int *offset, float *f ) {
-	if ( *c == 0 )
-		return false;
-
-	char *num_end;
-
-	*f = strtof( c, &num_end ); // num_end will point to one after last number character
-	*offset += ( num_end - c ); // add number of number characters to offset
-
-	return num_end != c; // if at least one number character was extracted, we were successful
-}
+// Receives commands from svg_path_parse, and streams them straight into the
+// command arrays of a path.
+struct SvgPathSink {
+	le_path_o                *self;
+	std::vector<PathCommand> *commands; // commands for current contour
 
-// Returns true if needle matches c.
-// Increases *offset by 1 if true.
-static bool is_character_match( char const needle, char const *c, int *offset ) {
-	if ( *c == 0 ) {
-		return false;
+	void move_to( glm::vec2 const &p ) {
+		commands = &path_add_contour( self ).commands;
+		commands->emplace_back( PathCommand::eMoveTo, p );
 	}
-	// ---------| invarant: c is not end of string
-
-	if ( *c == needle ) {
-		++( *offset );
-		return true;
-	} else {
-		return false;
+	void line_to( glm::vec2 const &p ) {
+		commands->emplace_back( PathCommand::eLineTo, p );
 	}
-}
-
-// Returns true if character is either 0, or 1.
-// Sets *value to `true` if character is 1,
-// Sets *value to `false` if character is 0.
-// Increases *offset by 1 if returns true
-static bool is_boolean_zero_or_one( char const *c, int *offset, bool *value ) {
-	if ( *c == 0 ) {
-		return false;
+	void quad_bezier_to( glm::vec2 const &p, glm::vec2 const &c1 ) {
+		commands->emplace_back( p, PathCommand::Data::AsQuadBezier{ c1 } );
 	}
-	// ---------| invarant: c is not end of string
-
-	if ( is_character_match( '0', c, offset ) ) {
-		*value = false;
-		return true;
+	void cubic_bezier_to( glm::vec2 const &p, glm::vec2 const &c1, glm::vec2 const &c2 ) {
+		commands->emplace_back( p, PathCommand::Data::AsCubicBezier{ c1, c2 } );
 	}
-	if ( is_character_match( '1', c, offset ) ) {
-		*value = true;
-		return true;
+	void arc_to( glm::vec2 const &p, glm::vec2 const &radii, float phi, bool large_arc, bool sweep ) {
+		commands->emplace_back( p, PathCommand::Data::AsArc{ radii, phi, large_arc, sweep } );
 	}
-
-	// ----------| invariant: nothing found.
-
-	*value = false;
-	return false;
-}
-
-// Returns true if what c points to may be interpreted as
-// whitespace, and sets offset to the count of whitespace
-// characters.
-static bool is_whitespace( char const *c, int *offset ) {
-	if ( *c == 0 ) {
-		return false;
-	}
-	// ---------| invarant: c is not end of string
-
-	bool found_whitespace = false;
-
-	// while c is one of possible whitespace characters
-	while ( *c == 0x20 || *c == 0x9 || *c == 0xD || *c == 0xA ) {
-		c++;
-		++( *offset );
-		found_whitespace = true;
+	void close_path() {
+		commands->emplace_back( PathCommand::eClosePath, glm::vec2{} );
 	}
+};
 
-	return found_whitespace;
-}
+// ----------------------------------------------------------------------
+// Parses SVG path data (the contents of the `d` attribute of an SVG `path`
+// element), and adds contours to path for all commands found. If `svg_len`
+// is 0, `svg` must be null-terminated.
+//
+// Returns false if path data contains an error - in which case all commands
+// before the error are still added to the path, as the SVG specification
+// asks for.
+static bool le_path_add_from_svg( le_path_o *self, char const *svg, size_t svg_len ) {
 
-// Returns true if c points to a coordinate pair.
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*coord` will hold the vertex defined by the coordinate pair
-static bool is_coordinate_pair( char const *c, int *offset, glm::vec2 *v ) {
-	if ( *c == 0 ) {
-		return false;
+	if ( svg_len == 0 ) {
+		svg_len = strlen( svg );
 	}
-	// ---------| invarant: c is not end of string
 
-	// we want the pattern:
+	char const *const end = svg + svg_len;
 
-	int local_offset = 0;
+	SvgPathSink sink{ self, nullptr };
 
-	return is_float_number( c, &local_offset, &v->x ) &&                 // note how offset is re-used
-	       is_character_match( ',', c + local_offset, &local_offset ) && // in subsequent tests, so that
-	       is_float_number( c + local_offset, &local_offset, &v->y ) &&  // each test begins at the previous offset
-	       add_offsets( &local_offset, offset );
-}
+	char const *parse_end = svg_path_parse( svg, end, sink );
 
-// Return true if string `c` can be evaluated as an 'm' instruction.
-// An 'm' instruction is a move_to instruction
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*p0` will hold the value of the target point
-static bool is_m_instruction( char const *c, int *offset, glm::vec2 *p0 ) {
-	if ( *c == 0 ) {
+	if ( parse_end != end ) {
+		// Input need not be null-terminated - we must not print past its end.
+		fprintf( stderr, "Warning: Could not parse SVG path data at offset %zu, near: '%.*s'. In %s:%i\n",
+		         size_t( parse_end - svg ), int( std::min<ptrdiff_t>( 16, end - parse_end ) ), parse_end, __FILE__, __LINE__ );
 		return false;
 	}
-	// ---------| invarant: c is not end of string
-
-	int local_offset = 0;
-
-	return is_character_match( 'M', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, p0 ) &&
-	       add_offsets( &local_offset, offset );
-}
-
-// Return true if string `c` can be evaluated as an 'l' instruction.
-// An 'l' instruction is a line_to instruction
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*p0` will hold the value of the target point
-static bool is_l_instruction( char const *c, int *offset, glm::vec2 *p0 ) {
-	if ( *c == 0 )
-		return false;
-
-	int local_offset = 0;
-
-	return is_character_match( 'L', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, p0 ) &&
-	       add_offsets( &local_offset, offset );
-}
-
-// Return true if string `c` can be evaluated as an 'h' instruction.
-// A 'h' instruction is a horizontal line_to instruction
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*px` will hold the value of the target point's x coordinate
-static bool is_h_instruction( char const *c, int *offset, float *px ) {
-	if ( *c == 0 )
-		return false;
-
-	int local_offset = 0;
-
-	return is_character_match( 'H', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_float_number( c + local_offset, &local_offset, px ) &&
-	       add_offsets( &local_offset, offset );
-}
-
-// Return true if string `c` can be evaluated as an 'l' instruction.
-// A 'v' instruction is a vertical line_to instruction
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*px` will hold the value of the target point's x coordinate
-static bool is_v_instruction( char const *c, int *offset, float *py ) {
-	if ( *c == 0 )
-		return false;
-
-	int local_offset = 0;
-
-	return is_character_match( 'V', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_float_number( c + local_offset, &local_offset, py ) &&
-	       add_offsets( &local_offset, offset );
-}
-
-// Return true if string `c` can be evaluated as a 'c' instruction.
-// A 'c' instruction is a cubic bezier instruction.
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*c1` will hold the value of control point 0
-// + `*c2` will hold the value of control point 1
-// + `*p1` will hold the value of the target point
-static bool is_c_instruction( char const *c, int *offset, glm::vec2 *c1, glm::vec2 *c2, glm::vec2 *p1 ) {
-	if ( *c == 0 )
-		return false;
-
-	int local_offset = 0;
-
-	return is_character_match( 'C', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, c1 ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, c2 ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, p1 ) &&
-	       add_offsets( &local_offset, offset );
-}
-
-// Return true if string `c` can be evaluated as a 'q' instruction.
-// A 'q' instruction is a quadratic bezier instruction.
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*c1` will hold the value of the control point
-// + `*p1` will hold the value of the target point
-static bool is_q_instruction( char const *c, int *offset, glm::vec2 *c1, glm::vec2 *p1 ) {
-	if ( *c == 0 )
-		return false;
 
-	int local_offset = 0;
-
-	return is_character_match( 'Q', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, c1 ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, p1 ) &&
-	       add_offsets( &local_offset, offset );
-}
-
-// Return true if string `c` can be evaluated as a 'a' instruction.
-// An 'a' instruction is an arc_to instruction
-// In case this method returns true,
-// + `*offset` will hold the count of characters from `c` spent on the instruction.
-// + `*radii` will hold the value of the radii
-// + `*x_axis_rotation` will hold the value of the x axis rotation of the ellipse arc
-// + `*large_arc_flag` will hold a flag indicating whether to trace the large arc(true), or the short arc(false)
-// + `*sweep_flag` will hold a flag indicating whether to trace the arc in negative direction (true), or in positive direction (false)
-// + `*p1` will hold the value of the target point
-static bool is_a_instruction( char const *c, int *offset, glm::vec2 *radii, float *x_axis_rotation, bool *large_arc_flag, bool *sweep_flag, glm::vec2 *p1 ) {
-	if ( *c == 0 )
-		return false;
-
-	int local_offset = 0;
-
-	return is_character_match( 'A', c, &local_offset ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, radii ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_float_number( c + local_offset, &local_offset, x_axis_rotation ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_boolean_zero_or_one( c + local_offset, &local_offset, large_arc_flag ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_boolean_zero_or_one( c + local_offset, &local_offset, sweep_flag ) &&
-	       is_whitespace( c + local_offset, &local_offset ) &&
-	       is_coordinate_pair( c + local_offset, &local_offset, p1 ) &&
-	       add_offsets( &local_offset, offset );
+	return true;
 }
 
 // ----------------------------------------------------------------------
-// Parse string `svg` for simplified SVG instructions and adds paths
-// based on instructions found.
-//
-// Rules for similified SVG:
-//
-// - All coordinates must be absolute
-// - Commands must be repeated
-// - Allowed instruction tokens are:
-//	 - 'M', with params {  p        } (moveto),
-//	 - 'L', with params {  p        } (lineto),
-//	 - 'C', with params { c0, c1, p } (cubic bezier to),
-//	 - 'Q', with params { c0,  p,   } (quad bezier to),
-//	 - 'Z', with params {           } (close path)
-//   - 'A', with params { r, x-rot, large-arc-flag, sweep-flag, p } (arc to)
-//
-// You may set up Inkscape to output simplified SVG via:
-// `Edit -> Preferences -> SVG Output ->
-// (tick) Force Repeat Commands, Path string format (select: Absolute)`
-//
+// Simplified SVG is a subset of SVG path data - we keep this for
+// compatibility, and use the full parser.
 static void le_path_add_from_simplified_svg( le_path_o *self, char const *svg ) {
-
-	char const *c = svg;
-
-	glm::vec2 p                 = {};
-	glm::vec2 c1                = {};
-	glm::vec2 c2                = {};
-	glm::vec2 radii             = {};
-	float     arc_axis_rotation = {};
-	bool      arc_large{};
-	bool      arc_sweep{};
-
-	for ( ; *c != 0; ) // We test for the \0 character, end of c-string
-	{
-
-		int offset = 0;
-
-		if ( is_m_instruction( c, &offset, &p ) ) {
-			// moveto event
-			le_path_move_to( self, &p );
-			c += offset;
-			continue;
-		}
-		if ( is_l_instruction( c, &offset, &p ) ) {
-			// lineto event
-			le_path_line_to( self, &p );
-			c += offset;
-			continue;
-		}
-		if ( is_h_instruction( c, &offset, &p.x ) ) {
-			// lineto event
-			le_path_line_horiz_to( self, p.x );
-			c += offset;
-			continue;
-		}
-		if ( is_v_instruction( c, &offset, &p.y ) ) {
-			// lineto event
-			le_path_line_vert_to( self, p.y );
-			c += offset;
-			continue;
-		}
-		if ( is_c_instruction( c, &offset, &p, &c1, &c2 ) ) {
-			// cubic bezier event
-			le_path_cubic_bezier_to( self, &c2, &p, &c1 ); // Note that end vertex is p2 from SVG,
-			                                               // as SVG has target vertex as last vertex
-			c += offset;
-			continue;
-		}
-		if ( is_q_instruction( c, &offset, &p, &c1 ) ) {
-			// quadratic bezier event
-			le_path_quad_bezier_to( self, &c1, &p ); // Note that target vertex is p1 from SVG,
-			                                         // as SVG has target vertex as last vertex
-			c += offset;
-			continue;
-		}
-		if ( is_a_instruction( c, &offset, &radii, &arc_axis_rotation, &arc_large, &arc_sweep, &c1 ) ) {
-			// arc event
-			le_path_arc_to( self, &c1, &radii, arc_axis_rotation, arc_large, arc_sweep ); // Note that target vertex is p1 from SVG,
-
-			c += offset;
-			continue;
-		}
-		if ( is_character_match( 'Z', c, &offset ) ) {
-			// close path event.
-			le_path_close_path( self );
-			c += offset;
-			continue;
-		}
-
-		// ----------| Invariant: None of the cases above did match
-
-		// If none of the above cases match, the current character is
-		// invalid, or does not contribute. Most likely it is a white-
-		// space character.
-
-		++c; // Ignore current character.
-	}
-};
+	le_path_add_from_svg( self, svg, 0 );
+}
 
 // ----------------------------------------------------------------------
 
@@ -3197,21 +4016,33 @@ LE_MODULE_REGISTER_IMPL( le_path, api ) {
 	le_path_i.ellipse = le_path_ellipse;
 
 	le_path_i.add_from_simplified_svg = le_path_add_from_simplified_svg;
+	le_path_i.add_from_svg            = le_path_add_from_svg;
 
-	le_path_i.get_num_contours                 = le_path_get_num_contours;
-	le_path_i.get_num_polylines                = le_path_get_num_polylines;
-	le_path_i.get_vertices_for_polyline        = le_path_get_vertices_for_polyline;
-	le_path_i.get_tangents_for_polyline        = le_path_get_tangents_for_polyline;
-	le_path_i.get_polyline_at_pos_interpolated = le_path_get_polyline_at_pos_interpolated;
+	le_path_i.get_num_contours                       = le_path_get_num_contours;
+	le_path_i.get_num_polylines                      = le_path_get_num_polylines;
+	le_path_i.get_vertices_for_polyline              = le_path_get_vertices_for_polyline;
+	le_path_i.get_tangents_for_polyline              = le_path_get_tangents_for_polyline;
+	le_path_i.get_polyline_at_pos_interpolated       = le_path_get_polyline_at_pos_interpolated;
+	le_path_i.get_polyline_at_positions_interpolated = le_path_get_polyline_at_positions_interpolated;
 
 	le_path_i.generate_offset_outline_for_contour = le_path_generate_offset_outline_for_contour;
 	le_path_i.tessellate_thick_contour            = le_path_tessellate_thick_contour;
+	le_path_i.tessellate_many                     = le_path_tessellate_many;
+	le_path_i.rasterize                           = le_path_rasterize;
+	le_path_i.get_offset_outline_for_contour      = le_path_get_offset_outline_for_contour;
+	le_path_i.get_thick_contour_triangles         = le_path_get_thick_contour_triangles;
 
 	le_path_i.iterate_vertices_for_contour     = le_path_iterate_vertices_for_contour;
 	le_path_i.iterate_quad_beziers_for_contour = le_path_iterate_quad_beziers_for_contour;
 
-	le_path_i.trace    = le_path_trace_path;
-	le_path_i.flatten  = le_path_flatten_path;
-	le_path_i.resample = le_path_resample;
-	le_path_i.clear    = le_path_clear;
+	le_path_i.trace        = le_path_trace_path;
+	le_path_i.flatten      = le_path_flatten_path;
+	le_path_i.flatten_many = le_path_flatten_paths;
+	le_path_i.resample     = le_path_resample;
+	le_path_i.clear        = le_path_clear;
+	le_path_i.get_hash     = le_path_get_hash;
+
+	le_path_i.get_cache_stats    = le_path_get_cache_stats;
+	le_path_i.set_cache_capacity = le_path_set_cache_capacity;
+	le_path_i.clear_cache        = le_path_clear_cache;
 }
@@ -35,6 +35,41 @@ struct le_path_api {
 		LineCapType  line_cap_type;
 	};
 
+	struct tessellation_settings_t {
+		enum Mode : uint32_t {
+			eFill = 0, // fill all contours of path
+			eStroke,   // stroke each contour of path
+		};
+		Mode               mode;
+		float              fill_tolerance; // used for eFill: max distance from curve to polyline approximating it
+		uint64_t           fill_options;   // used for eFill: le_tessellator options, e.g. winding mode
+		stroke_attribute_t stroke;         // used for eStroke
+	};
+
+	struct raster_settings_t {
+		enum FillRule : uint32_t { // names for these follow svg standard: https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/fill-rule
+			eNonZero = 0,
+			eEvenOdd,
+		};
+		FillRule fill_rule;
+		float    tolerance; // max distance from curve to polyline approximating it, in pixels
+		float    scale;     // pixels per path unit
+		float    offset_x;  // position of path origin in bitmap, in pixels
+		float    offset_y;
+	};
+
+	// Must return pointer to memory for `num_vertices` vertices, or nullptr on failure.
+	typedef glm::vec2* vertex_buffer_alloc_cb( void* user_data, size_t num_vertices );
+
+	struct cache_stats_t {
+		uint64_t hits;              // number of lookups which found geometry in cache
+		uint64_t misses;            // number of lookups which had to generate geometry
+		uint64_t evictions;         // number of entries evicted to stay within capacity
+		uint64_t num_entries;       // number of entries currently held by cache
+		uint64_t size_in_bytes;     // approximate memory used by entries currently held by cache
+		uint64_t capacity_in_bytes; // maximum memory cache may use, 0 if cache is disabled
+	};
+
     typedef void contour_vertex_cb (void *user_data, glm::vec2 const& p);
     typedef void contour_quad_bezier_cb(void *user_data, glm::vec2 const& p0, glm::vec2 const& p1, glm::vec2 const& c);
 
@@ -58,11 +93,17 @@ struct le_path_api {
 		// Macro - style commands which resolve to a series of subcommands from above
 		void        (* ellipse                   ) ( le_path_o* self, glm::vec2 const* centre, float r_x, float r_y );
 
-		void        (* add_from_simplified_svg   ) ( le_path_o* self, char const* svg );
+		void        (* add_from_simplified_svg   ) ( le_path_o* self, char const* svg ); // same as add_from_svg, kept for compatibility
+
+        // Parses SVG path data (contents of the `d` attribute of an svg `path` element) - all commands, absolute
+        // and relative, are supported. If `svg_len` is 0, `svg` must be null-terminated. Returns false on error,
+        // in which case any commands before the error have been added to the path.
+		bool        (* add_from_svg              ) ( le_path_o* self, char const* svg, size_t svg_len );
 
         // Generate and cache polylines for each contour per path
 		void        (* trace                     ) ( le_path_o* self, size_t resolution );
 		void        (* flatten                   ) ( le_path_o* self, float tolerance);
+		void        (* flatten_many              ) ( le_path_o* const* paths, size_t num_paths, float tolerance); // same as flatten, but processes curves of all paths as one batch
 		void        (* resample                  ) ( le_path_o* self, float interval);
 
         // Always updates `max_count_outline_[l|r] with the number of used vertices for l and r outline.
@@ -75,6 +116,28 @@ struct le_path_api {
 		/// Note: Upon return, `*num_vertices` will contain number of vertices needed to describe tessellated contour triangles.
 		bool        (* tessellate_thick_contour)(le_path_o* self, size_t contour_index, struct stroke_attribute_t const * stroke_attributes, glm::vec2* vertices, size_t* num_vertices);
 
+		/// Single-pass versions of generate_offset_outline_for_contour, and tessellate_thick_contour: these generate
+		/// vertices into storage owned by the path, and return a pointer to, and the number of generated vertices.
+		/// Vertices stay valid until the next call to either of these two functions on the same path, or until the
+		/// path is cleared, or destroyed.
+		void        (* get_offset_outline_for_contour )(le_path_o* self, size_t contour_index, float line_weight, float tolerance, glm::vec2 const** outline_l, size_t* num_vertices_l, glm::vec2 const** outline_r, size_t* num_vertices_r);
+		void        (* get_thick_contour_triangles    )(le_path_o* self, size_t contour_index, struct stroke_attribute_t const * stroke_attributes, glm::vec2 const** vertices, size_t* num_vertices);
+
+		/// Tessellates all `paths` into triangles, spreading work across le_jobs worker threads if the job system was
+		/// initialised. Paths must be distinct. Triangle vertices for all paths are concatenated into one buffer, which
+		/// is requested via a single call to `alloc_cb` once the total number of vertices is known. Vertices for path i
+		/// are found at [path_offsets[i] .. path_offsets[i+1]) - `path_offsets` must have space for `num_paths + 1` elements.
+		/// Returns `false` if `alloc_cb` returned nullptr.
+		bool        (* tessellate_many )(le_path_o* const* paths, size_t num_paths, struct tessellation_settings_t const* settings, vertex_buffer_alloc_cb alloc_cb, void* user_data, size_t* path_offsets);
+
+		/// Rasterizes all contours of path as filled, anti-aliased shapes on the cpu. Overwrites each of the `width` x `height`
+		/// pixels in `pixels` with its 8-bit coverage. Rows are `row_stride` bytes apart. Flattens the path, which updates
+		/// its polylines. Bands of rows are rasterized in parallel if the le_jobs job system was initialised.
+		void        (* rasterize )(le_path_o* self, struct raster_settings_t const* settings, uint8_t* pixels, uint32_t width, uint32_t height, size_t row_stride);
+
+        // Hash over all path commands - paths built from the same commands have the same hash.
+        uint64_t    (* get_hash                  ) ( le_path_o* self );
+
         size_t      (* get_num_contours          ) ( le_path_o* self );
 		size_t      (* get_num_polylines         ) ( le_path_o* self );
 
@@ -89,8 +152,22 @@ struct le_path_api {
 
 		void        (* get_polyline_at_pos_interpolated ) ( le_path_o* self, size_t const &polyline_index, float normPos, glm::vec2* result);
 
+        // Samples `num_positions` normalized positions in one go, and writes one vertex per position into `results`.
+        // Sorting `norm_positions` in ascending order is much faster: sorted positions are found in a single sweep
+        // over the polyline, while any position smaller than its predecessor needs a binary search.
+		void        (* get_polyline_at_positions_interpolated ) ( le_path_o* self, size_t const &polyline_index, float const* norm_positions, size_t num_positions, glm::vec2* results);
+
         void        (* iterate_vertices_for_contour)(le_path_o* self, size_t const & contour_index, contour_vertex_cb callback, void* user_data);
         void        (* iterate_quad_beziers_for_contour)(le_path_o* self, size_t const & contour_index, contour_quad_bezier_cb callback, void* user_data);
+
+        // Geometry generated by trace, flatten, generate_offset_outline_for_contour, and
+        // tessellate_thick_contour is cached, keyed by a hash of path commands, and
+        // parameters. The cache is shared by all paths, and evicts least recently used
+        // entries once it would grow beyond its capacity. Set capacity to 0 to disable it.
+        // Count-then-fill calls with unchanged arguments count as a single cache query.
+        void        (* get_cache_stats           ) ( cache_stats_t* stats );
+        void        (* set_cache_capacity        ) ( size_t capacity_in_bytes );
+        void        (* clear_cache               ) ( ); // drops all entries, and resets counters
 		
 	};
 
@@ -163,6 +240,11 @@ class Path : NoCopy, NoMove {
 		return *this;
 	}
 
+	Path &addFromSvg( char const *svg, size_t svg_len = 0 ) {
+		le_path::le_path_i.add_from_svg( self, svg, svg_len );
+		return *this;
+	}
+
 	void hobby() {
 		le_path::le_path_i.hobby( self );
 	}
@@ -203,6 +285,14 @@ class Path : NoCopy, NoMove {
 		le_path::le_path_i.get_polyline_at_pos_interpolated( self, polylineIndex, normalizedPos, vertex );
 	}
 
+	void getPolylineAtPositions( size_t const &polylineIndex, float const *normalizedPositions, size_t numPositions, glm::vec2 *vertices ) {
+		le_path::le_path_i.get_polyline_at_positions_interpolated( self, polylineIndex, normalizedPositions, numPositions, vertices );
+	}
+
+	void rasterize( le_path_api::raster_settings_t const &settings, uint8_t *pixels, uint32_t width, uint32_t height, size_t rowStride ) {
+		le_path::le_path_i.rasterize( self, &settings, pixels, width, height, rowStride );
+	}
+
 	void clear() {
 		le_path::le_path_i.clear( self );
 	}
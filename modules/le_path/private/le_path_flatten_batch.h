@@ -0,0 +1,252 @@
+#ifndef GUARD_le_path_flatten_batch_H
+#define GUARD_le_path_flatten_batch_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#	include <emmintrin.h>
+#	define LE_PATH_FLATTEN_BATCH_USE_SSE2
+#endif
+
+/*
+
+  Batch flattening of cubic bezier curves.
+
+  Curves are gathered into a structure of arrays, so that we can calculate
+  the number of line segments needed for all curves in one go, four curves
+  at a time, and then evaluate points on each curve, four points at a time.
+
+  The number of line segments per curve follows Wang's formula: a cubic
+  bezier curve with control points p0, c1, c2, p1 is approximated within
+  `tolerance` by n uniformly spaced segments, where
+
+      n = ceil( sqrt( 3/4 * max( |p0 - 2 c1 + c2|, |c1 - 2 c2 + p1| ) / tolerance ) )
+
+  Evaluation writes points, and first derivatives, at t = 1/n, 2/n, ... n/n
+  (the start point at t = 0 is not written, since it is the end point of
+  the previous segment) as interleaved x,y pairs, which means they can be
+  written directly into an array of glm::vec2.
+
+  We use SSE2 where available, since it is part of the x86-64 baseline, and
+  needs no extra compiler flags. All other targets use the scalar fallback,
+  which gives the same results.
+
+*/
+
+struct le_path_cubic_batch_t {
+	static constexpr uint32_t MAX_SEGMENTS_PER_CURVE = 1000; // upper bound, only reached if tolerance is tiny
+
+	std::vector<float>    p0_x;
+	std::vector<float>    p0_y;
+	std::vector<float>    c1_x;
+	std::vector<float>    c1_y;
+	std::vector<float>    c2_x;
+	std::vector<float>    c2_y;
+	std::vector<float>    p1_x;
+	std::vector<float>    p1_y;
+	std::vector<uint32_t> num_segments; // filled in by cubic_batch_calculate_num_segments
+
+	size_t size() const {
+		return p0_x.size();
+	}
+
+	// Keeps capacity, so that a batch may be re-used without allocating.
+	void clear() {
+		p0_x.clear();
+		p0_y.clear();
+		c1_x.clear();
+		c1_y.clear();
+		c2_x.clear();
+		c2_y.clear();
+		p1_x.clear();
+		p1_y.clear();
+		num_segments.clear();
+	}
+
+	// Returns index of added curve.
+	size_t push_back( float p0x, float p0y, float c1x, float c1y, float c2x, float c2y, float p1x, float p1y ) {
+		p0_x.push_back( p0x );
+		p0_y.push_back( p0y );
+		c1_x.push_back( c1x );
+		c1_y.push_back( c1y );
+		c2_x.push_back( c2x );
+		c2_y.push_back( c2y );
+		p1_x.push_back( p1x );
+		p1_y.push_back( p1y );
+		return p0_x.size() - 1;
+	}
+};
+
+// ----------------------------------------------------------------------
+
+static inline uint32_t cubic_batch_num_segments_scalar( float p0x, float p0y, float c1x, float c1y, float c2x, float c2y, float p1x, float p1y, float inv_tolerance ) {
+
+	float const dx_0 = p0x - 2.f * c1x + c2x;
+	float const dy_0 = p0y - 2.f * c1y + c2y;
+	float const dx_1 = c1x - 2.f * c2x + p1x;
+	float const dy_1 = c1y - 2.f * c2y + p1y;
+
+	float const dd = sqrtf( fmaxf( dx_0 * dx_0 + dy_0 * dy_0, dx_1 * dx_1 + dy_1 * dy_1 ) );
+	float const n  = ceilf( sqrtf( 0.75f * dd * inv_tolerance ) );
+
+	// Note that the comparison is written so that NaN ends up as 1 segment
+	if ( !( n >= 1.f ) ) {
+		return 1;
+	}
+	if ( n >= float( le_path_cubic_batch_t::MAX_SEGMENTS_PER_CURVE ) ) {
+		return le_path_cubic_batch_t::MAX_SEGMENTS_PER_CURVE;
+	}
+	return uint32_t( n );
+}
+
+// ----------------------------------------------------------------------
+// Calculates number of line segments for each curve in batch so that no
+// segment deviates from its curve by more than `tolerance`.
+static inline void cubic_batch_calculate_num_segments( le_path_cubic_batch_t &batch, float tolerance ) {
+
+	size_t const count = batch.size();
+	batch.num_segments.resize( count );
+
+	float const inv_tolerance = 1.f / tolerance;
+
+	size_t i = 0;
+
+#ifdef LE_PATH_FLATTEN_BATCH_USE_SSE2
+	__m128 const two       = _mm_set1_ps( 2.f );
+	__m128 const scale     = _mm_set1_ps( 0.75f * inv_tolerance );
+	__m128 const one       = _mm_set1_ps( 1.f );
+	__m128 const max_count = _mm_set1_ps( float( le_path_cubic_batch_t::MAX_SEGMENTS_PER_CURVE ) );
+
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128 const p0x = _mm_loadu_ps( batch.p0_x.data() + i );
+		__m128 const p0y = _mm_loadu_ps( batch.p0_y.data() + i );
+		__m128 const c1x = _mm_loadu_ps( batch.c1_x.data() + i );
+		__m128 const c1y = _mm_loadu_ps( batch.c1_y.data() + i );
+		__m128 const c2x = _mm_loadu_ps( batch.c2_x.data() + i );
+		__m128 const c2y = _mm_loadu_ps( batch.c2_y.data() + i );
+		__m128 const p1x = _mm_loadu_ps( batch.p1_x.data() + i );
+		__m128 const p1y = _mm_loadu_ps( batch.p1_y.data() + i );
+
+		__m128 const dx_0 = _mm_add_ps( _mm_sub_ps( p0x, _mm_mul_ps( two, c1x ) ), c2x );
+		__m128 const dy_0 = _mm_add_ps( _mm_sub_ps( p0y, _mm_mul_ps( two, c1y ) ), c2y );
+		__m128 const dx_1 = _mm_add_ps( _mm_sub_ps( c1x, _mm_mul_ps( two, c2x ) ), p1x );
+		__m128 const dy_1 = _mm_add_ps( _mm_sub_ps( c1y, _mm_mul_ps( two, c2y ) ), p1y );
+
+		__m128 const len_sq_0 = _mm_add_ps( _mm_mul_ps( dx_0, dx_0 ), _mm_mul_ps( dy_0, dy_0 ) );
+		__m128 const len_sq_1 = _mm_add_ps( _mm_mul_ps( dx_1, dx_1 ), _mm_mul_ps( dy_1, dy_1 ) );
+
+		__m128 const dd = _mm_sqrt_ps( _mm_max_ps( len_sq_0, len_sq_1 ) );
+		__m128       n  = _mm_sqrt_ps( _mm_mul_ps( dd, scale ) );
+
+		// Clamp to [1..max_count] before conversion, so that conversion can't
+		// overflow - _mm_max_ps returns its second operand if n is NaN.
+		n = _mm_min_ps( _mm_max_ps( n, one ), max_count );
+
+		// SSE2 has no ceil: truncate, then add one wherever truncation rounded down.
+		__m128i const n_trunc   = _mm_cvttps_epi32( n );
+		__m128i const rounded   = _mm_castps_si128( _mm_cmplt_ps( _mm_cvtepi32_ps( n_trunc ), n ) ); // -1 where rounded down, 0 otherwise
+		__m128i const n_ceiling = _mm_sub_epi32( n_trunc, rounded );
+
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( batch.num_segments.data() + i ), n_ceiling );
+	}
+#endif
+
+	for ( ; i < count; i++ ) {
+		batch.num_segments[ i ] = cubic_batch_num_segments_scalar(
+		    batch.p0_x[ i ], batch.p0_y[ i ],
+		    batch.c1_x[ i ], batch.c1_y[ i ],
+		    batch.c2_x[ i ], batch.c2_y[ i ],
+		    batch.p1_x[ i ], batch.p1_y[ i ], inv_tolerance );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Evaluates curve at `curve_index` at t = 1/n .. n/n, where n is the number of
+// segments calculated for this curve.
+//
+// Writes n interleaved x,y pairs of points to `out_points`, and n interleaved
+// x,y pairs of first derivatives to `out_derivatives`. Both must have space
+// for 2*n floats. The last point is always exactly the curve's end point.
+static inline void cubic_batch_evaluate_curve( le_path_cubic_batch_t const &batch, size_t curve_index, float *out_points, float *out_derivatives ) {
+
+	uint32_t const n = batch.num_segments[ curve_index ];
+
+	float const p0x = batch.p0_x[ curve_index ];
+	float const p0y = batch.p0_y[ curve_index ];
+	float const c1x = batch.c1_x[ curve_index ];
+	float const c1y = batch.c1_y[ curve_index ];
+	float const c2x = batch.c2_x[ curve_index ];
+	float const c2y = batch.c2_y[ curve_index ];
+	float const p1x = batch.p1_x[ curve_index ];
+	float const p1y = batch.p1_y[ curve_index ];
+
+	// Power basis: B(t) = ((a t + b) t + c) t + p0, B'(t) = (3a t + 2b) t + c
+
+	float const ax = 3.f * ( c1x - c2x ) + p1x - p0x;
+	float const ay = 3.f * ( c1y - c2y ) + p1y - p0y;
+	float const bx = 3.f * ( p0x - 2.f * c1x + c2x );
+	float const by = 3.f * ( p0y - 2.f * c1y + c2y );
+	float const cx = 3.f * ( c1x - p0x );
+	float const cy = 3.f * ( c1y - p0y );
+
+	float const dt = 1.f / float( n );
+
+	uint32_t i = 0;
+
+#ifdef LE_PATH_FLATTEN_BATCH_USE_SSE2
+	__m128 const v_ax  = _mm_set1_ps( ax );
+	__m128 const v_ay  = _mm_set1_ps( ay );
+	__m128 const v_bx  = _mm_set1_ps( bx );
+	__m128 const v_by  = _mm_set1_ps( by );
+	__m128 const v_cx  = _mm_set1_ps( cx );
+	__m128 const v_cy  = _mm_set1_ps( cy );
+	__m128 const v_p0x = _mm_set1_ps( p0x );
+	__m128 const v_p0y = _mm_set1_ps( p0y );
+	__m128 const v_3ax = _mm_set1_ps( 3.f * ax );
+	__m128 const v_3ay = _mm_set1_ps( 3.f * ay );
+	__m128 const v_2bx = _mm_set1_ps( 2.f * bx );
+	__m128 const v_2by = _mm_set1_ps( 2.f * by );
+	__m128 const v_dt  = _mm_set1_ps( dt );
+
+	__m128i       v_i    = _mm_setr_epi32( 1, 2, 3, 4 );
+	__m128i const v_four = _mm_set1_epi32( 4 );
+
+	for ( ; i + 4 <= n; i += 4 ) {
+		__m128 const t = _mm_mul_ps( _mm_cvtepi32_ps( v_i ), v_dt );
+
+		__m128 const x = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( v_ax, t ), v_bx ), t ), v_cx ), t ), v_p0x );
+		__m128 const y = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( v_ay, t ), v_by ), t ), v_cy ), t ), v_p0y );
+
+		__m128 const tx = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( v_3ax, t ), v_2bx ), t ), v_cx );
+		__m128 const ty = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( v_3ay, t ), v_2by ), t ), v_cy );
+
+		// interleave into x0 y0 x1 y1 | x2 y2 x3 y3
+		_mm_storeu_ps( out_points + 2 * i, _mm_unpacklo_ps( x, y ) );
+		_mm_storeu_ps( out_points + 2 * i + 4, _mm_unpackhi_ps( x, y ) );
+		_mm_storeu_ps( out_derivatives + 2 * i, _mm_unpacklo_ps( tx, ty ) );
+		_mm_storeu_ps( out_derivatives + 2 * i + 4, _mm_unpackhi_ps( tx, ty ) );
+
+		v_i = _mm_add_epi32( v_i, v_four );
+	}
+#endif
+
+	for ( ; i < n; i++ ) {
+		float const t = float( i + 1 ) * dt;
+
+		out_points[ 2 * i + 0 ] = ( ( ax * t + bx ) * t + cx ) * t + p0x;
+		out_points[ 2 * i + 1 ] = ( ( ay * t + by ) * t + cy ) * t + p0y;
+
+		out_derivatives[ 2 * i + 0 ] = ( 3.f * ax * t + 2.f * bx ) * t + cx;
+		out_derivatives[ 2 * i + 1 ] = ( 3.f * ay * t + 2.f * by ) * t + cy;
+	}
+
+	// Evaluating the polynomial at t=1 may be off by a few ulp - we want the
+	// curve to end exactly at its end point, so that closed paths stay closed.
+	out_points[ 2 * ( n - 1 ) + 0 ] = p1x;
+	out_points[ 2 * ( n - 1 ) + 1 ] = p1y;
+}
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef GUARD_le_path_rasterizer_H
+#define GUARD_le_path_rasterizer_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#	include <emmintrin.h>
+#	define LE_PATH_RASTERIZER_USE_SSE2
+#endif
+
+/*
+
+  Anti-aliased coverage rasterizer.
+
+  We rasterize line segments ("edges") by accumulating, for each pixel, the
+  signed area which edges cover within that pixel, and to its right. A
+  running sum over each row then gives the winding number of each pixel,
+  weighted by how much of the pixel is covered - which is the exact
+  coverage for pixels which are crossed by at most one edge, and a close
+  approximation otherwise.
+
+  Accumulated values w are turned into coverage following the fill rule:
+
+      non-zero:  min( |w|, 1 )
+      even-odd:  1 - | 1 - ( |w| mod 2 ) |
+
+  Rows are processed in bands, so that the accumulation buffer stays small,
+  and so that bands may be rasterized in parallel: edges are binned by the
+  bands which they touch, and each band is rasterized independently.
+
+  Edges must be given in pixel coordinates, and must already be clipped to
+  the left, and right borders of the bitmap - see `raster_add_edge`.
+  Vertical clipping happens per band.
+
+  Resolving accumulated rows into 8-bit coverage uses SSE2 where available,
+  four pixels at a time - the prefix sum over each group of four pixels is
+  calculated with two shifted adds. All other targets use a scalar
+  fallback.
+
+*/
+
+struct le_path_raster_edge_t {
+	float x0;
+	float y0;
+	float x1;
+	float y1;
+};
+
+// ----------------------------------------------------------------------
+// Adds edge from (x0,y0) to (x1,y1), clipped horizontally to [0, width].
+//
+// Any part of the edge left of the bitmap is projected onto its left border,
+// since it still contributes to the winding number of every pixel in the
+// rows it crosses. Any part right of the bitmap is dropped, since it only
+// contributes to pixels which we never see. Horizontal edges contribute
+// nothing, and are dropped, too - and so are edges with non-finite
+// coordinates, which have no meaningful coverage.
+static inline void raster_add_edge( std::vector<le_path_raster_edge_t> &edges, float x0, float y0, float x1, float y1, float width ) {
+
+	if ( y0 == y1 || !isfinite( x0 ) || !isfinite( y0 ) || !isfinite( x1 ) || !isfinite( y1 ) ) {
+		return;
+	}
+
+	// Split edge where it crosses `x`, calling `fun` for each part.
+	auto split_at_x = []( float x, float x0, float y0, float x1, float y1, auto &&fun ) {
+		if ( ( x0 < x && x1 > x ) || ( x0 > x && x1 < x ) ) {
+			float const y = y0 + ( y1 - y0 ) * ( ( x - x0 ) / ( x1 - x0 ) );
+			fun( x0, y0, x, y );
+			fun( x, y, x1, y1 );
+		} else {
+			fun( x0, y0, x1, y1 );
+		}
+	};
+
+	split_at_x( 0.f, x0, y0, x1, y1, [ & ]( float ax, float ay, float bx, float by ) {
+		split_at_x( width, ax, ay, bx, by, [ & ]( float cx, float cy, float dx, float dy ) {
+			if ( cy == dy || ( cx >= width && dx >= width ) ) {
+				return;
+			}
+			edges.push_back( { std::max( cx, 0.f ), cy, std::max( dx, 0.f ), dy } );
+		} );
+	} );
+}
+
+// ----------------------------------------------------------------------
+// Accumulates signed area covered by `edge` into `acc`, which holds rows
+// [band_y, band_y + band_height), `acc_stride` floats per row. Rows must
+// have space for at least `width + 2` floats, and `acc_stride` must be at
+// least `width + 2`.
+static inline void raster_accumulate_edge( float *acc, size_t acc_stride, int band_y, int band_height, le_path_raster_edge_t const &edge ) {
+
+	// Edges always run downwards, the direction of the original edge is
+	// given by the sign of its contribution.
+
+	float       dir = 1.f;
+	float const p0x = edge.y0 < edge.y1 ? edge.x0 : edge.x1;
+	float const p0y = edge.y0 < edge.y1 ? edge.y0 : edge.y1;
+	float const p1x = edge.y0 < edge.y1 ? edge.x1 : edge.x0;
+	float const p1y = edge.y0 < edge.y1 ? edge.y1 : edge.y0;
+
+	if ( edge.y0 > edge.y1 ) {
+		dir = -1.f;
+	}
+
+	float const dxdy  = ( p1x - p0x ) / ( p1y - p0y );
+	float const x_max = float( acc_stride - 2 ); // rightmost x for which both x, and x + 1 are within the row
+
+	// Clamp to the band before converting to int - edge coordinates may lie
+	// far outside of the bitmap, and out-of-range conversions are undefined.
+	int const y_begin = int( floorf( std::max( p0y, float( band_y ) ) ) );
+	int const y_end   = int( ceilf( std::min( p1y, float( band_y + band_height ) ) ) );
+
+	for ( int y = y_begin; y < y_end; y++ ) {
+
+		float const row_top    = std::max( float( y ), p0y );
+		float const row_bottom = std::min( float( y + 1 ), p1y );
+
+		float const dy = row_bottom - row_top;
+
+		if ( dy <= 0.f ) {
+			continue;
+		}
+
+		// Edges are clipped to [0, width], but interpolation may round an edge
+		// which ends on a border to just outside of it - which would make us
+		// write outside of the row. Clamp to what the row can hold. Near-
+		// horizontal edges may have an infinite slope, which gives NaN for
+		// 0 * inf - fmaxf, and fminf map NaN to 0.
+		float const x_top    = fminf( fmaxf( p0x + ( row_top - p0y ) * dxdy, 0.f ), x_max );
+		float const x_bottom = fminf( fmaxf( p0x + ( row_bottom - p0y ) * dxdy, 0.f ), x_max );
+
+		float *const row = acc + size_t( y - band_y ) * acc_stride;
+
+		float const d  = dy * dir;
+		float const x0 = std::min( x_top, x_bottom );
+		float const x1 = std::max( x_top, x_bottom );
+
+		float const x0_floor = floorf( x0 );
+		int const   x0i      = int( x0_floor );
+		float const x1_ceil  = ceilf( x1 );
+		int const   x1i      = int( x1_ceil );
+
+		if ( x1i <= x0i + 1 ) {
+			// Edge stays within one pixel in this row
+			float const x_mid = 0.5f * ( x_top + x_bottom ) - x0_floor;
+			row[ x0i ] += d - d * x_mid;
+			row[ x0i + 1 ] += d * x_mid;
+		} else {
+			// Edge crosses several pixels: area grows quadratically in the
+			// first, and last pixel, and linearly in between.
+			float const s   = 1.f / ( x1 - x0 );
+			float const x0f = x0 - x0_floor;
+			float const a0  = 0.5f * s * ( 1.f - x0f ) * ( 1.f - x0f );
+			float const x1f = x1 - x1_ceil + 1.f;
+			float const am  = 0.5f * s * x1f * x1f;
+
+			row[ x0i ] += d * a0;
+
+			if ( x1i == x0i + 2 ) {
+				row[ x0i + 1 ] += d * ( 1.f - a0 - am );
+			} else {
+				float const a1 = s * ( 1.5f - x0f );
+				row[ x0i + 1 ] += d * ( a1 - a0 );
+				for ( int xi = x0i + 2; xi < x1i - 1; xi++ ) {
+					row[ xi ] += d * s;
+				}
+				float const a2 = a1 + float( x1i - x0i - 3 ) * s;
+				row[ x1i - 1 ] += d * ( 1.f - a2 - am );
+			}
+
+			row[ x1i ] += d * am;
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+// Turns accumulated row into 8-bit coverage, and clears the row, so that
+// it may be re-used.
+static inline void raster_resolve_row( float *acc_row, uint8_t *dst, uint32_t width, bool even_odd ) {
+
+	uint32_t x   = 0;
+	float    sum = 0.f;
+
+#ifdef LE_PATH_RASTERIZER_USE_SSE2
+	__m128 const sign_mask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+	__m128 const one       = _mm_set1_ps( 1.f );
+	__m128 const two       = _mm_set1_ps( 2.f );
+	__m128 const half      = _mm_set1_ps( 0.5f );
+	__m128 const scale     = _mm_set1_ps( 255.f );
+
+	__m128 offset = _mm_setzero_ps();
+
+	for ( ; x + 4 <= width; x += 4 ) {
+		__m128 v = _mm_loadu_ps( acc_row + x );
+
+		// prefix sum within lanes, then add running sum of previous lanes
+		v = _mm_add_ps( v, _mm_castsi128_ps( _mm_slli_si128( _mm_castps_si128( v ), 4 ) ) );
+		v = _mm_add_ps( v, _mm_shuffle_ps( _mm_setzero_ps(), v, 0x40 ) );
+		v = _mm_add_ps( v, offset );
+
+		offset = _mm_shuffle_ps( v, v, 0xff );
+
+		__m128 c = _mm_and_ps( v, sign_mask ); // |w|
+
+		if ( even_odd ) {
+			// |w| mod 2 - truncation is floor, since |w| >= 0
+			__m128 const q = _mm_cvtepi32_ps( _mm_cvttps_epi32( _mm_mul_ps( c, half ) ) );
+			c              = _mm_sub_ps( c, _mm_mul_ps( q, two ) );
+			c              = _mm_sub_ps( one, _mm_and_ps( _mm_sub_ps( one, c ), sign_mask ) );
+		} else {
+			c = _mm_min_ps( c, one );
+		}
+
+		__m128i const i = _mm_cvtps_epi32( _mm_mul_ps( c, scale ) );
+		__m128i const p = _mm_packus_epi16( _mm_packs_epi32( i, i ), _mm_setzero_si128() );
+
+		int32_t const packed = _mm_cvtsi128_si32( p );
+		memcpy( dst + x, &packed, 4 );
+	}
+
+	_mm_store_ss( &sum, offset );
+#endif
+
+	for ( ; x < width; x++ ) {
+		sum += acc_row[ x ];
+
+		float c = fabsf( sum );
+
+		if ( even_odd ) {
+			c = c - 2.f * floorf( c * 0.5f );
+			c = 1.f - fabsf( 1.f - c );
+		} else {
+			c = std::min( c, 1.f );
+		}
+
+		dst[ x ] = uint8_t( lrintf( c * 255.f ) );
+	}
+
+	memset( acc_row, 0, sizeof( float ) * ( width + 2 ) );
+}
+
+// ----------------------------------------------------------------------
+
+struct le_path_raster_bins_t {
+	int                   band_height;
+	uint32_t              num_bands;
+	std::vector<uint32_t> band_offsets; // edge indices for band i are at [band_offsets[i], band_offsets[i+1])
+	std::vector<uint32_t> edge_indices;
+};
+
+// ----------------------------------------------------------------------
+// Sorts edges into bands of `band_height` rows, an edge is listed in every
+// band which it touches.
+static inline void raster_bin_edges( le_path_raster_bins_t &bins, le_path_raster_edge_t const *edges, size_t num_edges, uint32_t height, int band_height ) {
+
+	bins.band_height = band_height;
+	bins.num_bands   = ( height + uint32_t( band_height ) - 1 ) / uint32_t( band_height );
+
+	bins.band_offsets.assign( bins.num_bands + 1, 0 );
+
+	auto band_range = [ & ]( le_path_raster_edge_t const &e, int *first, int *last ) -> bool {
+		float const y_min = std::min( e.y0, e.y1 );
+		float const y_max = std::max( e.y0, e.y1 );
+		if ( y_max <= 0.f || y_min >= float( height ) ) {
+			return false;
+		}
+		// clamp to the bitmap before converting to int, see raster_accumulate_edge
+		*first = int( floorf( std::max( y_min, 0.f ) ) ) / band_height;
+		*last  = ( int( ceilf( std::min( y_max, float( height ) ) ) ) - 1 ) / band_height;
+		return *first <= *last;
+	};
+
+	// count edges per band, then calculate offsets, then fill
+
+	for ( size_t i = 0; i != num_edges; i++ ) {
+		int first, last;
+		if ( band_range( edges[ i ], &first, &last ) ) {
+			for ( int b = first; b <= last; b++ ) {
+				bins.band_offsets[ size_t( b ) + 1 ]++;
+			}
+		}
+	}
+
+	for ( uint32_t b = 0; b != bins.num_bands; b++ ) {
+		bins.band_offsets[ b + 1 ] += bins.band_offsets[ b ];
+	}
+
+	bins.edge_indices.resize( bins.band_offsets[ bins.num_bands ] );
+
+	std::vector<uint32_t> fill( bins.band_offsets.begin(), bins.band_offsets.end() - 1 );
+
+	for ( size_t i = 0; i != num_edges; i++ ) {
+		int first, last;
+		if ( band_range( edges[ i ], &first, &last ) ) {
+			for ( int b = first; b <= last; b++ ) {
+				bins.edge_indices[ fill[ size_t( b ) ]++ ] = uint32_t( i );
+			}
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+// Rasterizes bands [first_band, last_band) into `pixels`. `acc` is scratch
+// storage, which is resized as needed.
+static inline void raster_rasterize_bands( le_path_raster_bins_t const &bins, le_path_raster_edge_t const *edges,
+                                           uint32_t first_band, uint32_t last_band, bool even_odd,
+                                           uint8_t *pixels, uint32_t width, uint32_t height, size_t row_stride,
+                                           std::vector<float> &acc ) {
+
+	size_t const acc_stride = ( size_t( width ) + 2 + 3 ) & ~size_t( 3 );
+
+	acc.assign( acc_stride * size_t( bins.band_height ), 0.f );
+
+	for ( uint32_t b = first_band; b != last_band; b++ ) {
+
+		int const band_y      = int( b ) * bins.band_height;
+		int const band_height = std::min( bins.band_height, int( height ) - band_y );
+
+		for ( uint32_t i = bins.band_offsets[ b ]; i != bins.band_offsets[ b + 1 ]; i++ ) {
+			raster_accumulate_edge( acc.data(), acc_stride, band_y, band_height, edges[ bins.edge_indices[ i ] ] );
+		}
+
+		for ( int y = 0; y != band_height; y++ ) {
+			raster_resolve_row( acc.data() + size_t( y ) * acc_stride, pixels + size_t( band_y + y ) * row_stride, width, even_odd );
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,407 @@
+#ifndef GUARD_le_path_svg_parser_H
+#define GUARD_le_path_svg_parser_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "glm/glm.hpp"
+
+#if defined( __cpp_lib_to_chars ) || ( defined( __has_include ) && __has_include( <version> ) )
+#	include <version>
+#endif
+
+#ifdef __cpp_lib_to_chars
+#	include <charconv>
+#	define LE_PATH_SVG_PARSER_USE_FROM_CHARS
+#endif
+
+/*
+
+  Parser for SVG path data, following the grammar given in the SVG 1.1
+  specification (https://www.w3.org/TR/SVG11/paths.html#PathDataBNF).
+
+  We accept all path commands, absolute and relative: M, L, H, V, C, S, Q,
+  T, A, Z, and their lower-case (relative) counterparts, as well as implicit
+  command repeats, where any coordinate pair following a moveto counts as
+  an implicit lineto.
+
+  Numbers may use exponents, and need no separator if they can't be
+  mistaken for one number: "M10-5.5.5-1" is the same as "M 10 -5.5 L 0.5 -1".
+  Arc flags are single characters, and need no separator either.
+
+  Parsing does not allocate: all commands are converted to absolute
+  coordinates, and streamed straight into a sink, which must provide:
+
+      void move_to        ( glm::vec2 const &p );
+      void line_to        ( glm::vec2 const &p );
+      void quad_bezier_to ( glm::vec2 const &p, glm::vec2 const &c1 );
+      void cubic_bezier_to( glm::vec2 const &p, glm::vec2 const &c1, glm::vec2 const &c2 );
+      void arc_to         ( glm::vec2 const &p, glm::vec2 const &radii, float phi, bool large_arc, bool sweep );
+      void close_path     ();
+
+  Arc rotation `phi` is given to the sink in radians. As the specification
+  demands, arcs with a zero radius become lines, arcs which end where they
+  start are dropped, and negative radii are made positive. After closepath,
+  any command but moveto starts a new subpath at the start of the closed
+  subpath, which means the sink receives an explicit move_to for it.
+
+  Most numbers are converted exactly while they are scanned. Any others are
+  converted via std::from_chars where the standard library provides it for
+  floating point, and via strtof otherwise. Either way, results are
+  correctly rounded.
+
+*/
+
+// ----------------------------------------------------------------------
+
+inline static bool svg_is_wsp( char c ) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline static bool svg_is_digit( char c ) {
+	return unsigned( c - '0' ) < 10;
+}
+
+// ----------------------------------------------------------------------
+
+inline static char const *svg_skip_wsp( char const *c, char const *end ) {
+	while ( c != end && svg_is_wsp( *c ) ) {
+		c++;
+	}
+	return c;
+}
+
+// ----------------------------------------------------------------------
+// Skips whitespace, and at most one comma.
+inline static char const *svg_skip_comma_wsp( char const *c, char const *end ) {
+	c = svg_skip_wsp( c, end );
+	if ( c != end && *c == ',' ) {
+		c = svg_skip_wsp( c + 1, end );
+	}
+	return c;
+}
+
+// ----------------------------------------------------------------------
+// Converts number in range [`begin`, `end`) via strtof, which needs a
+// terminated string - numbers which are longer than any sensible number
+// are rejected.
+inline static bool svg_convert_number_strtof( char const *begin, char const *end, float *result ) {
+	char         buf[ 64 ];
+	size_t const len = size_t( end - begin );
+
+	if ( len >= sizeof( buf ) ) {
+		return false;
+	}
+
+	memcpy( buf, begin, len );
+	buf[ len ] = 0;
+
+	*result = strtof( buf, nullptr );
+	return true;
+}
+
+// ----------------------------------------------------------------------
+// Parses number at `c`. Returns pointer to one past the number on success,
+// nullptr otherwise.
+//
+// number: sign? ( digits ( '.' digits? )? | '.' digits ) ( ( 'e' | 'E' ) sign? digits )?
+//
+// Most numbers in path data have few significant digits, and a small
+// exponent, which means that they can be converted exactly: if the decimal
+// mantissa m fits into the 24 bits of a float mantissa, and 10^|e| is exact
+// as a float, then m * 10^e (or m / 10^-e) is correctly rounded, since it
+// only rounds once. All other numbers go through from_chars, or strtof.
+inline static char const *svg_parse_number( char const *c, char const *end, float *result ) {
+
+	static constexpr float powers_of_ten[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+	char const *const number_begin = c;
+
+	bool const is_negative = ( c != end && *c == '-' );
+
+	if ( c != end && ( *c == '+' || *c == '-' ) ) {
+		c++;
+	}
+
+	uint64_t mantissa   = 0; // decimal mantissa - only valid if num_digits <= 19
+	int      num_digits = 0; // significant digits accumulated into mantissa
+	int      exponent   = 0; // decimal exponent, which applies to mantissa
+
+	char const *const integer_begin = c;
+
+	while ( c != end && svg_is_digit( *c ) ) {
+		if ( mantissa != 0 || *c != '0' ) {
+			mantissa = mantissa * 10 + uint64_t( *c - '0' );
+			num_digits++;
+		}
+		c++;
+	}
+
+	bool has_digits = c != integer_begin;
+
+	if ( c != end && *c == '.' ) {
+		c++;
+		char const *const fraction_begin = c;
+		while ( c != end && svg_is_digit( *c ) ) {
+			if ( mantissa != 0 || *c != '0' ) {
+				mantissa = mantissa * 10 + uint64_t( *c - '0' );
+				num_digits++;
+			}
+			exponent--;
+			c++;
+		}
+		has_digits |= c != fraction_begin;
+	}
+
+	if ( !has_digits ) {
+		return nullptr;
+	}
+
+	// Exponent only counts if it is followed by digits - otherwise the 'e'
+	// is not part of this number.
+	if ( c != end && ( *c == 'e' || *c == 'E' ) ) {
+		char const *e = c + 1;
+
+		bool const is_exponent_negative = ( e != end && *e == '-' );
+
+		if ( e != end && ( *e == '+' || *e == '-' ) ) {
+			e++;
+		}
+		if ( e != end && svg_is_digit( *e ) ) {
+			int explicit_exponent = 0;
+			while ( e != end && svg_is_digit( *e ) ) {
+				if ( explicit_exponent < 10000 ) {
+					explicit_exponent = explicit_exponent * 10 + ( *e - '0' );
+				}
+				e++;
+			}
+			exponent += is_exponent_negative ? -explicit_exponent : explicit_exponent;
+			c = e;
+		}
+	}
+
+	// -- Fast path: exact conversion
+
+	if ( num_digits <= 19 && mantissa <= ( uint64_t( 1 ) << 24 ) && exponent >= -10 && exponent <= 10 ) {
+		float value = float( mantissa );
+		if ( exponent < 0 ) {
+			value /= powers_of_ten[ -exponent ];
+		} else {
+			value *= powers_of_ten[ exponent ];
+		}
+		*result = is_negative ? -value : value;
+		return c;
+	}
+
+	// -- Slow path
+
+	// from_chars, and strtof both reject a leading '+'
+	char const *convert_begin = ( *number_begin == '+' ) ? number_begin + 1 : number_begin;
+
+#ifdef LE_PATH_SVG_PARSER_USE_FROM_CHARS
+	auto const [ ptr, ec ] = std::from_chars( convert_begin, c, *result );
+
+	if ( ec == std::errc::result_out_of_range ) {
+		// from_chars leaves result untouched if out of range, while strtof
+		// gives +-inf, or zero - which is what we want.
+		return svg_convert_number_strtof( convert_begin, c, result ) ? c : nullptr;
+	}
+
+	return ( ec == std::errc() && ptr == c ) ? c : nullptr;
+#else
+	return svg_convert_number_strtof( convert_begin, c, result ) ? c : nullptr;
+#endif
+}
+
+// ----------------------------------------------------------------------
+// Parses arc flag ('0', or '1') at `c`. Returns pointer to one past the
+// flag on success, nullptr otherwise.
+inline static char const *svg_parse_flag( char const *c, char const *end, bool *result ) {
+	if ( c == end || ( *c != '0' && *c != '1' ) ) {
+		return nullptr;
+	}
+	*result = ( *c == '1' );
+	return c + 1;
+}
+
+// ----------------------------------------------------------------------
+// Parses `count` numbers, separated by comma-wsp, into `values`. Returns
+// pointer to one past the last number on success, nullptr otherwise.
+inline static char const *svg_parse_numbers( char const *c, char const *end, float *values, size_t count ) {
+	for ( size_t i = 0; i != count; i++ ) {
+		if ( i != 0 ) {
+			c = svg_skip_comma_wsp( c, end );
+		}
+		c = svg_parse_number( c, end, values + i );
+		if ( c == nullptr ) {
+			return nullptr;
+		}
+	}
+	return c;
+}
+
+// ----------------------------------------------------------------------
+// Parses SVG path data in range [`c`, `end`) and streams commands into `sink`.
+//
+// Returns pointer to `end` on success. On error, returns a pointer to the
+// first character which could not be parsed - commands up to the error
+// have been passed to sink, which matches how the specification wants
+// erroneous path data to be rendered.
+template <typename Sink>
+static char const *svg_path_parse( char const *c, char const *end, Sink &sink ) {
+
+	glm::vec2 current_point = {}; // current point, in absolute coordinates
+	glm::vec2 subpath_start = {}; // start point of current subpath
+	glm::vec2 last_control  = {}; // last control point of previous command, used for S, and T
+	char      command       = 0;  // current command, repeated implicitly
+	char      prev_command  = 0;  // command which was last passed to sink, in upper case
+	bool      needs_move_to = false;
+
+	c = svg_skip_wsp( c, end );
+
+	while ( c != end ) {
+
+		char const *const command_begin = c;
+
+		if ( ( *c >= 'A' && *c <= 'Z' ) || ( *c >= 'a' && *c <= 'z' ) ) {
+			command = *c;
+			c       = svg_skip_wsp( c + 1, end );
+		} else if ( command == 0 || command == 'Z' || command == 'z' ) {
+			// Numbers may only follow a command which takes parameters.
+			return command_begin;
+		}
+
+		// Path data must begin with a moveto
+		if ( prev_command == 0 && command != 'M' && command != 'm' ) {
+			return command_begin;
+		}
+
+		bool const      is_relative = ( command >= 'a' );
+		char const      upper       = is_relative ? char( command - ( 'a' - 'A' ) ) : command;
+		glm::vec2 const origin      = is_relative ? current_point : glm::vec2{ 0, 0 };
+
+		if ( upper != 'M' && upper != 'Z' && needs_move_to ) {
+			// Command following closepath starts a new subpath.
+			sink.move_to( subpath_start );
+			needs_move_to = false;
+		}
+
+		float v[ 7 ];
+
+		switch ( upper ) {
+		case 'M': {
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 2 ) ) ) {
+				return command_begin;
+			}
+			current_point = origin + glm::vec2{ v[ 0 ], v[ 1 ] };
+			subpath_start = current_point;
+			needs_move_to = false;
+			sink.move_to( current_point );
+			// Any further coordinate pairs are implicit lineto commands.
+			command = is_relative ? 'l' : 'L';
+		} break;
+		case 'L': {
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 2 ) ) ) {
+				return command_begin;
+			}
+			current_point = origin + glm::vec2{ v[ 0 ], v[ 1 ] };
+			sink.line_to( current_point );
+		} break;
+		case 'H': {
+			if ( nullptr == ( c = svg_parse_number( c, end, v ) ) ) {
+				return command_begin;
+			}
+			current_point.x = origin.x + v[ 0 ];
+			sink.line_to( current_point );
+		} break;
+		case 'V': {
+			if ( nullptr == ( c = svg_parse_number( c, end, v ) ) ) {
+				return command_begin;
+			}
+			current_point.y = origin.y + v[ 0 ];
+			sink.line_to( current_point );
+		} break;
+		case 'C': {
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 6 ) ) ) {
+				return command_begin;
+			}
+			glm::vec2 const c1 = origin + glm::vec2{ v[ 0 ], v[ 1 ] };
+			glm::vec2 const c2 = origin + glm::vec2{ v[ 2 ], v[ 3 ] };
+			current_point      = origin + glm::vec2{ v[ 4 ], v[ 5 ] };
+			last_control       = c2;
+			sink.cubic_bezier_to( current_point, c1, c2 );
+		} break;
+		case 'S': {
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 4 ) ) ) {
+				return command_begin;
+			}
+			// First control point is reflection of previous second control point,
+			// if previous command was a cubic bezier, otherwise current point.
+			glm::vec2 const c1 = ( prev_command == 'C' || prev_command == 'S' ) ? 2.f * current_point - last_control : current_point;
+			glm::vec2 const c2 = origin + glm::vec2{ v[ 0 ], v[ 1 ] };
+			current_point      = origin + glm::vec2{ v[ 2 ], v[ 3 ] };
+			last_control       = c2;
+			sink.cubic_bezier_to( current_point, c1, c2 );
+		} break;
+		case 'Q': {
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 4 ) ) ) {
+				return command_begin;
+			}
+			glm::vec2 const c1 = origin + glm::vec2{ v[ 0 ], v[ 1 ] };
+			current_point      = origin + glm::vec2{ v[ 2 ], v[ 3 ] };
+			last_control       = c1;
+			sink.quad_bezier_to( current_point, c1 );
+		} break;
+		case 'T': {
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 2 ) ) ) {
+				return command_begin;
+			}
+			// Control point is reflection of previous control point, if previous
+			// command was a quadratic bezier, otherwise current point.
+			glm::vec2 const c1 = ( prev_command == 'Q' || prev_command == 'T' ) ? 2.f * current_point - last_control : current_point;
+			current_point      = origin + glm::vec2{ v[ 0 ], v[ 1 ] };
+			last_control       = c1;
+			sink.quad_bezier_to( current_point, c1 );
+		} break;
+		case 'A': {
+			bool large_arc = false;
+			bool sweep     = false;
+			if ( nullptr == ( c = svg_parse_numbers( c, end, v, 3 ) ) ||
+			     nullptr == ( c = svg_parse_flag( svg_skip_comma_wsp( c, end ), end, &large_arc ) ) ||
+			     nullptr == ( c = svg_parse_flag( svg_skip_comma_wsp( c, end ), end, &sweep ) ) ||
+			     nullptr == ( c = svg_parse_numbers( svg_skip_comma_wsp( c, end ), end, v + 3, 2 ) ) ) {
+				return command_begin;
+			}
+			glm::vec2 const p     = origin + glm::vec2{ v[ 3 ], v[ 4 ] };
+			glm::vec2 const radii = { fabsf( v[ 0 ] ), fabsf( v[ 1 ] ) };
+			if ( p == current_point ) {
+				// Arc which ends where it starts is omitted.
+			} else if ( radii.x == 0.f || radii.y == 0.f ) {
+				sink.line_to( p );
+			} else {
+				sink.arc_to( p, radii, glm::radians( v[ 2 ] ), large_arc, sweep );
+			}
+			current_point = p;
+		} break;
+		case 'Z': {
+			sink.close_path();
+			current_point = subpath_start;
+			needs_move_to = true;
+		} break;
+		default:
+			// Unknown command
+			return command_begin;
+		}
+
+		prev_command = upper;
+
+		c = svg_skip_comma_wsp( c, end );
+	}
+
+	return c;
+}
+
+#endif
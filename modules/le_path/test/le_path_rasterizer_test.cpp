@@ -0,0 +1,196 @@
+/*
+
+  Test: coverage rasterizer, edges on the left border of the bitmap.
+
+  This is a standalone program, which does not depend on any island module.
+  It gets built as target `le_path_rasterizer_test` alongside any app which
+  uses le_path, and registered with CTest if the app enables testing - or,
+  from the island root directory, with:
+
+      c++ -std=c++17 -g -O1 -fsanitize=address,undefined -I modules \
+          modules/le_path/test/le_path_rasterizer_test.cpp -o le_path_rasterizer_test
+
+  Then run:
+
+      ./le_path_rasterizer_test
+
+  Edges which are clipped against the left border end exactly on x=0, and
+  interpolating along them could round to just below 0, which made us write
+  before the start of a row. We rasterize random triangles which cross the
+  left border into accumulation rows which are fenced by zeroed guards, and
+  check that the guards stay untouched - and that a rectangle which spans
+  the whole bitmap covers every pixel fully.
+
+  Edges may also lie far outside of the bitmap, or have non-finite
+  coordinates - converting these to int would be undefined. We rasterize a
+  rectangle with extreme coordinates, which must cover every pixel fully,
+  and check that edges with non-finite coordinates are dropped.
+
+  Returns 0 on success, 1 on failure.
+
+*/
+
+#include "le_path/private/le_path_rasterizer.h"
+
+#include <random>
+#include <stdio.h>
+
+// ----------------------------------------------------------------------
+
+static bool test_left_border_stays_within_rows() {
+
+	constexpr uint32_t width       = 8;
+	constexpr uint32_t height      = 4;
+	constexpr int      band_height = 2;
+	constexpr size_t   acc_stride  = ( size_t( width ) + 2 + 3 ) & ~size_t( 3 );
+	constexpr size_t   num_guards  = 4;
+
+	std::mt19937                          rng( 12345 );
+	std::uniform_real_distribution<float> x_dist( -4.f, 12.f );
+	std::uniform_real_distribution<float> y_dist( 0.f, float( height ) );
+
+	// guards, rows of one band, guards
+	std::vector<float> acc( num_guards + acc_stride * band_height + num_guards );
+
+	for ( int i = 0; i != 100000; i++ ) {
+
+		float x[ 3 ];
+		float y[ 3 ];
+
+		for ( int j = 0; j != 3; j++ ) {
+			x[ j ] = x_dist( rng );
+			y[ j ] = y_dist( rng );
+		}
+
+		std::vector<le_path_raster_edge_t> edges;
+		for ( int j = 0; j != 3; j++ ) {
+			raster_add_edge( edges, x[ j ], y[ j ], x[ ( j + 1 ) % 3 ], y[ ( j + 1 ) % 3 ], float( width ) );
+		}
+
+		for ( int band_y = 0; band_y < int( height ); band_y += band_height ) {
+
+			std::fill( acc.begin(), acc.end(), 0.f );
+
+			for ( auto const &e : edges ) {
+				raster_accumulate_edge( acc.data() + num_guards, acc_stride, band_y, band_height, e );
+			}
+
+			for ( size_t g = 0; g != num_guards; g++ ) {
+				// Stray writes may be tiny - we compare bits, so that we catch them.
+				uint32_t before, after;
+				memcpy( &before, &acc[ g ], sizeof( float ) );
+				memcpy( &after, &acc[ acc.size() - 1 - g ], sizeof( float ) );
+				if ( before != 0 || after != 0 ) {
+					printf( "FAIL: triangle (%g,%g) (%g,%g) (%g,%g) writes outside of accumulation rows\n",
+					        double( x[ 0 ] ), double( y[ 0 ] ), double( x[ 1 ] ), double( y[ 1 ] ), double( x[ 2 ] ), double( y[ 2 ] ) );
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+static bool test_full_rectangle_on_left_border() {
+
+	constexpr uint32_t width  = 8;
+	constexpr uint32_t height = 4;
+
+	// Rectangle which starts left of the bitmap, and ends right of it.
+	float const x0 = -1.f / 3.f;
+	float const x1 = float( width ) + 0.5f;
+
+	std::vector<le_path_raster_edge_t> edges;
+	raster_add_edge( edges, x0, 0.f, x1, 0.f, float( width ) );
+	raster_add_edge( edges, x1, 0.f, x1, float( height ), float( width ) );
+	raster_add_edge( edges, x1, float( height ), x0, float( height ), float( width ) );
+	raster_add_edge( edges, x0, float( height ), x0, 0.f, float( width ) );
+
+	le_path_raster_bins_t bins;
+	raster_bin_edges( bins, edges.data(), edges.size(), height, 2 );
+
+	uint8_t            pixels[ width * height ];
+	std::vector<float> acc;
+
+	raster_rasterize_bands( bins, edges.data(), 0, bins.num_bands, false, pixels, width, height, width, acc );
+
+	for ( uint32_t i = 0; i != width * height; i++ ) {
+		if ( pixels[ i ] != 255 ) {
+			printf( "FAIL: pixel %u, %u has coverage %u, expected 255\n", i % width, i / width, pixels[ i ] );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+static bool test_extreme_coordinates() {
+
+	constexpr uint32_t width  = 8;
+	constexpr uint32_t height = 4;
+
+	float const lo  = -1e30f;
+	float const hi  = 1e30f;
+	float const nan = NAN;
+	float const inf = INFINITY;
+
+	std::vector<le_path_raster_edge_t> edges;
+
+	// Rectangle which covers the bitmap, with corners far outside of it.
+	raster_add_edge( edges, lo, lo, hi, lo, float( width ) );
+	raster_add_edge( edges, hi, lo, hi, hi, float( width ) );
+	raster_add_edge( edges, hi, hi, lo, hi, float( width ) );
+	raster_add_edge( edges, lo, hi, lo, lo, float( width ) );
+
+	// Near-horizontal edge, which crosses the whole bitmap within a tiny fraction of a row.
+	raster_add_edge( edges, lo, 1.5f, hi, 1.5f + 1e-6f, float( width ) );
+	raster_add_edge( edges, hi, 1.5f + 1e-6f, lo, 1.5f, float( width ) );
+
+	size_t const num_finite_edges = edges.size();
+
+	raster_add_edge( edges, nan, 0.f, 1.f, 2.f, float( width ) );
+	raster_add_edge( edges, 1.f, -inf, 1.f, inf, float( width ) );
+	raster_add_edge( edges, 0.f, 1.f, 4.f, nan, float( width ) );
+
+	if ( edges.size() != num_finite_edges ) {
+		printf( "FAIL: edges with non-finite coordinates were not dropped\n" );
+		return false;
+	}
+
+	le_path_raster_bins_t bins;
+	raster_bin_edges( bins, edges.data(), edges.size(), height, 2 );
+
+	uint8_t            pixels[ width * height ];
+	std::vector<float> acc;
+
+	raster_rasterize_bands( bins, edges.data(), 0, bins.num_bands, false, pixels, width, height, width, acc );
+
+	for ( uint32_t i = 0; i != width * height; i++ ) {
+		if ( pixels[ i ] != 255 ) {
+			printf( "FAIL: pixel %u, %u has coverage %u, expected 255\n", i % width, i / width, pixels[ i ] );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+int main() {
+
+	bool ok = true;
+
+	ok &= test_left_border_stays_within_rows();
+	ok &= test_full_rectangle_on_left_border();
+	ok &= test_extreme_coordinates();
+
+	printf( "le_path rasterizer test: %s\n", ok ? "ok" : "FAILED" );
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#ifndef GUARD_le_graphics_pipeline_description_H
+#define GUARD_le_graphics_pipeline_description_H
+
+#include "le_pipeline_builder/le_pipeline_builder.h"
+#include "le_renderer/le_renderer.h" // for le:: enums
+#include "le_core/hash_util.h"
+
+/*
+
+  Static graphics pipeline descriptions.
+
+  A graphics pipeline description covers the fixed-function state most
+  pipelines set, and nothing else. It may be fully evaluated at compile
+  time, which means that its hash may be calculated at compile time, too:
+
+      static constexpr auto desc = le_graphics_pipeline_description_t()
+                                       .setCullMode( le::CullModeFlagBits::eBack )
+                                       .setDepthTestEnable( false );
+
+      static constexpr uint64_t desc_hash = desc.hash();
+
+      le_shader_module_o* shaders[] = { vert, frag };
+
+      auto pso = le_pipeline_builder::le_graphics_pipeline_builder_i.build_from_description(
+          pipeline_manager, &desc, desc_hash, shaders, 2 );
+
+  A description's hash is a fingerprint of the description, and not the
+  hash of the pipeline: pipelines built from a description get the same
+  handle as pipelines built via the graphics pipeline builder with the same
+  state. The first time a thread builds from a description, we translate
+  the description into Vulkan state, and hash it as the builder would. We
+  remember this hash by fingerprint, so that from then on, building only
+  needs to mix in the hashes of the given shader modules (which may change
+  when shaders get reloaded), and then needs exactly one lookup in the
+  pipeline cache.
+
+  Any state which is not part of the description uses the same defaults as
+  the graphics pipeline builder. If you need to set any other state, use the
+  graphics pipeline builder instead.
+
+  Floating point state is quantised to 1/65536 for hashing, since we can't
+  reinterpret the bits of a float in a constant expression.
+
+*/
+
+struct le_graphics_pipeline_description_t {
+	static constexpr size_t MAX_BLEND_ATTACHMENTS = 8;
+
+	le::PrimitiveTopology topology                 = le::PrimitiveTopology::eTriangleList;
+	bool                  primitive_restart_enable = false;
+
+	le::PolygonMode      polygon_mode               = le::PolygonMode::eFill;
+	le::CullModeFlagBits cull_mode                  = le::CullModeFlagBits::eNone;
+	le::FrontFace        front_face                 = le::FrontFace::eCounterClockwise;
+	float                line_width                 = 1.f;
+	bool                 depth_bias_enable          = false;
+	float                depth_bias_constant_factor = 0.f;
+	float                depth_bias_slope_factor    = 1.f;
+
+	le::SampleCountFlagBits rasterization_samples = le::SampleCountFlagBits::e1;
+	bool                    sample_shading_enable = false;
+	float                   min_sample_shading    = 0.f;
+
+	bool          depth_test_enable  = true;
+	bool          depth_write_enable = true;
+	le::CompareOp depth_compare_op   = le::CompareOp::eLessOrEqual;
+
+	le::AttachmentBlendPreset blend_presets[ MAX_BLEND_ATTACHMENTS ] = {}; // all default to ePremultipliedAlpha
+
+	// clang-format off
+	constexpr le_graphics_pipeline_description_t& setTopology               ( le::PrimitiveTopology v   ) { topology                   = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setPrimitiveRestartEnable ( bool v                    ) { primitive_restart_enable   = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setPolygonMode            ( le::PolygonMode v         ) { polygon_mode               = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setCullMode               ( le::CullModeFlagBits v    ) { cull_mode                  = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setFrontFace              ( le::FrontFace v           ) { front_face                 = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setLineWidth              ( float v                   ) { line_width                 = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setDepthBiasEnable        ( bool v                    ) { depth_bias_enable          = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setDepthBiasConstantFactor( float v                   ) { depth_bias_constant_factor = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setDepthBiasSlopeFactor   ( float v                   ) { depth_bias_slope_factor    = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setRasterizationSamples   ( le::SampleCountFlagBits v ) { rasterization_samples      = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setSampleShadingEnable    ( bool v                    ) { sample_shading_enable      = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setMinSampleShading       ( float v                   ) { min_sample_shading         = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setDepthTestEnable        ( bool v                    ) { depth_test_enable          = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setDepthWriteEnable       ( bool v                    ) { depth_write_enable         = v; return *this; }
+	constexpr le_graphics_pipeline_description_t& setDepthCompareOp         ( le::CompareOp v           ) { depth_compare_op           = v; return *this; }
+
+	constexpr le_graphics_pipeline_description_t& setBlendPreset( size_t which_attachment, le::AttachmentBlendPreset v ) {
+		blend_presets[ which_attachment ] = v;
+		return *this;
+	}
+	// clang-format on
+
+	// Returns a fingerprint over all fields of this description - may be evaluated at compile time.
+	constexpr uint64_t hash() const noexcept {
+		uint64_t h = FNV1A_VAL_64_CONST;
+
+		h = mix( h, uint64_t( topology ) );
+		h = mix( h, uint64_t( primitive_restart_enable ) );
+		h = mix( h, uint64_t( polygon_mode ) );
+		h = mix( h, uint64_t( cull_mode ) );
+		h = mix( h, uint64_t( front_face ) );
+		h = mix( h, quantise( line_width ) );
+		h = mix( h, uint64_t( depth_bias_enable ) );
+		h = mix( h, quantise( depth_bias_constant_factor ) );
+		h = mix( h, quantise( depth_bias_slope_factor ) );
+		h = mix( h, uint64_t( rasterization_samples ) );
+		h = mix( h, uint64_t( sample_shading_enable ) );
+		h = mix( h, quantise( min_sample_shading ) );
+		h = mix( h, uint64_t( depth_test_enable ) );
+		h = mix( h, uint64_t( depth_write_enable ) );
+		h = mix( h, uint64_t( depth_compare_op ) );
+
+		for ( auto const &p : blend_presets ) {
+			h = mix( h, uint64_t( p ) );
+		}
+
+		return h;
+	}
+
+	constexpr bool operator==( le_graphics_pipeline_description_t const &rhs ) const noexcept {
+		for ( size_t i = 0; i != MAX_BLEND_ATTACHMENTS; i++ ) {
+			if ( blend_presets[ i ] != rhs.blend_presets[ i ] ) {
+				return false;
+			}
+		}
+		return topology == rhs.topology &&
+		       primitive_restart_enable == rhs.primitive_restart_enable &&
+		       polygon_mode == rhs.polygon_mode &&
+		       cull_mode == rhs.cull_mode &&
+		       front_face == rhs.front_face &&
+		       line_width == rhs.line_width &&
+		       depth_bias_enable == rhs.depth_bias_enable &&
+		       depth_bias_constant_factor == rhs.depth_bias_constant_factor &&
+		       depth_bias_slope_factor == rhs.depth_bias_slope_factor &&
+		       rasterization_samples == rhs.rasterization_samples &&
+		       sample_shading_enable == rhs.sample_shading_enable &&
+		       min_sample_shading == rhs.min_sample_shading &&
+		       depth_test_enable == rhs.depth_test_enable &&
+		       depth_write_enable == rhs.depth_write_enable &&
+		       depth_compare_op == rhs.depth_compare_op;
+	}
+
+	constexpr bool operator!=( le_graphics_pipeline_description_t const &rhs ) const noexcept {
+		return !( *this == rhs );
+	}
+
+  private:
+	static constexpr uint64_t mix( uint64_t h, uint64_t value ) noexcept {
+		return hash_64_fnv1a_mix_const( h, value );
+	}
+
+	static constexpr uint64_t quantise( float v ) noexcept {
+		return uint64_t( int64_t( double( v ) * 65536.0 ) );
+	}
+};
+
+namespace le {
+using GraphicsPipelineDescription = le_graphics_pipeline_description_t;
+} // namespace le
+
+#endif
@@ -1,4 +1,5 @@
 #include "le_pipeline_builder.h"
+#include "le_graphics_pipeline_description.h"
 #include "le_core/le_core.h"
 
 #include "3rdparty/src/spooky/SpookyV2.h"
@@ -11,6 +12,7 @@
 #include <array>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 /*
 
@@ -38,8 +40,10 @@
 	- read from pso state based on found hash index
   - Write access is therefore only if there is a new pso and it must be added to the cache.
 
-  - we need to protect access to pso cache so that its thread safe
-	- consider using a shared_mutex - either: multiple readers - or one single writer
+  - pso cache lookups are lock-free, and insertions don't block lookups
+	- see HashTable in le_backend_vk/le_pipeline.cpp
+	- if two threads race to insert the same pso, the first one wins, and the
+	  other one's copy is discarded - both end up using the same handle
 
 	a pipeline builder *must* be associated with a backend, so that we can
 	write pso data back to the backend's cache.
@@ -57,6 +61,15 @@ static constexpr inline vk::PrimitiveTopology le_to_vk( const le::PrimitiveTopol
 struct le_graphics_pipeline_builder_o {
 	graphics_pipeline_state_o *obj           = nullptr;
 	le_pipeline_manager_o *    pipelineCache = nullptr;
+
+	// We cache hashes over sections of pipeline state, so that we only need to
+	// re-hash a section if it was changed via a setter since the last build.
+	// Shader module hashes are not cached, since they change whenever a shader
+	// gets recompiled.
+	uint64_t data_hash               = 0; // hash over obj->data
+	uint64_t vertex_input_hash       = 0; // hash over obj->explicitVertex*Descriptions
+	bool     data_hash_dirty         = true;
+	bool     vertex_input_hash_dirty = true;
 };
 
 struct le_compute_pipeline_builder_o {
@@ -225,19 +238,23 @@ static le_rtxpso_handle le_rtx_pipeline_builder_build( le_rtx_pipeline_builder_o
 
 		uint64_t hash_value{};
 
-		// calculate hash over all shader module hashes.
+		// calculate hash over all shader module hashes - we feed shader module
+		// hashes one-by-one into a streaming hash, so that we don't have to
+		// collect them into a heap-allocated array first. The result is
+		// identical to hashing all shader module hashes in one go.
 
-		std::vector<uint64_t> shader_module_hashes;
+		{
+			SpookyHash hash_state;
+			hash_state.Init( hash_value, hash_value );
 
-		shader_module_hashes.reserve( self->obj->shaderStages.size() );
-		for ( auto const &shader_stage : self->obj->shaderStages ) {
-			shader_module_hashes.emplace_back( le_shader_module_i.get_hash( shader_stage ) );
-		}
+			for ( auto const &shader_stage : self->obj->shaderStages ) {
+				uint64_t const shader_module_hash = le_shader_module_i.get_hash( shader_stage );
+				hash_state.Update( &shader_module_hash, sizeof( uint64_t ) );
+			}
 
-		hash_value = SpookyHash::Hash64(
-		    shader_module_hashes.data(),
-		    shader_module_hashes.size() * sizeof( uint64_t ),
-		    hash_value );
+			uint64_t unused;
+			hash_state.Final( &hash_value, &unused );
+		}
 
 		static_assert( std::has_unique_object_representations_v<le_rtx_shader_group_info>,
 		               "shader group create info must be tightly packed, so that it may be used"
@@ -263,19 +280,16 @@ static le_rtxpso_handle le_rtx_pipeline_builder_build( le_rtx_pipeline_builder_o
 
 // ----------------------------------------------------------------------
 
-static le_graphics_pipeline_builder_o *
-le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
-	auto self = new le_graphics_pipeline_builder_o();
+// Sets pipeline state data to default values.
+static void graphics_pipeline_builder_data_set_defaults( le_graphics_pipeline_builder_data &data ) {
 
-	self->pipelineCache = pipelineCache;
-	self->obj           = new graphics_pipeline_state_o();
-	// set default values
+	data = {};
 
-	self->obj->data.inputAssemblyState
+	data.inputAssemblyState
 	    .setTopology( vk::PrimitiveTopology::eTriangleList )
 	    .setPrimitiveRestartEnable( VK_FALSE );
 
-	self->obj->data.tessellationState
+	data.tessellationState
 	    .setPatchControlPoints( 3 );
 
 	// Viewport and scissor are tracked as dynamic states,
@@ -283,7 +297,7 @@ le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
 	// but we need to give it some default values to match requirements.
 	//
 
-	self->obj->data.rasterizationInfo
+	data.rasterizationInfo
 	    .setDepthClampEnable( VK_FALSE )
 	    .setRasterizerDiscardEnable( VK_FALSE )
 	    .setPolygonMode( vk::PolygonMode::eFill )
@@ -295,7 +309,7 @@ le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
 	    .setDepthBiasSlopeFactor( 1.f )
 	    .setLineWidth( 1.f );
 
-	self->obj->data.multisampleState
+	data.multisampleState
 	    .setRasterizationSamples( vk::SampleCountFlagBits::e1 )
 	    .setSampleShadingEnable( VK_FALSE )
 	    .setMinSampleShading( 0.f )
@@ -313,7 +327,7 @@ le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
 	    .setWriteMask( 0 )
 	    .setReference( 0 );
 
-	self->obj->data.depthStencilState
+	data.depthStencilState
 	    .setDepthTestEnable( VK_TRUE )
 	    .setDepthWriteEnable( VK_TRUE )
 	    .setDepthCompareOp( vk::CompareOp::eLessOrEqual )
@@ -325,7 +339,7 @@ le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
 	    .setMaxDepthBounds( 0.f );
 
 	// Default values for color blend state: premultiplied alpha
-	for ( auto &blendAttachmentState : self->obj->data.blendAttachmentStates ) {
+	for ( auto &blendAttachmentState : data.blendAttachmentStates ) {
 		blendAttachmentState
 		    .setBlendEnable( VK_TRUE )
 		    .setColorBlendOp( vk::BlendOp::eAdd )
@@ -341,9 +355,37 @@ le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
 		        vk::ColorComponentFlagBits::eA );
 	}
 
+}
+
+// ----------------------------------------------------------------------
+
+static le_graphics_pipeline_builder_o *
+le_graphics_pipeline_builder_create( le_pipeline_manager_o *pipelineCache ) {
+	auto self = new le_graphics_pipeline_builder_o();
+
+	self->pipelineCache = pipelineCache;
+	self->obj           = new graphics_pipeline_state_o();
+
+	graphics_pipeline_builder_data_set_defaults( self->obj->data );
+
 	return self;
 }
 
+// ----------------------------------------------------------------------
+// Returns pipeline state data for writing - marks cached hash over data as stale.
+static inline le_graphics_pipeline_builder_data &builder_data_for_write( le_graphics_pipeline_builder_o *self ) {
+	self->data_hash_dirty = true;
+	return self->obj->data;
+}
+
+// ----------------------------------------------------------------------
+// Returns pipeline state for writing vertex input descriptions - marks cached
+// hash over vertex input descriptions as stale.
+static inline graphics_pipeline_state_o *builder_vertex_input_for_write( le_graphics_pipeline_builder_o *self ) {
+	self->vertex_input_hash_dirty = true;
+	return self->obj;
+}
+
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_add_binding( le_graphics_pipeline_builder_o *self, uint8_t binding_number ) {
@@ -352,19 +394,19 @@ void le_graphics_pipeline_builder_add_binding( le_graphics_pipeline_builder_o *s
 	binding.binding    = binding_number;
 	binding.input_rate = le_vertex_input_rate::ePerVertex;
 	assert( binding_number == self->obj->explicitVertexInputBindingDescriptions.size() && "binding numbers must be in sequence" );
-	self->obj->explicitVertexInputBindingDescriptions.emplace_back( binding );
+	builder_vertex_input_for_write( self )->explicitVertexInputBindingDescriptions.emplace_back( binding );
 }
 
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_set_binding_input_rate( le_graphics_pipeline_builder_o *self, uint8_t binding_number, const le_vertex_input_rate &input_rate ) {
-	self->obj->explicitVertexInputBindingDescriptions[ binding_number ].input_rate = input_rate;
+	builder_vertex_input_for_write( self )->explicitVertexInputBindingDescriptions[ binding_number ].input_rate = input_rate;
 }
 
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_set_binding_stride( le_graphics_pipeline_builder_o *self, uint8_t binding_number, uint16_t stride ) {
-	self->obj->explicitVertexInputBindingDescriptions[ binding_number ].stride = stride;
+	builder_vertex_input_for_write( self )->explicitVertexInputBindingDescriptions[ binding_number ].stride = stride;
 }
 
 // ----------------------------------------------------------------------
@@ -381,37 +423,37 @@ void le_graphics_pipeline_builder_binding_add_attribute( le_graphics_pipeline_bu
 
 	assert( attribute_number == self->obj->explicitVertexAttributeDescriptions.size() && "attribute locations must be in sequence" );
 
-	self->obj->explicitVertexAttributeDescriptions.emplace_back( attribute );
+	builder_vertex_input_for_write( self )->explicitVertexAttributeDescriptions.emplace_back( attribute );
 }
 
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_attribute_set_offset( le_graphics_pipeline_builder_o *self, uint8_t attribute_location, uint16_t offset ) {
-	self->obj->explicitVertexAttributeDescriptions[ attribute_location ].binding_offset = offset;
+	builder_vertex_input_for_write( self )->explicitVertexAttributeDescriptions[ attribute_location ].binding_offset = offset;
 }
 
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_attribute_set_type( le_graphics_pipeline_builder_o *self, uint8_t attribute_location, const le_num_type &type ) {
-	self->obj->explicitVertexAttributeDescriptions[ attribute_location ].type = type;
+	builder_vertex_input_for_write( self )->explicitVertexAttributeDescriptions[ attribute_location ].type = type;
 }
 
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_attribute_set_vec_size( le_graphics_pipeline_builder_o *self, uint8_t attribute_location, uint8_t vec_size ) {
-	self->obj->explicitVertexAttributeDescriptions[ attribute_location ].vecsize = vec_size;
+	builder_vertex_input_for_write( self )->explicitVertexAttributeDescriptions[ attribute_location ].vecsize = vec_size;
 }
 
 // ----------------------------------------------------------------------
 
 void le_graphics_pipeline_builder_attribute_set_is_normalized( le_graphics_pipeline_builder_o *self, uint8_t attribute_location, bool is_normalized ) {
-	self->obj->explicitVertexAttributeDescriptions[ attribute_location ].isNormalised = is_normalized;
+	builder_vertex_input_for_write( self )->explicitVertexAttributeDescriptions[ attribute_location ].isNormalised = is_normalized;
 }
 
 // ----------------------------------------------------------------------
 
 static void le_graphics_pipeline_builder_set_vertex_input_attribute_descriptions( le_graphics_pipeline_builder_o *self, le_vertex_input_attribute_description *p_input_attribute_descriptions, size_t count ) {
-	self->obj->explicitVertexAttributeDescriptions =
+	builder_vertex_input_for_write( self )->explicitVertexAttributeDescriptions =
 	    { p_input_attribute_descriptions,
 	      p_input_attribute_descriptions + count };
 }
@@ -419,7 +461,7 @@ static void le_graphics_pipeline_builder_set_vertex_input_attribute_descriptions
 // ----------------------------------------------------------------------
 
 static void le_graphics_pipeline_builder_set_vertex_input_binding_descriptions( le_graphics_pipeline_builder_o *self, le_vertex_input_binding_description *p_input_binding_descriptions, size_t count ) {
-	self->obj->explicitVertexInputBindingDescriptions =
+	builder_vertex_input_for_write( self )->explicitVertexInputBindingDescriptions =
 	    { p_input_binding_descriptions,
 	      p_input_binding_descriptions + count };
 }
@@ -427,11 +469,11 @@ static void le_graphics_pipeline_builder_set_vertex_input_binding_descriptions(
 // ----------------------------------------------------------------------
 
 static void le_graphics_pipeline_builder_set_multisample_info( le_graphics_pipeline_builder_o *self, const VkPipelineMultisampleStateCreateInfo &multisampleInfo ) {
-	self->obj->data.multisampleState = multisampleInfo;
+	builder_data_for_write( self ).multisampleState = multisampleInfo;
 }
 
 static void le_graphics_pipeline_builder_set_depth_stencil_info( le_graphics_pipeline_builder_o *self, const VkPipelineDepthStencilStateCreateInfo &depthStencilInfo ) {
-	self->obj->data.depthStencilState = depthStencilInfo;
+	builder_data_for_write( self ).depthStencilState = depthStencilInfo;
 }
 // ----------------------------------------------------------------------
 
@@ -444,6 +486,75 @@ static void le_graphics_pipeline_builder_destroy( le_graphics_pipeline_builder_o
 
 // ----------------------------------------------------------------------
 
+// Graphics pipeline state is hashed in exactly one way, whether it comes from
+// a builder, or from a static description: we hash its canonical form, which
+// is the Vulkan state it translates into, see `graphics_pipeline_data_hash`,
+// together with shader module hashes, and vertex input descriptions, see
+// `graphics_pipeline_hash`. Equal state therefore always gives equal handles.
+
+// Returns hash over pipeline state data.
+static uint64_t graphics_pipeline_data_hash( le_graphics_pipeline_builder_data const &data ) {
+	return SpookyHash::Hash64( &data, sizeof( le_graphics_pipeline_builder_data ), 0 );
+}
+
+// ----------------------------------------------------------------------
+// Returns hash over vertex input descriptions, or 0 if there are none.
+static uint64_t graphics_pipeline_vertex_input_hash( graphics_pipeline_state_o const *obj ) {
+
+	static_assert( std::has_unique_object_representations_v<le_vertex_input_binding_description>,
+	               "vertex input binding descriptrion must be tightly packed, so that it "
+	               "may be hashed (any padding will invalidate hash)." );
+
+	uint64_t hash_value = 0;
+
+	if ( !obj->explicitVertexInputBindingDescriptions.empty() ) {
+		hash_value = SpookyHash::Hash64( obj->explicitVertexInputBindingDescriptions.data(),
+		                                 obj->explicitVertexInputBindingDescriptions.size() * sizeof( le_vertex_input_binding_description ),
+		                                 hash_value );
+
+		hash_value = SpookyHash::Hash64( obj->explicitVertexAttributeDescriptions.data(),
+		                                 obj->explicitVertexAttributeDescriptions.size() * sizeof( le_vertex_input_attribute_description ),
+		                                 hash_value );
+	}
+
+	return hash_value;
+}
+
+// ----------------------------------------------------------------------
+// Returns the complete hash representing a graphics pipeline state object:
+// a meta-hash over the hashes of the given shader modules, mixed into the
+// hash over pipeline state data, followed by the hash over vertex input
+// descriptions, if any.
+//
+// Shader module hashes are always fetched at build time, since a module's
+// hash changes whenever its shader gets recompiled.
+static uint64_t graphics_pipeline_hash( uint64_t data_hash, le_shader_module_o *const *shader_stages, size_t shader_stages_count, uint64_t vertex_input_hash ) {
+
+	// Rather than a std::vector, we use a plain-c array to collect hash entries
+	// for all stages, because we don't want to allocate anything on the heap,
+	// and local fixed-size c-arrays are cheap.
+
+	constexpr size_t maxShaderStages = 8;                 // we assume a maximum number of shader entries
+	uint64_t         stageHashEntries[ maxShaderStages ]; // array of stage hashes for further hashing
+
+	assert( shader_stages_count <= maxShaderStages ); // We're gonna need a bigger boat.
+
+	using namespace le_backend_vk;
+
+	for ( size_t i = 0; i != shader_stages_count; i++ ) {
+		stageHashEntries[ i ] = le_shader_module_i.get_hash( shader_stages[ i ] );
+	}
+
+	uint64_t hash_value = SpookyHash::Hash64( stageHashEntries, shader_stages_count * sizeof( uint64_t ), data_hash );
+
+	if ( vertex_input_hash ) {
+		hash_value = SpookyHash::Hash64( &vertex_input_hash, sizeof( uint64_t ), hash_value );
+	}
+
+	return hash_value;
+}
+
+// ----------------------------------------------------------------------
 // Calculate pipeline info hash, and add pipeline info to shared store if not yet seen.
 // Return pipeline hash
 static le_gpso_handle le_graphics_pipeline_builder_build( le_graphics_pipeline_builder_o *self ) {
@@ -451,46 +562,20 @@ static le_gpso_handle le_graphics_pipeline_builder_build( le_graphics_pipeline_b
 	le_gpso_handle pipeline_handle = {};
 
 	{
-		constexpr size_t hash_msg_size = sizeof( le_graphics_pipeline_builder_data );
-		uint64_t         hash_value    = SpookyHash::Hash64( &self->obj->data, hash_msg_size, 0 );
-		// Calculate a meta-hash over shader stage hash entries so that we can
-		// detect if a shader component has changed
-		//
-		// Rather than a std::vector, we use a plain-c array to collect hash entries
-		// for all stages, because we don't want to allocate anything on the heap,
-		// and local fixed-size c-arrays are cheap.
-
-		constexpr size_t maxShaderStages = 8;                 // we assume a maximum number of shader entries
-		uint64_t         stageHashEntries[ maxShaderStages ]; // array of stage hashes for further hashing
-		uint64_t         stageHashEntriesUsed = 0;            // number of used shader stage hash entries
-
-		for ( auto const &module : self->obj->shaderStages ) {
-			using namespace le_backend_vk;
-			stageHashEntries[ stageHashEntriesUsed++ ] = le_shader_module_i.get_hash( module );
-			assert( stageHashEntriesUsed <= maxShaderStages ); // We're gonna need a bigger boat.
-		}
-
-		// Mix in the meta-hash over shader stages with the previous hash over pipeline state
-		// which gives the complete hash representing a pipeline state object.
-
-		hash_value = SpookyHash::Hash64( stageHashEntries, stageHashEntriesUsed * sizeof( uint64_t ), hash_value );
-
-		// -- If pipeline has explicit attribute binding stages that must be factored in with the hash.
-
-		static_assert( std::has_unique_object_representations_v<le_vertex_input_binding_description>,
-		               "vertex input binding descriptrion must be tightly packed, so that it "
-		               "may be hashed (any padding will invalidate hash)." );
+		// Only re-hash sections of pipeline state which changed since the last build.
 
-		if ( !self->obj->explicitVertexInputBindingDescriptions.empty() ) {
-			hash_value = SpookyHash::Hash64( self->obj->explicitVertexInputBindingDescriptions.data(),
-			                                 self->obj->explicitVertexInputBindingDescriptions.size() * sizeof( le_vertex_input_binding_description ),
-			                                 hash_value );
+		if ( self->data_hash_dirty ) {
+			self->data_hash       = graphics_pipeline_data_hash( self->obj->data );
+			self->data_hash_dirty = false;
+		}
 
-			hash_value = SpookyHash::Hash64( self->obj->explicitVertexAttributeDescriptions.data(),
-			                                 self->obj->explicitVertexAttributeDescriptions.size() * sizeof( le_vertex_input_attribute_description ),
-			                                 hash_value );
+		if ( self->vertex_input_hash_dirty ) {
+			self->vertex_input_hash       = graphics_pipeline_vertex_input_hash( self->obj );
+			self->vertex_input_hash_dirty = false;
 		}
 
+		uint64_t hash_value = graphics_pipeline_hash( self->data_hash, self->obj->shaderStages.data(), self->obj->shaderStages.size(), self->vertex_input_hash );
+
 		// Cast hash_value to a pipeline handle, so we can use the type system with it
 		// its value, of course, is still equivalent to hash_value.
 
@@ -541,19 +626,19 @@ static void le_graphics_pipeline_builder_add_shader_stage( le_graphics_pipeline_
 // ----------------------------------------------------------------------
 
 static void input_assembly_state_set_primitive_restart_enable( le_graphics_pipeline_builder_o *self, uint32_t const &primitiveRestartEnable ) {
-	self->obj->data.inputAssemblyState.setPrimitiveRestartEnable( primitiveRestartEnable );
+	builder_data_for_write( self ).inputAssemblyState.setPrimitiveRestartEnable( primitiveRestartEnable );
 }
 
 // ----------------------------------------------------------------------
 
 static void input_assembly_state_set_toplogy( le_graphics_pipeline_builder_o *self, le::PrimitiveTopology const &topology ) {
-	self->obj->data.inputAssemblyState.setTopology( le_to_vk( topology ) );
+	builder_data_for_write( self ).inputAssemblyState.setTopology( le_to_vk( topology ) );
 }
 
 // ----------------------------------------------------------------------
 
 static void blend_attachment_state_set_blend_enable( le_graphics_pipeline_builder_o *self, size_t which_attachment, const bool &enable ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ].setBlendEnable( enable );
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ].setBlendEnable( enable );
 }
 
 // ----------------------------------------------------------------------
@@ -571,41 +656,41 @@ static vk::ColorComponentFlags le_color_component_flags_to_vk( LeColorComponentF
 }
 
 static void blend_attachment_state_set_blend_enable( le_graphics_pipeline_builder_o *self, size_t which_attachment, bool blendEnable ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setBlendEnable( blendEnable );
 }
 
 static void blend_attachment_state_set_color_blend_op( le_graphics_pipeline_builder_o *self, size_t which_attachment, const le::BlendOp &blendOp ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setColorBlendOp( le_blend_op_to_vk( blendOp ) );
 }
 
 static void blend_attachment_state_set_alpha_blend_op( le_graphics_pipeline_builder_o *self, size_t which_attachment, const le::BlendOp &blendOp ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setAlphaBlendOp( le_blend_op_to_vk( blendOp ) );
 }
 
 static void blend_attachment_state_set_src_color_blend_factor( le_graphics_pipeline_builder_o *self, size_t which_attachment, const le::BlendFactor &blendFactor ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setSrcColorBlendFactor( le_blend_factor_to_vk( blendFactor ) );
 }
 static void blend_attachment_state_set_dst_color_blend_factor( le_graphics_pipeline_builder_o *self, size_t which_attachment, const le::BlendFactor &blendFactor ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setDstColorBlendFactor( le_blend_factor_to_vk( blendFactor ) );
 }
 
 static void blend_attachment_state_set_src_alpha_blend_factor( le_graphics_pipeline_builder_o *self, size_t which_attachment, const le::BlendFactor &blendFactor ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setSrcAlphaBlendFactor( le_blend_factor_to_vk( blendFactor ) );
 }
 
 static void blend_attachment_state_set_dst_alpha_blend_factor( le_graphics_pipeline_builder_o *self, size_t which_attachment, const le::BlendFactor &blendFactor ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setDstAlphaBlendFactor( le_blend_factor_to_vk( blendFactor ) );
 }
 
 static void blend_attachment_state_set_color_write_mask( le_graphics_pipeline_builder_o *self, size_t which_attachment, const LeColorComponentFlags &write_mask ) {
-	self->obj->data.blendAttachmentStates[ which_attachment ]
+	builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 	    .setColorWriteMask( le_color_component_flags_to_vk( write_mask ) );
 }
 
@@ -615,7 +700,7 @@ static void blend_attachment_state_use_preset( le_graphics_pipeline_builder_o *s
 
 	case le::AttachmentBlendPreset::ePremultipliedAlpha: {
 
-		self->obj->data.blendAttachmentStates[ which_attachment ]
+		builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 		    .setBlendEnable( VK_TRUE )
 		    .setColorBlendOp( vk::BlendOp::eAdd )
 		    .setAlphaBlendOp( vk::BlendOp::eAdd )
@@ -634,7 +719,7 @@ static void blend_attachment_state_use_preset( le_graphics_pipeline_builder_o *s
 
 	case le::AttachmentBlendPreset::eAdd: {
 
-		self->obj->data.blendAttachmentStates[ which_attachment ]
+		builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 		    .setBlendEnable( VK_TRUE )
 		    .setColorBlendOp( vk::BlendOp::eAdd )
 		    .setAlphaBlendOp( vk::BlendOp::eAdd )
@@ -652,7 +737,7 @@ static void blend_attachment_state_use_preset( le_graphics_pipeline_builder_o *s
 	} break;
 	case le::AttachmentBlendPreset::eMultiply: {
 
-		self->obj->data.blendAttachmentStates[ which_attachment ]
+		builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 		    .setBlendEnable( VK_TRUE )
 		    .setColorBlendOp( vk::BlendOp::eAdd )
 		    .setSrcColorBlendFactor( vk::BlendFactor::eDstColor )
@@ -666,7 +751,7 @@ static void blend_attachment_state_use_preset( le_graphics_pipeline_builder_o *s
 	} break;
 	case le::AttachmentBlendPreset::eCopy: {
 
-		self->obj->data.blendAttachmentStates[ which_attachment ]
+		builder_data_for_write( self ).blendAttachmentStates[ which_attachment ]
 		    .setBlendEnable( VK_FALSE );
 
 	} break;
@@ -688,38 +773,38 @@ static inline vk::FrontFace le_front_face_to_vk( le::FrontFace const &front_face
 }
 
 static void tessellation_state_set_patch_control_points( le_graphics_pipeline_builder_o *self, uint32_t count ) {
-	self->obj->data.tessellationState.setPatchControlPoints( count );
+	builder_data_for_write( self ).tessellationState.setPatchControlPoints( count );
 }
 
 static void rasterization_state_set_depth_clamp_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.rasterizationInfo.setDepthClampEnable( enable );
+	builder_data_for_write( self ).rasterizationInfo.setDepthClampEnable( enable );
 }
 static void rasterization_state_set_rasterizer_discard_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.rasterizationInfo.setRasterizerDiscardEnable( enable );
+	builder_data_for_write( self ).rasterizationInfo.setRasterizerDiscardEnable( enable );
 }
 static void rasterization_state_set_polygon_mode( le_graphics_pipeline_builder_o *self, le::PolygonMode const &polygon_mode ) {
-	self->obj->data.rasterizationInfo.setPolygonMode( le_polygon_mode_to_vk( polygon_mode ) );
+	builder_data_for_write( self ).rasterizationInfo.setPolygonMode( le_polygon_mode_to_vk( polygon_mode ) );
 }
 static void rasterization_state_set_cull_mode( le_graphics_pipeline_builder_o *self, le::CullModeFlagBits const &cull_mode_flag_bits ) {
-	self->obj->data.rasterizationInfo.setCullMode( le_cull_mode_to_vk( cull_mode_flag_bits ) );
+	builder_data_for_write( self ).rasterizationInfo.setCullMode( le_cull_mode_to_vk( cull_mode_flag_bits ) );
 }
 static void rasterization_state_set_front_face( le_graphics_pipeline_builder_o *self, le::FrontFace const &front_face ) {
-	self->obj->data.rasterizationInfo.setFrontFace( le_front_face_to_vk( front_face ) );
+	builder_data_for_write( self ).rasterizationInfo.setFrontFace( le_front_face_to_vk( front_face ) );
 }
 static void rasterization_state_set_depth_bias_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.rasterizationInfo.setDepthBiasEnable( enable );
+	builder_data_for_write( self ).rasterizationInfo.setDepthBiasEnable( enable );
 }
 static void rasterization_state_set_depth_bias_constant_factor( le_graphics_pipeline_builder_o *self, float const &factor ) {
-	self->obj->data.rasterizationInfo.setDepthBiasConstantFactor( factor );
+	builder_data_for_write( self ).rasterizationInfo.setDepthBiasConstantFactor( factor );
 }
 static void rasterization_state_set_depth_bias_clamp( le_graphics_pipeline_builder_o *self, float const &clamp ) {
-	self->obj->data.rasterizationInfo.setDepthBiasClamp( clamp );
+	builder_data_for_write( self ).rasterizationInfo.setDepthBiasClamp( clamp );
 }
 static void rasterization_state_set_depth_bias_slope_factor( le_graphics_pipeline_builder_o *self, float const &factor ) {
-	self->obj->data.rasterizationInfo.setDepthBiasSlopeFactor( factor );
+	builder_data_for_write( self ).rasterizationInfo.setDepthBiasSlopeFactor( factor );
 }
 static void rasterization_state_set_line_width( le_graphics_pipeline_builder_o *self, float const &line_width ) {
-	self->obj->data.rasterizationInfo.setLineWidth( line_width );
+	builder_data_for_write( self ).rasterizationInfo.setLineWidth( line_width );
 }
 
 // ----------------------------------------------------------------------
@@ -728,20 +813,20 @@ static inline vk::SampleCountFlagBits le_sample_count_flags_to_vk( le::SampleCou
 }
 
 static void multisample_state_set_rasterization_samples( le_graphics_pipeline_builder_o *self, le::SampleCountFlagBits const &num_samples ) {
-	self->obj->data.multisampleState.setRasterizationSamples( le_sample_count_flags_to_vk( num_samples ) );
+	builder_data_for_write( self ).multisampleState.setRasterizationSamples( le_sample_count_flags_to_vk( num_samples ) );
 }
 
 static void multisample_state_set_sample_shading_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.multisampleState.setSampleShadingEnable( enable );
+	builder_data_for_write( self ).multisampleState.setSampleShadingEnable( enable );
 }
 static void multisample_state_set_min_sample_shading( le_graphics_pipeline_builder_o *self, float const &min_sample_shading ) {
-	self->obj->data.multisampleState.setMinSampleShading( min_sample_shading );
+	builder_data_for_write( self ).multisampleState.setMinSampleShading( min_sample_shading );
 }
 static void multisample_state_set_alpha_to_coverage_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.multisampleState.setAlphaToCoverageEnable( enable );
+	builder_data_for_write( self ).multisampleState.setAlphaToCoverageEnable( enable );
 }
 static void multisample_state_set_alpha_to_one_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.multisampleState.setAlphaToOneEnable( enable );
+	builder_data_for_write( self ).multisampleState.setAlphaToOneEnable( enable );
 }
 
 // ----------------------------------------------------------------------
@@ -755,69 +840,185 @@ static inline vk::CompareOp le_compare_op_to_vk( le::CompareOp const &rhs ) {
 }
 
 static void stencil_op_state_front_set_fail_op( le_graphics_pipeline_builder_o *self, le::StencilOp const &op ) {
-	self->obj->data.depthStencilState.front.setFailOp( le_stencil_op_state_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.front.setFailOp( le_stencil_op_state_to_vk( op ) );
 }
 static void stencil_op_state_front_set_pass_op( le_graphics_pipeline_builder_o *self, le::StencilOp const &op ) {
-	self->obj->data.depthStencilState.front.setPassOp( le_stencil_op_state_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.front.setPassOp( le_stencil_op_state_to_vk( op ) );
 }
 static void stencil_op_state_front_set_depth_fail_op( le_graphics_pipeline_builder_o *self, le::StencilOp const &op ) {
-	self->obj->data.depthStencilState.front.setDepthFailOp( le_stencil_op_state_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.front.setDepthFailOp( le_stencil_op_state_to_vk( op ) );
 }
 static void stencil_op_state_front_set_compare_op( le_graphics_pipeline_builder_o *self, le::CompareOp const &op ) {
-	self->obj->data.depthStencilState.front.setCompareOp( le_compare_op_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.front.setCompareOp( le_compare_op_to_vk( op ) );
 }
 static void stencil_op_state_front_set_compare_mask( le_graphics_pipeline_builder_o *self, uint32_t const &mask ) {
-	self->obj->data.depthStencilState.front.setCompareMask( mask );
+	builder_data_for_write( self ).depthStencilState.front.setCompareMask( mask );
 }
 static void stencil_op_state_front_set_write_mask( le_graphics_pipeline_builder_o *self, uint32_t const &mask ) {
-	self->obj->data.depthStencilState.front.setWriteMask( mask );
+	builder_data_for_write( self ).depthStencilState.front.setWriteMask( mask );
 }
 static void stencil_op_state_front_set_reference( le_graphics_pipeline_builder_o *self, uint32_t const &reference ) {
-	self->obj->data.depthStencilState.front.setReference( reference );
+	builder_data_for_write( self ).depthStencilState.front.setReference( reference );
 }
 
 static void stencil_op_state_back_set_fail_op( le_graphics_pipeline_builder_o *self, le::StencilOp const &op ) {
-	self->obj->data.depthStencilState.back.setFailOp( le_stencil_op_state_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.back.setFailOp( le_stencil_op_state_to_vk( op ) );
 }
 static void stencil_op_state_back_set_pass_op( le_graphics_pipeline_builder_o *self, le::StencilOp const &op ) {
-	self->obj->data.depthStencilState.back.setPassOp( le_stencil_op_state_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.back.setPassOp( le_stencil_op_state_to_vk( op ) );
 }
 static void stencil_op_state_back_set_depth_fail_op( le_graphics_pipeline_builder_o *self, le::StencilOp const &op ) {
-	self->obj->data.depthStencilState.back.setDepthFailOp( le_stencil_op_state_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.back.setDepthFailOp( le_stencil_op_state_to_vk( op ) );
 }
 static void stencil_op_state_back_set_compare_op( le_graphics_pipeline_builder_o *self, le::CompareOp const &op ) {
-	self->obj->data.depthStencilState.back.setCompareOp( le_compare_op_to_vk( op ) );
+	builder_data_for_write( self ).depthStencilState.back.setCompareOp( le_compare_op_to_vk( op ) );
 }
 static void stencil_op_state_back_set_compare_mask( le_graphics_pipeline_builder_o *self, uint32_t const &mask ) {
-	self->obj->data.depthStencilState.back.setCompareMask( mask );
+	builder_data_for_write( self ).depthStencilState.back.setCompareMask( mask );
 }
 static void stencil_op_state_back_set_write_mask( le_graphics_pipeline_builder_o *self, uint32_t const &mask ) {
-	self->obj->data.depthStencilState.back.setWriteMask( mask );
+	builder_data_for_write( self ).depthStencilState.back.setWriteMask( mask );
 }
 static void stencil_op_state_back_set_reference( le_graphics_pipeline_builder_o *self, uint32_t const &reference ) {
-	self->obj->data.depthStencilState.back.setReference( reference );
+	builder_data_for_write( self ).depthStencilState.back.setReference( reference );
 }
 
 static void depth_stencil_state_set_depth_test_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.depthStencilState.setDepthTestEnable( enable );
+	builder_data_for_write( self ).depthStencilState.setDepthTestEnable( enable );
 }
 static void depth_stencil_state_set_depth_write_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.depthStencilState.setDepthWriteEnable( enable );
+	builder_data_for_write( self ).depthStencilState.setDepthWriteEnable( enable );
 }
 static void depth_stencil_state_set_depth_compare_op( le_graphics_pipeline_builder_o *self, le::CompareOp const &compare_op ) {
-	self->obj->data.depthStencilState.setDepthCompareOp( le_compare_op_to_vk( compare_op ) );
+	builder_data_for_write( self ).depthStencilState.setDepthCompareOp( le_compare_op_to_vk( compare_op ) );
 }
 static void depth_stencil_state_set_depth_bounds_test_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.depthStencilState.setDepthBoundsTestEnable( enable );
+	builder_data_for_write( self ).depthStencilState.setDepthBoundsTestEnable( enable );
 }
 static void depth_stencil_state_set_stencil_test_enable( le_graphics_pipeline_builder_o *self, bool const &enable ) {
-	self->obj->data.depthStencilState.setStencilTestEnable( enable );
+	builder_data_for_write( self ).depthStencilState.setStencilTestEnable( enable );
 }
 static void depth_stencil_state_set_min_depth_bounds( le_graphics_pipeline_builder_o *self, float const &min_bounds ) {
-	self->obj->data.depthStencilState.setMinDepthBounds( min_bounds );
+	builder_data_for_write( self ).depthStencilState.setMinDepthBounds( min_bounds );
 }
 static void depth_stencil_state_set_max_depth_bounds( le_graphics_pipeline_builder_o *self, float const &max_bounds ) {
-	self->obj->data.depthStencilState.setMaxDepthBounds( max_bounds );
+	builder_data_for_write( self ).depthStencilState.setMaxDepthBounds( max_bounds );
+}
+
+// ----------------------------------------------------------------------
+// Translates description into pipeline state data of `pso` - state which is
+// not part of the description keeps the builder's defaults.
+static void graphics_pipeline_data_from_description( graphics_pipeline_state_o &pso, le_graphics_pipeline_description_t const *description ) {
+
+	auto &data = pso.data;
+
+	graphics_pipeline_builder_data_set_defaults( data );
+
+	data.inputAssemblyState
+	    .setTopology( le_to_vk( description->topology ) )
+	    .setPrimitiveRestartEnable( description->primitive_restart_enable );
+
+	data.rasterizationInfo
+	    .setPolygonMode( le_polygon_mode_to_vk( description->polygon_mode ) )
+	    .setCullMode( le_cull_mode_to_vk( description->cull_mode ) )
+	    .setFrontFace( le_front_face_to_vk( description->front_face ) )
+	    .setLineWidth( description->line_width )
+	    .setDepthBiasEnable( description->depth_bias_enable )
+	    .setDepthBiasConstantFactor( description->depth_bias_constant_factor )
+	    .setDepthBiasSlopeFactor( description->depth_bias_slope_factor );
+
+	data.multisampleState
+	    .setRasterizationSamples( le_sample_count_flags_to_vk( description->rasterization_samples ) )
+	    .setSampleShadingEnable( description->sample_shading_enable )
+	    .setMinSampleShading( description->min_sample_shading );
+
+	data.depthStencilState
+	    .setDepthTestEnable( description->depth_test_enable )
+	    .setDepthWriteEnable( description->depth_write_enable )
+	    .setDepthCompareOp( le_compare_op_to_vk( description->depth_compare_op ) );
+
+	{
+		// Blend presets are applied via a builder facade, so that they are guaranteed
+		// to match what the builder does for the same preset.
+		le_graphics_pipeline_builder_o facade{ &pso, nullptr };
+
+		size_t const num_attachments = std::min( data.blendAttachmentStates.size(), le_graphics_pipeline_description_t::MAX_BLEND_ATTACHMENTS );
+
+		for ( size_t i = 0; i != num_attachments; i++ ) {
+			blend_attachment_state_use_preset( &facade, i, description->blend_presets[ i ] );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+// Builds a graphics pipeline from a static description.
+//
+// `description_hash` must be `description->hash()` - it is passed in so that
+// callers with a constexpr description may calculate it at compile time.
+//
+// Descriptions produce the same handles as builders with the same state, which
+// means that we must hash the Vulkan state which a description translates into.
+// We remember this hash per description, so that in the common case, building
+// costs one lookup by `description_hash`, mixing in shader stage hashes, and
+// one lookup in the pipeline cache - pipeline state only gets translated into
+// Vulkan state if we have not seen the description before.
+static le_gpso_handle le_graphics_pipeline_builder_build_from_description( le_pipeline_manager_o *pipelineCache, le_graphics_pipeline_description_t const *description, uint64_t description_hash, le_shader_module_o *const *shader_stages, size_t shader_stages_count ) {
+
+	assert( description_hash == description->hash() && "description_hash must be description->hash()" );
+
+	// Hashes over pipeline state data per description. Applications only use a
+	// handful of descriptions, and keeping one table per thread means we don't
+	// need to lock. We keep a copy of each description, since `description_hash`
+	// is only a fingerprint, which we must not trust on its own.
+
+	struct DataHashEntry {
+		le_graphics_pipeline_description_t description;
+		uint64_t                           data_hash;
+	};
+
+	static thread_local std::unordered_map<uint64_t, DataHashEntry> data_hash_for_description;
+
+	// We fill in a per-thread scratch pipeline state object - the pipeline manager
+	// only copies it if it has not seen this pipeline yet. Re-using the scratch
+	// object means that we don't allocate once its shaderStages vector has grown
+	// to size.
+
+	static thread_local graphics_pipeline_state_o pso;
+
+	bool has_data = false; // whether pso.data holds the state for this description
+
+	auto it = data_hash_for_description.find( description_hash );
+
+	if ( it == data_hash_for_description.end() || it->second.description != *description ) {
+		graphics_pipeline_data_from_description( pso, description );
+		has_data = true;
+
+		it = data_hash_for_description.insert_or_assign( description_hash, DataHashEntry{ *description, graphics_pipeline_data_hash( pso.data ) } ).first;
+	}
+
+	uint64_t hash_value = graphics_pipeline_hash( it->second.data_hash, shader_stages, shader_stages_count, 0 );
+
+	auto pipeline_handle = reinterpret_cast<le_gpso_handle>( hash_value );
+
+	using namespace le_backend_vk;
+
+	if ( le_pipeline_manager_i.has_graphics_pipeline_state( pipelineCache, pipeline_handle ) ) {
+		// Common case: the pipeline manager has seen this pipeline before, and
+		// we don't need to translate the description into pipeline state.
+		return pipeline_handle;
+	}
+
+	if ( !has_data ) {
+		graphics_pipeline_data_from_description( pso, description );
+	}
+
+	pso.shaderStages.assign( shader_stages, shader_stages + shader_stages_count );
+	pso.explicitVertexAttributeDescriptions.clear();
+	pso.explicitVertexInputBindingDescriptions.clear();
+
+	le_pipeline_manager_i.introduce_graphics_pipeline_state( pipelineCache, &pso, pipeline_handle );
+
+	return pipeline_handle;
 }
 
 // ----------------------------------------------------------------------
@@ -831,6 +1032,7 @@ LE_MODULE_REGISTER_IMPL( le_pipeline_builder, api ) {
 		i.create                                  = le_graphics_pipeline_builder_create;
 		i.destroy                                 = le_graphics_pipeline_builder_destroy;
 		i.build                                   = le_graphics_pipeline_builder_build;
+		i.build_from_description                  = le_graphics_pipeline_builder_build_from_description;
 		i.add_shader_stage                        = le_graphics_pipeline_builder_add_shader_stage;
 		i.set_vertex_input_attribute_descriptions = le_graphics_pipeline_builder_set_vertex_input_attribute_descriptions;
 		i.set_vertex_input_binding_descriptions   = le_graphics_pipeline_builder_set_vertex_input_binding_descriptions;
@@ -14,6 +14,7 @@ struct le_graphics_pipeline_builder_o;
 struct le_compute_pipeline_builder_o;
 struct le_rtx_pipeline_builder_o;
 struct le_rtx_shader_group_info;
+struct le_graphics_pipeline_description_t; // see le_graphics_pipeline_description.h
 
 struct le_vertex_input_binding_description;
 struct le_vertex_input_attribute_description;
@@ -56,6 +57,9 @@ struct le_pipeline_builder_api {
 
 		le_gpso_handle_t* ( * build             ) ( le_graphics_pipeline_builder_o* self );
 
+		// Builds a pipeline from a static description - description_hash must be description->hash(), which may be calculated at compile time.
+		le_gpso_handle_t* ( * build_from_description ) ( le_pipeline_manager_o *pipeline_cache, le_graphics_pipeline_description_t const * description, uint64_t description_hash, le_shader_module_o* const * shader_stages, size_t shader_stages_count );
+
 		struct attribute_binding_state_t{
 			void (*add_binding)( le_graphics_pipeline_builder_o* self, uint8_t binding_number);
 			void (*set_binding_input_rate )( le_graphics_pipeline_builder_o* self, uint8_t binding_number, const le_vertex_input_rate& input_rate);
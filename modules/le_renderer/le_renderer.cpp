@@ -1,5 +1,6 @@
 #include "le_core/le_core.h"
 #include "le_core/hash_util.h" // fixme-we shouldn't do that.
+#include "le_core/concurrent_hash_table.h"
 
 #include "le_renderer/le_renderer.h"
 
@@ -11,7 +12,7 @@
 #include <chrono>
 #include <vector>
 #include "assert.h"
-#include <mutex>
+#include <atomic>
 #include <algorithm>
 
 const uint64_t LE_RENDERPASS_MARKER_EXTERNAL = hash_64_fnv1a_const( "rp-external" );
@@ -19,6 +20,7 @@ const uint64_t LE_RENDERPASS_MARKER_EXTERNAL = hash_64_fnv1a_const( "rp-external
 using NanoTime = std::chrono::time_point<std::chrono::high_resolution_clock>;
 
 #include "le_jobs/le_jobs.h"
+#include "le_trace/le_trace.h"
 
 #ifndef LE_MT
 #	define LE_MT 0
@@ -62,13 +64,21 @@ struct FrameData {
 	Meta   meta;
 };
 
+// Texture handles are interned: there is exactly one handle per texture name.
+// Handles are immutable once published, and live until the renderer is destroyed.
 struct le_texture_handle_t {
-	std::string debug_name;
+	std::string          debug_name;
+	uint64_t             name_hash     = 0;       // hash_64_fnv1a of debug_name, 0 for unnamed handles
+	le_texture_handle_t *next_in_store = nullptr; // next unnamed handle - used for cleanup
 };
 
+// Named texture handles live in a concurrent hash table, keyed by name, which
+// owns them - see `ConcurrentHashTable`. Lookups need no locks, and handles
+// stay put once published. Unnamed handles can never be looked up, and are
+// only kept in a list, so that we can delete them once the renderer is destroyed.
 struct le_texture_handle_store_t {
-	std::vector<le_texture_handle_t *> texture_handles;
-	std::mutex                         mtx;
+	ConcurrentHashTable<le_texture_handle_t, 4096> named_handles;
+	std::atomic<le_texture_handle_t *>             unnamed_handles{ nullptr }; // head of list of unnamed handles
 };
 
 static le_texture_handle_store_t *texture_handle_library{ nullptr };
@@ -76,11 +86,12 @@ static le_texture_handle_store_t *texture_handle_library{ nullptr };
 // ----------------------------------------------------------------------
 
 struct le_renderer_o {
-	uint64_t      swapchainDirty = false;
-	le_backend_o *backend        = nullptr; // Owned, created in setup
+	uint64_t      swapchainDirty                = false;
+	uint64_t      swapchainsWithChangedSettings = 0;       // bitfield, one bit per swapchain index: swapchains which must be re-created with changed settings
+	le_backend_o *backend                       = nullptr; // Owned, created in setup
 
-	std::vector<FrameData>               frames;
-	size_t                               numSwapchainImages = 0;
+	std::vector<FrameData>               frames;                 // frames in flight - count fixed at setup, see renderer_set_swapchain_imagecount
+	size_t                               numSwapchainImages = 0; // number of images of first swapchain at setup
 	size_t                               currentFrameNumber = size_t( ~0 ); // ever increasing number of current frame
 	std::vector<le_swapchain_settings_t> swapchain_settings{};              // default swapchain settings
 };
@@ -103,36 +114,41 @@ static le_renderer_o *renderer_create() {
 	return obj;
 }
 
-// creates a new handle if no name was given, or given name was not found in list of current handles.
-static le_texture_handle renderer_produce_texture_handle( char const *maybe_name ) {
+// Adds handle to list of unnamed handles, so that it can be deleted once the renderer is destroyed.
+static void texture_handle_store_add_unnamed( le_texture_handle_store_t *store, le_texture_handle_t *handle ) {
+	handle->next_in_store = store->unnamed_handles.load( std::memory_order_relaxed );
+	while ( !store->unnamed_handles.compare_exchange_weak( handle->next_in_store, handle, std::memory_order_release, std::memory_order_relaxed ) ) {
+	}
+}
 
-	// TODO: use shared mutex.
+// ----------------------------------------------------------------------
+// Returns handle for name - name_hash must be hash_64_fnv1a( name ).
+// Creates, and publishes a new handle if no handle with this name exists yet.
+static le_texture_handle renderer_produce_texture_handle_with_hash( char const *name, uint64_t name_hash ) {
 
-	// lock renderer for reading/writing
-	std::scoped_lock lock( texture_handle_library->mtx );
+	assert( name && name_hash == hash_64_fnv1a( name ) && "name_hash must be hash_64_fnv1a( name )" );
 
-	if ( maybe_name ) {
+	return texture_handle_library->named_handles.find_or_insert(
+	    name_hash,
+	    [ & ]( le_texture_handle_t const &h ) { return h.debug_name == name; },
+	    [ & ]() { return le_texture_handle_t{ name, name_hash }; } );
+}
 
-		auto found_el = std::find_if(
-		    texture_handle_library->texture_handles.begin(),
-		    texture_handle_library->texture_handles.end(),
-		    [ maybe_name ]( le_texture_handle_t *rhs ) -> bool {
-			    return rhs->debug_name == maybe_name;
-		    } );
-		if ( found_el != texture_handle_library->texture_handles.end() ) {
-			return *found_el;
-		}
+// ----------------------------------------------------------------------
+// creates a new handle if no name was given, or given name was not found in list of current handles.
+static le_texture_handle renderer_produce_texture_handle( char const *maybe_name ) {
+
+	if ( maybe_name ) {
+		return renderer_produce_texture_handle_with_hash( maybe_name, hash_64_fnv1a( maybe_name ) );
 	}
 
-	// --------| invariant: no name given, or name not found.
+	// --------| invariant: no name given
 
-	auto handle =
-	    maybe_name
-	        ? new le_texture_handle_t{ maybe_name } // If name was not found, we must create a new entry.
-	        : new le_texture_handle_t{};            // If no name was given, there is no way for the handle already to exist;
-	                                                // we must return a new unnamed entry.
+	// If no name was given, there is no way for the handle already to exist;
+	// we must return a new unnamed entry.
+	auto handle = new le_texture_handle_t{};
 
-	texture_handle_library->texture_handles.push_back( handle );
+	texture_handle_store_add_unnamed( texture_handle_library, handle );
 
 	return handle;
 }
@@ -165,8 +181,11 @@ static void renderer_destroy( le_renderer_o *self ) {
 
 	if ( texture_handle_library ) {
 
-		for ( auto &h : texture_handle_library->texture_handles ) {
+		// Named handles are owned, and deleted, by the store.
+		for ( auto h = texture_handle_library->unnamed_handles.load(); h != nullptr; ) {
+			auto next = h->next_in_store;
 			delete ( h );
+			h = next;
 		}
 
 		delete ( texture_handle_library );
@@ -320,6 +339,8 @@ static void renderer_clear_frame( le_renderer_o *self, size_t frameIndex ) {
 
 static void renderer_record_frame( le_renderer_o *self, size_t frameIndex, le_render_module_o *module_, size_t frameNumber ) {
 
+	LE_TRACE_ZONE( "renderer_record_frame" );
+
 	// High-level
 	// - resolve rendergraph: which render passes do contribute?
 	// - consolidate resources, synchronisation for resources
@@ -366,6 +387,8 @@ static void renderer_record_frame( le_renderer_o *self, size_t frameIndex, le_re
 
 static const FrameData::State &renderer_acquire_backend_resources( le_renderer_o *self, size_t frameIndex ) {
 
+	LE_TRACE_ZONE( "renderer_acquire_backend_resources" );
+
 	using namespace le_backend_vk; // for vk_bakend_i
 	using namespace le_renderer;   // for rendergraph_i
 
@@ -428,6 +451,8 @@ static const FrameData::State &renderer_acquire_backend_resources( le_renderer_o
 
 static const FrameData::State &renderer_process_frame( le_renderer_o *self, size_t frameIndex ) {
 
+	LE_TRACE_ZONE( "renderer_process_frame" );
+
 	using namespace le_backend_vk; // for vk_bakend_i
 
 	auto &frame = self->frames[ frameIndex ];
@@ -457,6 +482,8 @@ static const FrameData::State &renderer_process_frame( le_renderer_o *self, size
 
 static void renderer_dispatch_frame( le_renderer_o *self, size_t frameIndex ) {
 
+	LE_TRACE_ZONE( "renderer_dispatch_frame" );
+
 	using namespace le_backend_vk; // for vk_backend_i
 	auto &frame = self->frames[ frameIndex ];
 
@@ -509,8 +536,68 @@ static void renderer_get_swapchain_extent( le_renderer_o *self, uint32_t index,
 
 // ----------------------------------------------------------------------
 
+static bool renderer_get_swapchain_stats( le_renderer_o *self, uint32_t index, le_swapchain_stats_t *stats ) {
+	using namespace le_backend_vk; // for swapchain
+	return vk_backend_i.get_swapchain_stats( self->backend, index, stats );
+}
+
+// ----------------------------------------------------------------------
+// Returns settings for swapchain at index if this swapchain may be re-created
+// with changed present mode or image count, nullptr otherwise.
+static le_swapchain_settings_t *renderer_get_mutable_swapchain_settings( le_renderer_o *self, uint32_t index ) {
+
+	assert( index < self->swapchain_settings.size() );
+
+	auto &settings = self->swapchain_settings[ index ];
+
+	if ( settings.type == le_swapchain_settings_t::Type::LE_IMG_SWAPCHAIN ) {
+		std::cout << "WARNING: Swapchain " << index << " is an image swapchain, which does not allow changing present mode, or image count at runtime." << std::endl
+		          << std::flush;
+		return nullptr;
+	}
+
+	return &settings;
+}
+
+// ----------------------------------------------------------------------
+// Change takes effect at the end of the next renderer update.
+static void renderer_set_swapchain_presentmode( le_renderer_o *self, uint32_t index, le::Presentmode presentmode ) {
+
+	auto settings = renderer_get_mutable_swapchain_settings( self, index );
+
+	if ( settings && settings->khr_settings.presentmode_hint != presentmode ) {
+		settings->khr_settings.presentmode_hint = presentmode;
+		self->swapchainsWithChangedSettings |= ( 1ull << index );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Change takes effect at the end of the next renderer update.
+// Note that the swapchain may clamp the number of images to what the surface supports.
+//
+// This does not change the number of frames in flight, neither ours nor the
+// backend's: both are fixed at setup. They don't need to match the image
+// count - every frame acquires whichever swapchain image is next, and
+// presents it within the same update, so a frame never holds on to an
+// image. Fewer images than frames only means that acquire may block until
+// the presentation engine releases an image.
+static void renderer_set_swapchain_imagecount( le_renderer_o *self, uint32_t index, uint32_t imagecount ) {
+
+	auto settings = renderer_get_mutable_swapchain_settings( self, index );
+
+	if ( settings && settings->imagecount_hint != imagecount ) {
+		settings->imagecount_hint = imagecount;
+		self->swapchainsWithChangedSettings |= ( 1ull << index );
+	}
+}
+
+// ----------------------------------------------------------------------
+
 static void renderer_update( le_renderer_o *self, le_render_module_o *module_ ) {
 
+	LE_TRACE_FRAME_MARK( "frame" );
+	LE_TRACE_ZONE( "renderer_update" );
+
 	using namespace le_backend_vk; // for vk_backend_i
 
 	const auto &index     = self->currentFrameNumber;
@@ -647,6 +734,38 @@ static void renderer_update( le_renderer_o *self, le_render_module_o *module_ )
 		self->swapchainDirty = false;
 	}
 
+	if ( self->swapchainsWithChangedSettings ) {
+		// Settings for some swapchains were changed via the api. Unlike failed
+		// swapchains, these swapchains are still in use by frames in flight, which
+		// means we must wait for all frames to come back before we may re-create
+		// swapchains - otherwise we would pull images from under frames in flight.
+		//
+		// Frames which were recorded, but not yet processed, are taken through
+		// to dispatch first, so that no recorded frame gets dropped. We visit
+		// frames oldest first, so that frames get presented in order: the frame
+		// after the one we recorded this update is the oldest one.
+
+		for ( size_t i = 0; i != numFrames; ++i ) {
+			size_t const frame_index = ( index + 1 + i ) % numFrames;
+			// Each of these is a no-op unless the frame is in the state it expects.
+			renderer_acquire_backend_resources( self, frame_index );
+			renderer_process_frame( self, frame_index );
+			renderer_dispatch_frame( self, frame_index );
+		}
+
+		for ( size_t i = 0; i != numFrames; ++i ) {
+			renderer_clear_frame( self, ( index + 1 + i ) % numFrames ); // waits for frame fence if frame was dispatched
+		}
+
+		for ( uint32_t i = 0; i != self->swapchain_settings.size(); ++i ) {
+			if ( self->swapchainsWithChangedSettings & ( 1ull << i ) ) {
+				vk_backend_i.reset_swapchain_with_settings( self->backend, i, &self->swapchain_settings[ i ] );
+			}
+		}
+
+		self->swapchainsWithChangedSettings = 0;
+	}
+
 	++self->currentFrameNumber;
 }
 
@@ -701,12 +820,18 @@ LE_MODULE_REGISTER_IMPL( le_renderer, api ) {
 	le_renderer_i.create_shader_module   = renderer_create_shader_module;
 	le_renderer_i.get_swapchain_resource = renderer_get_swapchain_resource;
 	le_renderer_i.get_swapchain_extent   = renderer_get_swapchain_extent;
+	le_renderer_i.get_swapchain_stats    = renderer_get_swapchain_stats;
 	le_renderer_i.get_pipeline_manager   = renderer_get_pipeline_manager;
 	le_renderer_i.get_backend            = renderer_get_backend;
 
+	le_renderer_i.set_swapchain_presentmode = renderer_set_swapchain_presentmode;
+	le_renderer_i.set_swapchain_imagecount  = renderer_set_swapchain_imagecount;
+
 	le_renderer_i.texture_handle_get_name = texture_handle_get_name;
 
-	le_renderer_i.produce_texture_handle = renderer_produce_texture_handle;
+	le_renderer_i.produce_texture_handle           = renderer_produce_texture_handle;
+	le_renderer_i.produce_texture_handle_with_hash = renderer_produce_texture_handle_with_hash;
+
 	le_renderer_i.create_rtx_blas_info   = renderer_create_rtx_blas_info_handle;
 	le_renderer_i.create_rtx_tlas_info   = renderer_create_rtx_tlas_info_handle;
 
@@ -33,12 +33,22 @@ struct le_renderer_api {
 		/// returns the resource handle for the current swapchain image
 		le_resource_handle_t           ( *get_swapchain_resource                )( le_renderer_o* self, uint32_t index );
 		void                           ( *get_swapchain_extent                  )( le_renderer_o* self, uint32_t index, uint32_t* p_width, uint32_t* p_height );
+
+		/// returns false if swapchain does not collect frame pacing statistics (image swapchains)
+		bool                           ( *get_swapchain_stats                   )( le_renderer_o* self, uint32_t index, le_swapchain_stats_t* stats );
+
+		/// swapchain is re-created with new present mode / image count at the end of the next update - does not apply to image swapchains
+		/// the number of frames in flight is fixed at setup, and does not follow the swapchain image count
+		void                           ( *set_swapchain_presentmode             )( le_renderer_o* self, uint32_t index, le::Presentmode presentmode );
+		void                           ( *set_swapchain_imagecount              )( le_renderer_o* self, uint32_t index, uint32_t imagecount );
+
 		le_backend_o*                  ( *get_backend                           )( le_renderer_o* self );
 
 		le_pipeline_manager_o*         ( *get_pipeline_manager                  )( le_renderer_o* self );
 
         struct le_texture_handle_store_t * le_texture_handle_store = nullptr;
         le_texture_handle              ( *produce_texture_handle                )(char const * maybe_name );
+        le_texture_handle              ( *produce_texture_handle_with_hash      )(char const * name, uint64_t name_hash ); // name_hash must be hash_64_fnv1a(name), see LE_TEXTURE_HANDLE
         char const *                   ( *texture_handle_get_name               )(le_texture_handle handle);
 
 		le_rtx_blas_info_handle        ( *create_rtx_blas_info ) (le_renderer_o* self, le_rtx_geometry_t* geometries, uint32_t geometries_count, LeBuildAccelerationStructureFlags const * flags);
@@ -207,6 +217,10 @@ static const auto &helpers_i       = api -> helpers_i;
 
 } // namespace le_renderer
 
+// Returns texture handle for a string literal name - name hash is calculated at compile time.
+#	define LE_TEXTURE_HANDLE( name ) \
+		le_renderer::renderer_i.produce_texture_handle_with_hash( name, []() { constexpr uint64_t name_hash = hash_64_fnv1a_const( name ); return name_hash; }() )
+
 namespace le {
 
 class Renderer {
@@ -252,6 +266,18 @@ class Renderer {
 		return result;
 	}
 
+	bool getSwapchainStats( le_swapchain_stats_t *stats, uint32_t index = 0 ) const {
+		return le_renderer::renderer_i.get_swapchain_stats( self, index, stats );
+	}
+
+	void setSwapchainPresentmode( le::Presentmode presentmode, uint32_t index = 0 ) {
+		le_renderer::renderer_i.set_swapchain_presentmode( self, index, presentmode );
+	}
+
+	void setSwapchainImagecount( uint32_t imagecount, uint32_t index = 0 ) {
+		le_renderer::renderer_i.set_swapchain_imagecount( self, index, imagecount );
+	}
+
 	le_pipeline_manager_o *getPipelineManager() const {
 		return le_renderer::renderer_i.get_pipeline_manager( self );
 	}
@@ -260,6 +286,12 @@ class Renderer {
 		return le_renderer::renderer_i.produce_texture_handle( maybe_name );
 	}
 
+	// name_hash must be hash_64_fnv1a( name ) - use LE_TEXTURE_HANDLE for string literals,
+	// which calculates the hash at compile time.
+	static le_texture_handle produceTextureHandle( char const *name, uint64_t name_hash ) {
+		return le_renderer::renderer_i.produce_texture_handle_with_hash( name, name_hash );
+	}
+
 	operator auto() {
 		return self;
 	}
@@ -14,6 +14,7 @@
 #include <array>
 
 #include "le_renderer/private/le_renderer_types.h"
+#include "le_trace/le_trace.h"
 
 #ifdef _MSC_VER
 	#include <Windows.h>
@@ -799,6 +800,8 @@ generate_dot_file_for_rendergraph(
 //
 static void rendergraph_build( le_rendergraph_o *self, size_t frame_number ) {
 
+	LE_TRACE_ZONE( "rendergraph_build" );
+
 	// We must express our list of passes as a list of tasks.
 	// A task holds two bitfields, the bitfield names are: `read` and `write`.
 	// Each bit in the bitfield represents a possible resource.
@@ -1018,7 +1018,22 @@ struct le_swapchain_settings_t {
 		struct le_window_o *   window;
 	};
 	struct img_settings_t {
-		char const *pipe_cmd; // command used to save images - will receive stream of images via stdin
+		enum class Backpressure : uint32_t {
+			eWait = 0,   // render thread waits for a free readback buffer - no frames are lost
+			eDropFrames, // frames are dropped while all readback buffers are busy
+		};
+		enum class Encoding : uint32_t {
+			eNone = 0, // frames are sent to pipe_cmd
+			eQoi,      // frames are encoded to an image sequence of .qoi files
+			ePng,      // frames are encoded to an image sequence of (uncompressed) .png files
+		};
+		char const * pipe_cmd                   = nullptr;             // command used to save images - will receive stream of images via stdin
+		uint32_t     readback_buffer_count_hint = 0;                   // number of readback buffers in flight, 0 means twice the number of swapchain images
+		Backpressure backpressure               = Backpressure::eWait; // what to do if all readback buffers are busy
+		char const * shm_name                   = nullptr;             // if set, frames are published to a shared memory ring of this name (e.g. "/isl_frames") instead of pipe_cmd
+		uint32_t     shm_slot_count             = 3;                   // number of frame slots in shared memory ring
+		Encoding     encoding                   = Encoding::eNone;     // if set, frames are encoded on le_jobs workers to an image sequence instead of pipe_cmd
+		uint32_t     encode_max_in_flight       = 0;                   // max number of frames being encoded at the same time, 0 means number of worker threads
 	};
 
 	Type       type            = LE_KHR_SWAPCHAIN;
@@ -1033,6 +1048,40 @@ struct le_swapchain_settings_t {
 	};
 };
 
+// Frame pacing statistics for a swapchain, see renderer_i.get_swapchain_stats.
+// Min/max/avg values are calculated over a rolling window of the most recent frames.
+// Statistics are only available for swapchains which present to a display (khr, direct).
+struct le_swapchain_stats_t {
+	using Presentmode = le_swapchain_settings_t::khr_settings_t::Presentmode;
+
+	uint64_t    frames_presented = 0;                  // total number of frames presented via this swapchain
+	uint64_t    missed_vblanks   = 0;                  // total number of missed vblanks (estimated, fifo present modes only)
+	Presentmode presentmode      = Presentmode::eFifo; // currently active present mode
+	uint32_t    imagecount       = 0;                  // current number of swapchain images
+
+	float refresh_period_ms = 0; // display refresh period - as reported by display, otherwise estimated from present intervals; 0 if unknown
+
+	float acquire_wait_ms_last = 0; // time spent blocking in acquire
+	float acquire_wait_ms_avg  = 0; //
+	float acquire_wait_ms_max  = 0; //
+
+	float present_interval_ms_last = 0; // time between subsequent presents
+	float present_interval_ms_avg  = 0; //
+	float present_interval_ms_min  = 0; //
+	float present_interval_ms_max  = 0; //
+
+	// Time from acquiring an image until it was observed on the display, which
+	// approximates input-to-photon latency for applications that sample input
+	// immediately before acquire. Only available if the backend was compiled with
+	// LE_FEATURE_PRESENT_WAIT (requires VK_KHR_present_id, VK_KHR_present_wait).
+	// Present completion is polled once per frame, so individual samples may be
+	// late by up to one present interval.
+	bool  present_latency_available = false;
+	float present_latency_ms_last   = 0;
+	float present_latency_ms_avg    = 0;
+	float present_latency_ms_max    = 0;
+};
+
 struct le_renderer_settings_t {
 	char const **           requested_device_extensions       = nullptr; // optional
 	uint32_t                requested_device_extensions_count = 0;       //
@@ -1156,6 +1205,31 @@ class RendererInfoBuilder {
 				return *this;
 			}
 
+			ImgSwapchainInfoBuilder &setReadbackBufferCountHint( uint32_t readback_buffer_count_hint = 0 ) {
+				parent.parent.swapchain_settings->img_settings.readback_buffer_count_hint = readback_buffer_count_hint;
+				return *this;
+			}
+
+			ImgSwapchainInfoBuilder &setBackpressure( le_swapchain_settings_t::img_settings_t::Backpressure backpressure = le_swapchain_settings_t::img_settings_t::Backpressure::eWait ) {
+				parent.parent.swapchain_settings->img_settings.backpressure = backpressure;
+				return *this;
+			}
+
+			// Publish frames into a POSIX shared memory ring instead of writing them to a pipe.
+			// See le_swapchain_vk/le_swapchain_img_shm.h for memory layout and reader protocol.
+			ImgSwapchainInfoBuilder &setShmOutput( char const *shm_name, uint32_t shm_slot_count = 3 ) {
+				parent.parent.swapchain_settings->img_settings.shm_name       = shm_name;
+				parent.parent.swapchain_settings->img_settings.shm_slot_count = shm_slot_count;
+				return *this;
+			}
+
+			// Encode frames into an image sequence on le_jobs worker threads instead of writing them to a pipe.
+			ImgSwapchainInfoBuilder &setImageSequenceEncoding( le_swapchain_settings_t::img_settings_t::Encoding encoding, uint32_t encode_max_in_flight = 0 ) {
+				parent.parent.swapchain_settings->img_settings.encoding             = encoding;
+				parent.parent.swapchain_settings->img_settings.encode_max_in_flight = encode_max_in_flight;
+				return *this;
+			}
+
 			SwapchainInfoBuilder &end() {
 				parent.parent.swapchain_settings->type = le_swapchain_settings_t::Type::LE_IMG_SWAPCHAIN;
 				return parent;
@@ -1171,6 +1245,7 @@ class RendererInfoBuilder {
 		}
 
 		ImgSwapchainInfoBuilder &asImgSwapchain() {
+			self->img_settings = {}; // img settings share storage with khr settings, we must apply defaults.
 			return mImgSwapchainInfoBuilder;
 		}
 
@@ -0,0 +1,237 @@
+#ifndef LE_SWAPCHAIN_PRESENT_TIMING_GUARD
+#define LE_SWAPCHAIN_PRESENT_TIMING_GUARD
+
+#include "le_renderer/private/le_renderer_types.h" // for le_swapchain_stats_t
+
+#include <chrono>
+#include <stdint.h>
+#include <cmath>
+#include <algorithm>
+
+/*
+
+  Frame pacing statistics for swapchains which present to a display.
+
+  Swapchains call:
+
+  - `present_timing_on_acquire` after each call to vkAcquireNextImageKHR,
+  - `present_timing_on_present` after each call to vkQueuePresentKHR,
+  - `present_timing_on_present_complete` once a present has been observed
+    to have reached the display (requires VK_KHR_present_wait),
+  - `present_timing_reset` whenever the swapchain gets re-created.
+
+  Samples are kept in a rolling window of the most recent frames; min/max/
+  mean values reported via `le_swapchain_stats_t` are calculated over this
+  window, so that they reflect current behaviour, and recover from
+  one-off hitches.
+
+  Acquire and present are always called from the same thread, therefore
+  none of this is synchronised.
+
+*/
+
+struct le_swapchain_present_timing_o {
+	using clock = std::chrono::steady_clock;
+
+	static constexpr uint32_t WINDOW_SIZE  = 128; // number of samples in rolling window, must be power of two
+	static constexpr uint32_t PENDING_SIZE = 16;  // max number of presents we track until they reach the display, must be power of two
+
+	struct PendingPresent {
+		uint64_t          present_id;
+		clock::time_point acquire_time;
+	};
+
+	float acquire_wait_ms[ WINDOW_SIZE ]     = {};
+	float present_interval_ms[ WINDOW_SIZE ] = {};
+	float present_latency_ms[ WINDOW_SIZE ]  = {};
+
+	uint64_t num_acquire_samples  = 0;
+	uint64_t num_interval_samples = 0;
+	uint64_t num_latency_samples  = 0;
+
+	uint64_t frames_presented = 0; // total, survives swapchain reset
+	uint64_t missed_vblanks   = 0; // total, survives swapchain reset
+
+	clock::time_point last_acquire_time = {}; // time at which the most recently acquired image was handed to the renderer
+	clock::time_point last_present_time = {};
+	bool              has_last_present  = false;
+
+	float display_refresh_period_ms = 0.f; // 0 if unknown - in which case we estimate the refresh period from present intervals
+
+	PendingPresent pending[ PENDING_SIZE ] = {};
+	uint32_t       pending_begin           = 0; // index of oldest pending present
+	uint32_t       pending_end             = 0; // one past index of most recent pending present
+	uint64_t       next_present_id         = 1; // present ids must be non-zero, and strictly increasing per swapchain
+};
+
+// ----------------------------------------------------------------------
+// Clears rolling window and pending presents - totals are kept.
+static inline void present_timing_reset( le_swapchain_present_timing_o *self ) {
+	self->num_acquire_samples  = 0;
+	self->num_interval_samples = 0;
+	self->num_latency_samples  = 0;
+	self->has_last_present     = false;
+	self->pending_begin        = 0;
+	self->pending_end          = 0;
+}
+
+// ----------------------------------------------------------------------
+
+static inline float present_timing_to_ms( le_swapchain_present_timing_o::clock::duration d ) {
+	return std::chrono::duration<float, std::milli>( d ).count();
+}
+
+// ----------------------------------------------------------------------
+// Returns display refresh period in ms - if not known, estimates it as the
+// shortest present interval in the current window, which, for fifo present
+// modes, is a good proxy for the vblank interval. Returns 0 if there are not
+// yet enough samples for an estimate.
+static inline float present_timing_get_refresh_period_ms( le_swapchain_present_timing_o const *self ) {
+
+	if ( self->display_refresh_period_ms > 0.f ) {
+		return self->display_refresh_period_ms;
+	}
+
+	constexpr uint64_t min_samples_for_estimate = 8;
+
+	uint64_t const num_samples = std::min<uint64_t>( self->num_interval_samples, le_swapchain_present_timing_o::WINDOW_SIZE );
+
+	if ( num_samples < min_samples_for_estimate ) {
+		return 0.f;
+	}
+
+	float result = self->present_interval_ms[ 0 ];
+	for ( uint64_t i = 1; i != num_samples; i++ ) {
+		result = std::min( result, self->present_interval_ms[ i ] );
+	}
+	return result;
+}
+
+// ----------------------------------------------------------------------
+
+static inline void present_timing_on_acquire( le_swapchain_present_timing_o *self, le_swapchain_present_timing_o::clock::time_point acquire_begin, le_swapchain_present_timing_o::clock::time_point acquire_end ) {
+	self->acquire_wait_ms[ self->num_acquire_samples & ( le_swapchain_present_timing_o::WINDOW_SIZE - 1 ) ] = present_timing_to_ms( acquire_end - acquire_begin );
+	self->num_acquire_samples++;
+	self->last_acquire_time = acquire_end;
+}
+
+// ----------------------------------------------------------------------
+// Call this after vkQueuePresentKHR returned. `is_vblank_locked` should be true
+// for fifo present modes, where a present interval longer than one refresh
+// period means that we missed vblanks.
+//
+// Returns the present id which was assigned to this present, and which should
+// be polled via vkWaitForPresentKHR if available.
+static inline uint64_t present_timing_on_present( le_swapchain_present_timing_o *self, le_swapchain_present_timing_o::clock::time_point now, bool is_vblank_locked ) {
+
+	self->frames_presented++;
+
+	if ( self->has_last_present ) {
+
+		float const interval_ms = present_timing_to_ms( now - self->last_present_time );
+
+		self->present_interval_ms[ self->num_interval_samples & ( le_swapchain_present_timing_o::WINDOW_SIZE - 1 ) ] = interval_ms;
+		self->num_interval_samples++;
+
+		float const refresh_period_ms = present_timing_get_refresh_period_ms( self );
+
+		if ( is_vblank_locked && refresh_period_ms > 0.f ) {
+			// Each whole refresh period beyond the first one is a missed vblank.
+			float const num_periods = std::round( interval_ms / refresh_period_ms );
+			if ( num_periods > 1.f ) {
+				self->missed_vblanks += uint64_t( num_periods ) - 1;
+			}
+		}
+	}
+
+	self->last_present_time = now;
+	self->has_last_present  = true;
+
+	uint64_t const present_id = self->next_present_id++;
+
+	if ( self->pending_end - self->pending_begin == le_swapchain_present_timing_o::PENDING_SIZE ) {
+		// Ring is full - drop oldest pending present, we will never know its latency.
+		self->pending_begin++;
+	}
+
+	self->pending[ self->pending_end & ( le_swapchain_present_timing_o::PENDING_SIZE - 1 ) ] = { present_id, self->last_acquire_time };
+	self->pending_end++;
+
+	return present_id;
+}
+
+// ----------------------------------------------------------------------
+// Returns the id of the oldest present which has not yet been observed to have
+// reached the display, or 0 if there is no such present.
+static inline uint64_t present_timing_get_oldest_pending_id( le_swapchain_present_timing_o const *self ) {
+	if ( self->pending_begin == self->pending_end ) {
+		return 0;
+	}
+	return self->pending[ self->pending_begin & ( le_swapchain_present_timing_o::PENDING_SIZE - 1 ) ].present_id;
+}
+
+// ----------------------------------------------------------------------
+// Call this once the oldest pending present has been observed to have reached the display.
+static inline void present_timing_on_present_complete( le_swapchain_present_timing_o *self, le_swapchain_present_timing_o::clock::time_point now ) {
+
+	if ( self->pending_begin == self->pending_end ) {
+		return;
+	}
+
+	auto const &p = self->pending[ self->pending_begin & ( le_swapchain_present_timing_o::PENDING_SIZE - 1 ) ];
+
+	self->present_latency_ms[ self->num_latency_samples & ( le_swapchain_present_timing_o::WINDOW_SIZE - 1 ) ] = present_timing_to_ms( now - p.acquire_time );
+	self->num_latency_samples++;
+	self->pending_begin++;
+}
+
+// ----------------------------------------------------------------------
+
+static inline void present_timing_summarise( float const *samples, uint64_t num_samples_total, float *last, float *avg, float *min_, float *max_ ) {
+
+	uint64_t const num_samples = std::min<uint64_t>( num_samples_total, le_swapchain_present_timing_o::WINDOW_SIZE );
+
+	if ( num_samples == 0 ) {
+		*last = *avg = *min_ = *max_ = 0.f;
+		return;
+	}
+
+	*last = samples[ ( num_samples_total - 1 ) & ( le_swapchain_present_timing_o::WINDOW_SIZE - 1 ) ];
+
+	float sum = 0.f;
+	*min_     = samples[ 0 ];
+	*max_     = samples[ 0 ];
+
+	for ( uint64_t i = 0; i != num_samples; i++ ) {
+		sum += samples[ i ];
+		*min_ = std::min( *min_, samples[ i ] );
+		*max_ = std::max( *max_, samples[ i ] );
+	}
+
+	*avg = sum / float( num_samples );
+}
+
+// ----------------------------------------------------------------------
+// Fills in timing fields of `stats` - swapchain-specific fields (presentmode,
+// imagecount) must be filled in by the caller.
+static inline void present_timing_get_stats( le_swapchain_present_timing_o const *self, le_swapchain_stats_t *stats ) {
+
+	float unused;
+
+	stats->frames_presented  = self->frames_presented;
+	stats->missed_vblanks    = self->missed_vblanks;
+	stats->refresh_period_ms = present_timing_get_refresh_period_ms( self );
+
+	present_timing_summarise( self->acquire_wait_ms, self->num_acquire_samples,
+	                          &stats->acquire_wait_ms_last, &stats->acquire_wait_ms_avg, &unused, &stats->acquire_wait_ms_max );
+
+	present_timing_summarise( self->present_interval_ms, self->num_interval_samples,
+	                          &stats->present_interval_ms_last, &stats->present_interval_ms_avg, &stats->present_interval_ms_min, &stats->present_interval_ms_max );
+
+	present_timing_summarise( self->present_latency_ms, self->num_latency_samples,
+	                          &stats->present_latency_ms_last, &stats->present_latency_ms_avg, &unused, &stats->present_latency_ms_max );
+
+	stats->present_latency_available = self->num_latency_samples > 0;
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "le_backend_vk/le_backend_vk.h"
 #include "le_renderer/private/le_renderer_types.h"
 #include "include/internal/le_swapchain_vk_common.h"
+#include "include/internal/le_swapchain_present_timing.h"
 
 #ifndef _MSC_VER
 	#define VK_USE_PLATFORM_XLIB_XRANDR_EXT
@@ -56,6 +57,12 @@ struct swp_direct_data_o {
 	vk::DisplayKHR                            display                        = nullptr;
 	vk::SurfaceKHR                            surface                        = nullptr;
 	std::vector<vk::DisplayModePropertiesKHR> display_mode_properties        = {};
+
+	le_swapchain_present_timing_o timing = {}; // frame pacing statistics
+
+#ifdef LE_FEATURE_PRESENT_WAIT
+	PFN_vkWaitForPresentKHR vkWaitForPresentKHR = nullptr;
+#endif
 };
 
 // ----------------------------------------------------------------------
@@ -156,6 +163,28 @@ static vk::PresentModeKHR get_direct_presentmode( const le_swapchain_settings_t:
 
 // ----------------------------------------------------------------------
 
+static le_swapchain_settings_t::khr_settings_t::Presentmode get_le_presentmode( vk::PresentModeKHR const &presentmode ) {
+	using PresentMode = le_swapchain_settings_t::khr_settings_t::Presentmode;
+	switch ( presentmode ) {
+	case ( vk::PresentModeKHR::eImmediate ):
+		return PresentMode::eImmediate;
+	case ( vk::PresentModeKHR::eMailbox ):
+		return PresentMode::eMailbox;
+	case ( vk::PresentModeKHR::eFifo ):
+		return PresentMode::eFifo;
+	case ( vk::PresentModeKHR::eFifoRelaxed ):
+		return PresentMode::eFifoRelaxed;
+	case ( vk::PresentModeKHR::eSharedDemandRefresh ):
+		return PresentMode::eSharedDemandRefresh;
+	case ( vk::PresentModeKHR::eSharedContinuousRefresh ):
+		return PresentMode::eSharedContinuousRefresh;
+	default:
+		return PresentMode::eDefault;
+	}
+}
+
+// ----------------------------------------------------------------------
+
 static void swapchain_attach_images( le_swapchain_o *base ) {
 	auto self = static_cast<swp_direct_data_o *const>( base->data );
 
@@ -273,6 +302,10 @@ static void swapchain_direct_reset( le_swapchain_o *base, const le_swapchain_set
 		oldSwapchain = nullptr;
 	}
 
+	// Any presents still pending belong to the old swapchain, and
+	// samples taken with previous settings would skew statistics.
+	present_timing_reset( &self->timing );
+
 	swapchain_attach_images( base );
 }
 
@@ -334,6 +367,18 @@ static le_swapchain_o *swapchain_direct_create( const le_swapchain_vk_api::swapc
 		self->display_mode_properties.resize( num_props );
 		result = phyDevice.getDisplayModePropertiesKHR( self->display, &num_props, self->display_mode_properties.data() );
 	}
+
+	// We know the refresh rate for the display mode we use - which means that we
+	// don't have to estimate the refresh period for frame pacing statistics.
+	// Note that refreshRate is given in millihertz.
+	if ( self->display_mode_properties[ 0 ].parameters.refreshRate ) {
+		self->timing.display_refresh_period_ms = 1000000.f / float( self->display_mode_properties[ 0 ].parameters.refreshRate );
+	}
+
+#ifdef LE_FEATURE_PRESENT_WAIT
+	self->vkWaitForPresentKHR = reinterpret_cast<PFN_vkWaitForPresentKHR>( vkGetDeviceProcAddr( self->device, "vkWaitForPresentKHR" ) );
+	assert( self->vkWaitForPresentKHR );
+#endif
 	// let's try to acquire this screen
 
 	{
@@ -398,7 +443,10 @@ static bool swapchain_direct_acquire_next_image( le_swapchain_o *base, VkSemapho
 	// before this image is available for writing. Image will be ready for writing when
 	// semaphorePresentComplete is signalled.
 
-	auto result = vkAcquireNextImageKHR( self->device, self->swapchainKHR, UINT64_MAX, semaphorePresentComplete_, nullptr, &imageIndex_ );
+	auto acquire_begin = le_swapchain_present_timing_o::clock::now();
+	auto result        = vkAcquireNextImageKHR( self->device, self->swapchainKHR, UINT64_MAX, semaphorePresentComplete_, nullptr, &imageIndex_ );
+
+	present_timing_on_acquire( &self->timing, acquire_begin, le_swapchain_present_timing_o::clock::now() );
 
 	switch ( result ) {
 	case VK_SUCCESS:
@@ -433,17 +481,54 @@ static bool swapchain_direct_present( le_swapchain_o *base, VkQueue queue_, VkSe
 	    .setPImageIndices( pImageIndex )
 	    .setPResults( nullptr );
 
+#ifdef LE_FEATURE_PRESENT_WAIT
+	// Tag this present with an id, so that we can find out when it reached the display.
+	uint64_t       present_id = self->timing.next_present_id;
+	VkPresentIdKHR present_id_info{ VK_STRUCTURE_TYPE_PRESENT_ID_KHR, nullptr, 1, &present_id };
+	presentInfo.setPNext( &present_id_info );
+#endif
+
 	auto result = vkQueuePresentKHR( queue_, reinterpret_cast<VkPresentInfoKHR *>( &presentInfo ) );
 
 	if ( vk::Result( result ) == vk::Result::eErrorOutOfDateKHR ) {
+		self->timing.next_present_id++; // present ids must never be re-used
 		return false;
 	}
 
+	bool const is_vblank_locked = ( self->mPresentMode == vk::PresentModeKHR::eFifo ||
+	                                self->mPresentMode == vk::PresentModeKHR::eFifoRelaxed );
+
+	present_timing_on_present( &self->timing, le_swapchain_present_timing_o::clock::now(), is_vblank_locked );
+
+#ifdef LE_FEATURE_PRESENT_WAIT
+	// Poll - without blocking - for any earlier presents which have since reached the display.
+	for ( uint64_t id = present_timing_get_oldest_pending_id( &self->timing ); id != 0;
+	      id          = present_timing_get_oldest_pending_id( &self->timing ) ) {
+		if ( VK_SUCCESS != self->vkWaitForPresentKHR( self->device, self->swapchainKHR, id, 0 ) ) {
+			break;
+		}
+		present_timing_on_present_complete( &self->timing, le_swapchain_present_timing_o::clock::now() );
+	}
+#endif
+
 	return true;
 };
 
 // ----------------------------------------------------------------------
 
+static bool swapchain_direct_get_stats( le_swapchain_o *base, le_swapchain_stats_t *stats ) {
+	auto self = static_cast<swp_direct_data_o *const>( base->data );
+
+	present_timing_get_stats( &self->timing, stats );
+
+	stats->presentmode = get_le_presentmode( self->mPresentMode );
+	stats->imagecount  = self->mImagecount;
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
 static VkImage swapchain_direct_get_image( le_swapchain_o *base, uint32_t index ) {
 
 	auto self = static_cast<swp_direct_data_o *const>( base->data );
@@ -503,10 +588,19 @@ static void swapchain_get_required_vk_instance_extensions( const le_swapchain_se
 
 static void swapchain_get_required_vk_device_extensions( const le_swapchain_settings_t *, char const ***exts, size_t *num_exts ) {
 
+#ifdef LE_FEATURE_PRESENT_WAIT
+	static std::array<char const *, 4> extensions = {
+	    "VK_EXT_display_control",
+	    "VK_KHR_swapchain",
+	    "VK_KHR_present_id",   // Optional, based on #define
+	    "VK_KHR_present_wait", // Optional, based on #define
+	};
+#else
 	static std::array<char const *, 2> extensions = {
 	    "VK_EXT_display_control",
 	    "VK_KHR_swapchain",
 	};
+#endif
 
 	*exts     = extensions.data();
 	*num_exts = extensions.size();
@@ -527,6 +621,7 @@ void register_le_swapchain_direct_api( void *api_ ) {
 	swapchain_i.get_image_height                    = swapchain_direct_get_image_height;
 	swapchain_i.get_surface_format                  = swapchain_direct_get_surface_format;
 	swapchain_i.get_images_count                    = swapchain_direct_get_swapchain_images_count;
+	swapchain_i.get_stats                           = swapchain_direct_get_stats;
 	swapchain_i.present                             = swapchain_direct_present;
 	swapchain_i.get_required_vk_instance_extensions = swapchain_get_required_vk_instance_extensions;
 	swapchain_i.get_required_vk_device_extensions   = swapchain_get_required_vk_device_extensions;
@@ -2,25 +2,81 @@
 #include <vulkan/vulkan.hpp>
 
 #include "include/internal/le_swapchain_vk_common.h"
+#include "le_swapchain_vk/le_swapchain_img_shm.h"
 #include "le_renderer/private/le_renderer_types.h" // for le_swapchain_settings_t, and le::Format
 #include "le_backend_vk/util/vk_mem_alloc/vk_mem_alloc.h"
+#include "le_jobs/le_jobs.h"
 
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
 #include <ctime>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstring>
+#include <climits>
+
+#ifndef _MSC_VER
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <linux/futex.h>
+#endif
 
 struct TransferFrame {
-	vk::Image         image            = nullptr; // Owned. Handle to image
+	vk::Image         image           = nullptr; // Owned. Handle to image
+	VmaAllocation     imageAllocation = nullptr; // Owned. Handle to image allocation
+	VmaAllocationInfo imageAllocationInfo{};
+	vk::Fence         frameFence; // Signalled once device is done with this image after present
+	vk::CommandBuffer cmdAcquire; // transfers image back to correct layout
+};
+
+// A readback slot holds a host-visible buffer into which the contents of a
+// swapchain image get copied on present. There may be more readback slots
+// than swapchain images, so that the writer thread may lag behind rendering
+// by a few frames without stalling it.
+//
+// A slot is either free (owned by the render thread), or pending (owned by
+// the writer thread, from the moment the copy was submitted until its
+// contents have been written out).
+struct ReadbackSlot {
 	vk::Buffer        buffer           = nullptr; // Owned. Handle to buffer
-	VmaAllocation     imageAllocation  = nullptr; // Owned. Handle to image allocation
 	VmaAllocation     bufferAllocation = nullptr; // Owned. Handle to buffer allocation
-	VmaAllocationInfo imageAllocationInfo{};
 	VmaAllocationInfo bufferAllocationInfo{};
-	vk::Fence         frameFence;
-	vk::CommandBuffer cmdPresent; // copies from image to buffer
-	vk::CommandBuffer cmdAcquire; // transfers image back to correct layout
+	vk::Fence         copyFence;       // Signalled once image data has arrived in buffer
+	vk::CommandBuffer cmdCopy;         // copies from image to buffer, re-recorded for each use
+	uint64_t          frameNumber = 0; // number of frame currently held by this slot
+
+	struct img_data_o *  owner         = nullptr; // Not owned. Swapchain which owns this slot
+	le_jobs::counter_t * encodeCounter = nullptr; // Set while an encode job for this slot is in flight
+	std::vector<uint8_t> encodeBuffer;            // Scratch memory for encoded frame, only used by encode job
+};
+
+// State shared between render thread and writer thread.
+// Everything in here except `thread` is protected by `mtx`.
+struct img_writer_o {
+	std::thread             thread;
+	std::mutex              mtx;
+	std::condition_variable cv_pending;          // signalled when a slot was queued for writing, or when writer must stop
+	std::condition_variable cv_free;             // signalled when writer has released a slot
+	std::deque<uint32_t>    pending_slots;       // slots queued for writing, in frame order
+	std::vector<uint32_t>   free_slots;          // slots available for readback
+	bool                    should_stop = false; // tells writer to drain queue, then join
+
+	struct stats_t {
+		uint64_t frames_written    = 0; // frames written out by writer thread
+		uint64_t frames_dropped    = 0; // frames not captured because all readback slots were busy (Backpressure::eDropFrames)
+		uint64_t frames_late       = 0; // frames for which render thread had to wait for a free readback slot (Backpressure::eWait)
+		uint64_t wait_time_ns      = 0; // total time render thread spent waiting for free readback slots
+		size_t   max_pending_count = 0; // high water mark for number of slots waiting to be written
+	} stats;
 };
 
 struct img_data_o {
@@ -37,8 +93,16 @@ struct img_data_o {
 	vk::CommandPool            vkCommandPool;                  // Command pool from wich we allocate present and acquire command buffers
 	le_backend_o *             backend = nullptr;              // Not owned. Backend owns swapchain.
 	std::vector<TransferFrame> transferFrames;                 //
+	std::vector<ReadbackSlot>  readbackSlots;                  // host-visible buffers, written out by writer thread
+	uint64_t                   frameDataSize = 0;              // number of bytes to write per frame
+	img_writer_o               writer;                         // writer thread, and its queues
 	FILE *                     pipe = nullptr;                 // Pipe to ffmpeg. Owned. must be closed if opened
 	std::string                pipe_cmd;                       // command line
+	le_img_shm_header_t *      shm_header = nullptr;           // Shared memory frame ring, if requested. Owned. must be unmapped if mapped
+	uint64_t                   shm_size   = 0;                 // size of shared memory mapping in bytes
+	std::string                shm_name;                       // name of shared memory object
+	std::string                sequenceBaseName;               // file name prefix for encoded image sequence
+	uint32_t                   encodeMaxInFlight = 0;          // max number of frames being encoded at once, 0 if not encoding
 };
 
 // ----------------------------------------------------------------------
@@ -49,10 +113,35 @@ static inline vk::Format le_format_to_vk( const le::Format &format ) noexcept {
 
 // ----------------------------------------------------------------------
 
+static bool img_shm_open( img_data_o *self );
+static void img_shm_close( img_data_o *self );
+
+// ----------------------------------------------------------------------
+// Blocks until the writer thread has written out all pending frames.
+// Called on the render thread, which is the only thread to queue frames,
+// so that no new frames get queued while we wait.
+static void img_writer_wait_until_idle( img_data_o *self ) {
+	auto &writer = self->writer;
+
+	// The writer pops a slot from the pending queue only once it has written
+	// its frame, and then notifies `cv_free`. This does not hold for encode
+	// jobs, which is fine, since encoding is never combined with shared memory.
+	std::unique_lock<std::mutex> lock( writer.mtx );
+	writer.cv_free.wait( lock, [ & ] { return writer.pending_slots.empty(); } );
+}
+
+// ----------------------------------------------------------------------
+
 static void swapchain_img_reset( le_swapchain_o *base, const le_swapchain_settings_t *settings_ ) {
 
 	auto self = static_cast<img_data_o *const>( base->data );
 
+	if ( self->shm_header ) {
+		// The writer thread publishes frames into the shared memory ring using
+		// the current extent - it must be done before we may change extent.
+		img_writer_wait_until_idle( self );
+	}
+
 	if ( settings_ ) {
 		self->mSettings = *settings_;
 		self->mSwapchainExtent
@@ -77,13 +166,29 @@ static void swapchain_img_reset( le_swapchain_o *base, const le_swapchain_settin
 	int bufAllocationResult = -1;
 
 	uint32_t const numFrames = self->mImagecount;
+	uint32_t       numSlots  = self->mSettings.img_settings.readback_buffer_count_hint;
+
+	if ( numSlots == 0 ) {
+		numSlots = numFrames * 2;
+		if ( self->mSettings.img_settings.encoding != le_swapchain_settings_t::img_settings_t::Encoding::eNone ) {
+			// Each frame which is being encoded holds on to a readback slot - make sure
+			// there are enough slots so that all workers may be kept busy.
+			uint32_t encode_in_flight = self->mSettings.img_settings.encode_max_in_flight
+			                                ? self->mSettings.img_settings.encode_max_in_flight
+			                                : uint32_t( le_jobs::get_worker_thread_count() );
+			numSlots = std::max( numSlots, numFrames + encode_in_flight );
+		}
+	}
+
+	numSlots = std::max<uint32_t>( 1, numSlots );
 
 	self->transferFrames.reserve( numFrames );
 
+	uint64_t imgSize = 0;
+
 	for ( size_t i = 0; i != numFrames; ++i ) {
 		TransferFrame frame{};
 
-		uint64_t imgSize = 0;
 		{
 			// Allocate space for an image which can hold a render surface
 
@@ -118,11 +223,39 @@ static void swapchain_img_reset( le_swapchain_o *base, const le_swapchain_settin
 			imgSize = frame.imageAllocationInfo.size;
 		}
 
+		frame.frameFence = self->device.createFence( { ::vk::FenceCreateFlagBits::eSignaled } );
+
+		self->transferFrames.emplace_back( frame );
+	}
+
+	self->frameDataSize = uint64_t( self->mSwapchainExtent.width ) * self->mSwapchainExtent.height * 4;
+
+	if ( self->shm_header &&
+	     ( self->shm_header->width != self->mSwapchainExtent.width ||
+	       self->shm_header->height != self->mSwapchainExtent.height ) ) {
+
+		// Readers take the layout of the ring from its header once, when they
+		// attach - which is why we must not change it in place. Instead, we
+		// detach from the ring, which tells readers that the producer has gone,
+		// and create a new ring under the same name, to which readers may attach.
+
+		img_shm_close( self );
+
+		if ( !img_shm_open( self ) ) {
+			std::cout << " ***** ERROR: Could not re-create shared memory frame ring, frames will be written to disk." << std::endl
+			          << std::flush;
+		}
+	}
+
+	self->readbackSlots.reserve( numSlots );
+
+	for ( size_t i = 0; i != numSlots; ++i ) {
+		ReadbackSlot slot{};
 		{
 			// Allocate space for a buffer in which to read back the image data.
 			//
 			// now we need a buffer which is host visible and coherent, which we can use to read out our data.
-			// there needs to be one buffer per image;
+			// there needs to be one buffer per readback slot;
 			using namespace le_backend_vk;
 
 			VkBufferCreateInfo bufferCreateInfo =
@@ -138,78 +271,51 @@ static void swapchain_img_reset( le_swapchain_o *base, const le_swapchain_settin
 			allocationCreateInfo.usage          = VMA_MEMORY_USAGE_CPU_ONLY;
 			allocationCreateInfo.preferredFlags = 0;
 
-			bufAllocationResult = private_backend_vk_i.allocate_buffer( self->backend, &bufferCreateInfo, &allocationCreateInfo, reinterpret_cast<VkBuffer *>( &frame.buffer ), &frame.bufferAllocation, &frame.bufferAllocationInfo );
-			assert( imgAllocationResult == VK_SUCCESS );
+			bufAllocationResult = private_backend_vk_i.allocate_buffer( self->backend, &bufferCreateInfo, &allocationCreateInfo, reinterpret_cast<VkBuffer *>( &slot.buffer ), &slot.bufferAllocation, &slot.bufferAllocationInfo );
+			assert( bufAllocationResult == VK_SUCCESS );
 		}
 
-		frame.frameFence = self->device.createFence( { ::vk::FenceCreateFlagBits::eSignaled } );
+		slot.copyFence = self->device.createFence( { ::vk::FenceCreateFlagBits::eSignaled } );
+		slot.owner     = self;
 
-		self->transferFrames.emplace_back( frame );
+		self->readbackSlots.emplace_back( slot );
 	}
 
-	// Allocate command buffers for each frame.
-	// Each frame needs one command buffer
+	// Allocate command buffers for each frame, and for each readback slot.
+	// Each frame needs one command buffer, each slot needs one command buffer
 
 	::vk::CommandBufferAllocateInfo allocateInfo;
 	allocateInfo
 	    .setCommandPool( self->vkCommandPool )
 	    .setLevel( ::vk::CommandBufferLevel::ePrimary )
-	    .setCommandBufferCount( numFrames * 2 );
+	    .setCommandBufferCount( numFrames + numSlots );
 
 	auto cmdBuffers = self->device.allocateCommandBuffers( allocateInfo );
 
 	// set up commands in frames.
 
 	for ( size_t i = 0; i != numFrames; ++i ) {
-		self->transferFrames[ i ].cmdAcquire = cmdBuffers[ i * 2 ];
-		self->transferFrames[ i ].cmdPresent = cmdBuffers[ i * 2 + 1 ];
+		self->transferFrames[ i ].cmdAcquire = cmdBuffers[ i ];
 	}
 
-	// Add commands to command buffers for all frames.
+	// Slot command buffers get recorded on present, since we don't know in
+	// advance which swapchain image a slot will receive.
 
-	for ( auto &frame : self->transferFrames ) {
-		{
-			// copy == transfer image to buffer memory
-			vk::CommandBuffer &cmdPresent = frame.cmdPresent;
+	for ( size_t i = 0; i != numSlots; ++i ) {
+		self->readbackSlots[ i ].cmdCopy = cmdBuffers[ numFrames + i ];
+	}
 
-			cmdPresent.begin( { ::vk::CommandBufferUsageFlags() } );
+	{
+		std::scoped_lock lock( self->writer.mtx );
+		self->writer.free_slots.clear();
+		for ( uint32_t i = 0; i != numSlots; ++i ) {
+			self->writer.free_slots.push_back( i );
+		}
+	}
 
-			auto imgMemBarrier =
-			    vk::ImageMemoryBarrier()
-			        .setSrcAccessMask( ::vk::AccessFlagBits::eMemoryRead )
-			        .setDstAccessMask( ::vk::AccessFlagBits::eTransferRead )
-			        .setOldLayout( ::vk::ImageLayout::ePresentSrcKHR )
-			        .setNewLayout( ::vk::ImageLayout::eTransferSrcOptimal )
-			        .setSrcQueueFamilyIndex( self->vk_graphics_queue_family_index ) // < TODO: queue ownership: graphics -> transfer
-			        .setDstQueueFamilyIndex( self->vk_graphics_queue_family_index ) // < TODO: queue ownership: graphics -> transfer
-			        .setImage( frame.image )
-			        .setSubresourceRange( { ::vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 } );
+	// Add commands to command buffers for all frames.
 
-			cmdPresent.pipelineBarrier( ::vk::PipelineStageFlagBits::eAllCommands, ::vk::PipelineStageFlagBits::eTransfer, ::vk::DependencyFlags(), {}, {}, { imgMemBarrier } );
-
-			::vk::ImageSubresourceLayers imgSubResource;
-			imgSubResource
-			    .setAspectMask( ::vk::ImageAspectFlagBits::eColor )
-			    .setMipLevel( 0 )
-			    .setBaseArrayLayer( 0 )
-			    .setLayerCount( 1 );
-
-			vk::BufferImageCopy imgCopy;
-			imgCopy
-			    .setBufferOffset( 0 ) // offset is always 0, since allocator created individual buffer objects
-			    .setBufferRowLength( self->mSwapchainExtent.width )
-			    .setBufferImageHeight( self->mSwapchainExtent.height )
-			    .setImageSubresource( imgSubResource )
-			    .setImageOffset( { 0 } )
-			    .setImageExtent( self->mSwapchainExtent );
-
-			// TODO: here we must wait for the buffer read event to have been signalled - because that means that the buffer
-			// is available for writing again. Perhaps we should use a buffer which is not persistently mapped, if that's faster.
-
-			// image must be transferred to a buffer - we can then read from this buffer.
-			cmdPresent.copyImageToBuffer( frame.image, ::vk::ImageLayout::eTransferSrcOptimal, frame.buffer, { imgCopy } );
-			cmdPresent.end();
-		}
+	for ( auto &frame : self->transferFrames ) {
 		{
 			// Move ownership of image back from transfer -> graphics
 			// Change image layout back to colorattachment
@@ -236,6 +342,615 @@ static void swapchain_img_reset( le_swapchain_o *base, const le_swapchain_settin
 	}
 }
 
+// ----------------------------------------------------------------------
+// Create and map shared memory frame ring. Returns false if ring could not be created.
+static bool img_shm_open( img_data_o *self ) {
+#ifdef _MSC_VER
+	// todo: implement windows-specific solution
+	return false;
+#else
+
+	uint32_t const slot_count = std::max<uint32_t>( 1, self->mSettings.img_settings.shm_slot_count );
+
+	uint64_t data_offset = 0;
+	uint64_t slot_stride = 0;
+
+	self->shm_size = le_img_shm_calculate_size( slot_count, self->frameDataSize, &data_offset, &slot_stride );
+
+	int fd = shm_open( self->shm_name.c_str(), O_CREAT | O_RDWR, 0600 );
+
+	if ( fd == -1 ) {
+		std::cout << " ***** ERROR: Could not open shared memory object '" << self->shm_name << "': " << strerror( errno ) << std::endl
+		          << std::flush;
+		return false;
+	}
+
+	void *mapping = MAP_FAILED;
+
+	if ( 0 == ftruncate( fd, off_t( self->shm_size ) ) ) {
+		mapping = mmap( nullptr, self->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	}
+
+	close( fd ); // mapping, if successful, keeps shared memory object alive.
+
+	if ( mapping == MAP_FAILED ) {
+		std::cout << " ***** ERROR: Could not map shared memory object '" << self->shm_name << "': " << strerror( errno ) << std::endl
+		          << std::flush;
+		shm_unlink( self->shm_name.c_str() );
+		return false;
+	}
+
+	memset( mapping, 0, data_offset );
+
+	auto header = static_cast<le_img_shm_header_t *>( mapping );
+
+	header->version           = LE_IMG_SHM_VERSION;
+	header->width             = self->mSwapchainExtent.width;
+	header->height            = self->mSwapchainExtent.height;
+	header->format            = uint32_t( self->windowSurfaceFormat.format );
+	header->bytes_per_row     = self->mSwapchainExtent.width * 4;
+	header->slot_count        = slot_count;
+	header->producer_attached = 1;
+	header->frame_data_size   = self->frameDataSize;
+	header->data_offset       = data_offset;
+	header->slot_stride       = slot_stride;
+
+	// Readers must not use the header before magic is visible.
+	__atomic_store_n( &header->magic, LE_IMG_SHM_MAGIC, __ATOMIC_RELEASE );
+
+	self->shm_header = header;
+
+	std::cout << "Image swapchain publishing frames to shared memory: '" << self->shm_name << "', "
+	          << slot_count << " slots, " << self->shm_size << " bytes" << std::endl
+	          << std::flush;
+
+	return true;
+#endif
+}
+
+// ----------------------------------------------------------------------
+// Detach from shared memory frame ring, and wake up any waiting readers
+// so that they may notice that the producer has gone.
+static void img_shm_close( img_data_o *self ) {
+#ifndef _MSC_VER
+	if ( nullptr == self->shm_header ) {
+		return;
+	}
+
+	__atomic_store_n( &self->shm_header->producer_attached, 0, __ATOMIC_RELEASE );
+	syscall( SYS_futex, &self->shm_header->frames_published, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0 );
+
+	munmap( self->shm_header, self->shm_size );
+	shm_unlink( self->shm_name.c_str() ); // readers which still have the ring mapped keep their mapping
+
+	self->shm_header = nullptr;
+#endif
+}
+
+// ----------------------------------------------------------------------
+// Copy frame from readback slot into next slot of shared memory ring,
+// then wake up any readers waiting for a new frame.
+// Called on the writer thread, which is the only writer to the ring.
+static void img_shm_publish_frame( img_data_o *self, ReadbackSlot const &slot ) {
+#ifndef _MSC_VER
+	auto     header     = self->shm_header;
+	uint32_t published  = header->frames_published; // only we ever write to this
+	uint32_t slot_index = published % header->slot_count;
+	auto     shm_slot   = le_img_shm_get_slots( header ) + slot_index;
+
+	// Seqlock write: sequence is odd while we write to the slot.
+	uint32_t sequence = shm_slot->sequence;
+	__atomic_store_n( &shm_slot->sequence, sequence + 1, __ATOMIC_RELAXED );
+	__atomic_thread_fence( __ATOMIC_RELEASE );
+
+	memcpy( le_img_shm_get_slot_data( header, slot_index ), slot.bufferAllocationInfo.pMappedData, self->frameDataSize );
+
+	timespec now{};
+	clock_gettime( CLOCK_MONOTONIC, &now );
+
+	shm_slot->frame_number = slot.frameNumber;
+	shm_slot->timestamp_ns = uint64_t( now.tv_sec ) * 1'000'000'000 + uint64_t( now.tv_nsec );
+
+	__atomic_store_n( &shm_slot->sequence, sequence + 2, __ATOMIC_RELEASE );
+	__atomic_store_n( &header->frames_published, published + 1, __ATOMIC_RELEASE );
+
+	syscall( SYS_futex, &header->frames_published, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0 );
+#endif
+}
+
+// ----------------------------------------------------------------------
+
+static char const *img_encoding_get_file_extension( le_swapchain_settings_t::img_settings_t::Encoding encoding ) {
+	switch ( encoding ) {
+	case le_swapchain_settings_t::img_settings_t::Encoding::eQoi:
+		return ".qoi";
+	case le_swapchain_settings_t::img_settings_t::Encoding::ePng:
+		return ".png";
+	default:
+		return ".rgba";
+	}
+}
+
+// ----------------------------------------------------------------------
+// Fetch pixel at index i as rgba, given pixels which are either stored as rgba or bgra.
+static inline void img_fetch_rgba( uint8_t const *pixels, size_t i, bool is_bgra, uint8_t *rgba ) {
+	uint8_t const *px = pixels + i * 4;
+	rgba[ 0 ]         = is_bgra ? px[ 2 ] : px[ 0 ];
+	rgba[ 1 ]         = px[ 1 ];
+	rgba[ 2 ]         = is_bgra ? px[ 0 ] : px[ 2 ];
+	rgba[ 3 ]         = px[ 3 ];
+}
+
+static inline uint8_t *img_write_u32_be( uint8_t *p, uint32_t v ) {
+	p[ 0 ] = uint8_t( v >> 24 );
+	p[ 1 ] = uint8_t( v >> 16 );
+	p[ 2 ] = uint8_t( v >> 8 );
+	p[ 3 ] = uint8_t( v );
+	return p + 4;
+}
+
+// ----------------------------------------------------------------------
+// Encode 8 bit rgba pixels as QOI image - see: https://qoiformat.org/qoi-specification.pdf
+static void img_encode_qoi( uint8_t const *pixels, uint32_t width, uint32_t height, bool is_bgra, std::vector<uint8_t> &out ) {
+
+	size_t const num_pixels = size_t( width ) * height;
+
+	out.resize( 14 + num_pixels * 5 + 8 ); // worst case: header, one QOI_OP_RGBA per pixel, end marker
+
+	uint8_t *p = out.data();
+
+	*p++ = 'q';
+	*p++ = 'o';
+	*p++ = 'i';
+	*p++ = 'f';
+	p    = img_write_u32_be( p, width );
+	p    = img_write_u32_be( p, height );
+	*p++ = 4; // channels: rgba
+	*p++ = 0; // colorspace: sRGB with linear alpha
+
+	uint8_t index[ 64 ][ 4 ]{};
+	uint8_t prev[ 4 ] = { 0, 0, 0, 255 };
+	uint8_t px[ 4 ];
+	int     run = 0;
+
+	for ( size_t i = 0; i != num_pixels; ++i ) {
+
+		img_fetch_rgba( pixels, i, is_bgra, px );
+
+		if ( 0 == memcmp( px, prev, 4 ) ) {
+			if ( ++run == 62 || i + 1 == num_pixels ) {
+				*p++ = uint8_t( 0xc0 | ( run - 1 ) ); // QOI_OP_RUN
+				run  = 0;
+			}
+			continue;
+		}
+
+		if ( run > 0 ) {
+			*p++ = uint8_t( 0xc0 | ( run - 1 ) ); // QOI_OP_RUN
+			run  = 0;
+		}
+
+		uint32_t const hash = ( px[ 0 ] * 3 + px[ 1 ] * 5 + px[ 2 ] * 7 + px[ 3 ] * 11 ) % 64;
+
+		if ( 0 == memcmp( index[ hash ], px, 4 ) ) {
+			*p++ = uint8_t( hash ); // QOI_OP_INDEX
+		} else {
+			memcpy( index[ hash ], px, 4 );
+
+			if ( px[ 3 ] == prev[ 3 ] ) {
+				int8_t const dr   = int8_t( px[ 0 ] - prev[ 0 ] );
+				int8_t const dg   = int8_t( px[ 1 ] - prev[ 1 ] );
+				int8_t const db   = int8_t( px[ 2 ] - prev[ 2 ] );
+				int8_t const dr_g = int8_t( dr - dg );
+				int8_t const db_g = int8_t( db - dg );
+
+				if ( dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2 ) {
+					*p++ = uint8_t( 0x40 | ( dr + 2 ) << 4 | ( dg + 2 ) << 2 | ( db + 2 ) ); // QOI_OP_DIFF
+				} else if ( dr_g > -9 && dr_g < 8 && dg > -33 && dg < 32 && db_g > -9 && db_g < 8 ) {
+					*p++ = uint8_t( 0x80 | ( dg + 32 ) ); // QOI_OP_LUMA
+					*p++ = uint8_t( ( dr_g + 8 ) << 4 | ( db_g + 8 ) );
+				} else {
+					*p++ = 0xfe; // QOI_OP_RGB
+					*p++ = px[ 0 ];
+					*p++ = px[ 1 ];
+					*p++ = px[ 2 ];
+				}
+			} else {
+				*p++ = 0xff; // QOI_OP_RGBA
+				memcpy( p, px, 4 );
+				p += 4;
+			}
+		}
+
+		memcpy( prev, px, 4 );
+	}
+
+	static constexpr uint8_t end_marker[ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+	memcpy( p, end_marker, sizeof( end_marker ) );
+	p += sizeof( end_marker );
+
+	out.resize( size_t( p - out.data() ) );
+}
+
+// ----------------------------------------------------------------------
+
+static uint32_t img_png_crc32( uint8_t const *data, size_t len, uint32_t crc = 0 ) {
+	static auto const table = []() {
+		std::array<uint32_t, 256> t{};
+		for ( uint32_t n = 0; n != 256; n++ ) {
+			uint32_t c = n;
+			for ( int k = 0; k != 8; k++ ) {
+				c = ( c & 1 ) ? 0xedb88320u ^ ( c >> 1 ) : c >> 1;
+			}
+			t[ n ] = c;
+		}
+		return t;
+	}();
+
+	crc = ~crc;
+	for ( size_t i = 0; i != len; i++ ) {
+		crc = table[ ( crc ^ data[ i ] ) & 0xff ] ^ ( crc >> 8 );
+	}
+	return ~crc;
+}
+
+// ----------------------------------------------------------------------
+// Encode 8 bit rgba pixels as PNG image.
+//
+// Image data is stored without compression (deflate "stored" blocks) -
+// this keeps encoding cost close to a memcpy, while the resulting files
+// can still be read by any PNG decoder.
+static void img_encode_png( uint8_t const *pixels, uint32_t width, uint32_t height, bool is_bgra, std::vector<uint8_t> &out ) {
+
+	constexpr size_t MAX_STORED_BLOCK_SIZE = 65535;
+
+	size_t const row_size   = 1 + size_t( width ) * 4; // filter byte + pixels
+	size_t const raw_size   = row_size * height;
+	size_t const num_blocks = std::max<size_t>( 1, ( raw_size + MAX_STORED_BLOCK_SIZE - 1 ) / MAX_STORED_BLOCK_SIZE );
+	size_t const idat_size  = 2 + raw_size + num_blocks * 5 + 4; // zlib header, data, block headers, adler32
+
+	out.resize( 8 + ( 12 + 13 ) + ( 12 + idat_size ) + 12 );
+
+	uint8_t *p = out.data();
+
+	static constexpr uint8_t signature[ 8 ] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	memcpy( p, signature, 8 );
+	p += 8;
+
+	// -- IHDR
+	{
+		p                    = img_write_u32_be( p, 13 );
+		uint8_t *chunk_start = p;
+		memcpy( p, "IHDR", 4 );
+		p    = img_write_u32_be( p + 4, width );
+		p    = img_write_u32_be( p, height );
+		*p++ = 8; // bit depth
+		*p++ = 6; // colour type: rgba
+		*p++ = 0; // compression method
+		*p++ = 0; // filter method
+		*p++ = 0; // interlace method
+		p    = img_write_u32_be( p, img_png_crc32( chunk_start, size_t( p - chunk_start ) ) );
+	}
+
+	// -- IDAT
+	{
+		p                    = img_write_u32_be( p, uint32_t( idat_size ) );
+		uint8_t *chunk_start = p;
+		memcpy( p, "IDAT", 4 );
+		p += 4;
+
+		*p++ = 0x78; // zlib header: deflate, 32K window
+		*p++ = 0x01; // zlib header: no preset dictionary, fastest - header is multiple of 31
+
+		uint32_t adler_a          = 1;
+		uint32_t adler_b          = 0;
+		size_t   block_remaining  = 0;
+		size_t   bytes_to_process = raw_size;
+
+		// Append one byte of uncompressed data, starting a new stored block if needed.
+		auto put_byte = [ & ]( uint8_t byte ) {
+			if ( block_remaining == 0 ) {
+				block_remaining = std::min( bytes_to_process, MAX_STORED_BLOCK_SIZE );
+				*p++            = ( bytes_to_process == block_remaining ) ? 1 : 0; // BFINAL, BTYPE=00
+				*p++            = uint8_t( block_remaining );
+				*p++            = uint8_t( block_remaining >> 8 );
+				*p++            = uint8_t( ~block_remaining );
+				*p++            = uint8_t( ~block_remaining >> 8 );
+			}
+			*p++ = byte;
+			block_remaining--;
+			bytes_to_process--;
+			adler_a = ( adler_a + byte ) % 65521;
+			adler_b = ( adler_b + adler_a ) % 65521;
+		};
+
+		uint8_t px[ 4 ];
+
+		for ( uint32_t y = 0; y != height; y++ ) {
+			put_byte( 0 ); // filter type: none
+			for ( size_t x = 0; x != width; x++ ) {
+				img_fetch_rgba( pixels, size_t( y ) * width + x, is_bgra, px );
+				put_byte( px[ 0 ] );
+				put_byte( px[ 1 ] );
+				put_byte( px[ 2 ] );
+				put_byte( px[ 3 ] );
+			}
+		}
+
+		p = img_write_u32_be( p, ( adler_b << 16 ) | adler_a );
+		p = img_write_u32_be( p, img_png_crc32( chunk_start, size_t( p - chunk_start ) ) );
+	}
+
+	// -- IEND
+	{
+		p                    = img_write_u32_be( p, 0 );
+		uint8_t *chunk_start = p;
+		memcpy( p, "IEND", 4 );
+		p += 4;
+		p = img_write_u32_be( p, img_png_crc32( chunk_start, 4 ) );
+	}
+
+	assert( p == out.data() + out.size() );
+}
+
+// ----------------------------------------------------------------------
+// Encode contents of a readback slot, and write encoded image to disk.
+// Runs on a le_jobs worker thread - several of these may run in parallel,
+// each with their own slot.
+static void img_encode_frame_job( void *slot_ ) {
+	auto        slot = static_cast<ReadbackSlot *>( slot_ );
+	auto const *self = slot->owner;
+
+	auto const encoding = self->mSettings.img_settings.encoding;
+	bool const is_bgra  = ( self->windowSurfaceFormat.format == vk::Format::eB8G8R8A8Unorm ||
+                           self->windowSurfaceFormat.format == vk::Format::eB8G8R8A8Srgb );
+
+	auto pixels = static_cast<uint8_t const *>( slot->bufferAllocationInfo.pMappedData );
+
+	switch ( encoding ) {
+	case le_swapchain_settings_t::img_settings_t::Encoding::eQoi:
+		img_encode_qoi( pixels, self->mSwapchainExtent.width, self->mSwapchainExtent.height, is_bgra, slot->encodeBuffer );
+		break;
+	case le_swapchain_settings_t::img_settings_t::Encoding::ePng:
+		img_encode_png( pixels, self->mSwapchainExtent.width, self->mSwapchainExtent.height, is_bgra, slot->encodeBuffer );
+		break;
+	default:
+		assert( false ); // unreachable
+		return;
+	}
+
+	char file_name[ 1024 ];
+	snprintf( file_name, sizeof( file_name ), "%s_%08llu%s", self->sequenceBaseName.c_str(), ( unsigned long long )slot->frameNumber, img_encoding_get_file_extension( encoding ) );
+
+	FILE *file = fopen( file_name, "wb" );
+
+	if ( file ) {
+		fwrite( slot->encodeBuffer.data(), slot->encodeBuffer.size(), 1, file );
+		fclose( file );
+	} else {
+		std::cout << " ***** ERROR: Could not write image '" << file_name << "'" << std::endl
+		          << std::flush;
+	}
+}
+
+// ----------------------------------------------------------------------
+// Writes out the contents of a readback slot - either into shared memory,
+// to ffmpeg via pipe, or, if neither is available, as a raw .rgba file.
+// Called on the writer thread.
+static void img_writer_write_frame( img_data_o *self, ReadbackSlot const &slot ) {
+
+	if ( self->shm_header ) {
+		img_shm_publish_frame( self, slot );
+	} else if ( self->pipe ) {
+		// Write out frame contents to ffmpeg via pipe.
+		fwrite( slot.bufferAllocationInfo.pMappedData, self->frameDataSize, 1, self->pipe );
+	} else {
+		char file_name[ 1024 ];
+		snprintf( file_name, sizeof( file_name ), "isl_%08llu.rgba", ( unsigned long long )slot.frameNumber );
+		std::ofstream myfile( file_name, std::ios::out | std::ios::binary );
+		myfile.write( ( char * )slot.bufferAllocationInfo.pMappedData, self->frameDataSize );
+		myfile.close();
+		std::cout << "Wrote Image: " << file_name << std::endl
+		          << std::flush;
+	}
+}
+
+// ----------------------------------------------------------------------
+// Writer thread main loop: takes slots from the pending queue in frame
+// order, waits for their copy to complete on the device, writes them out,
+// then hands them back to the render thread via the free list.
+//
+// If frames get encoded to an image sequence, writing a frame means to
+// dispatch an encode job to le_jobs. Up to `encodeMaxInFlight` frames
+// are encoded in parallel, and slots are handed back in frame order.
+//
+// Once `should_stop` is set, the writer drains the pending queue, and
+// waits for all encode jobs to complete before it returns, so that no
+// submitted frame is lost.
+static void img_writer_thread_loop( img_data_o *self ) {
+	auto &writer = self->writer;
+
+	std::deque<uint32_t> encoding_slots; // slots with encode jobs in flight, in frame order. Only used by writer thread.
+
+	// Waits for oldest encode job to complete, then hands its slot back to the render thread.
+	auto retire_oldest_encode_job = [ & ]() {
+		uint32_t slot_index = encoding_slots.front();
+		encoding_slots.pop_front();
+
+		auto &slot = self->readbackSlots[ slot_index ];
+
+		if ( slot.encodeCounter ) {
+			le_jobs::wait_for_counter_and_free( slot.encodeCounter, 0 );
+			slot.encodeCounter = nullptr;
+		}
+
+		{
+			std::scoped_lock lock( writer.mtx );
+			writer.free_slots.push_back( slot_index );
+			writer.stats.frames_written++;
+		}
+		writer.cv_free.notify_one();
+	};
+
+	for ( ;; ) {
+
+		uint32_t slot_index  = 0;
+		bool     has_pending = false;
+		{
+			std::unique_lock<std::mutex> lock( writer.mtx );
+			if ( encoding_slots.empty() ) {
+				writer.cv_pending.wait( lock, [ & ] { return writer.should_stop || !writer.pending_slots.empty(); } );
+			}
+			has_pending = !writer.pending_slots.empty() &&
+			              ( encoding_slots.empty() || encoding_slots.size() < self->encodeMaxInFlight );
+			if ( has_pending ) {
+				slot_index = writer.pending_slots.front();
+			}
+		}
+
+		if ( !has_pending ) {
+			if ( encoding_slots.empty() ) {
+				break; // should_stop was set, and there is nothing left to write.
+			}
+			// Either we have reached the maximum number of encode jobs in flight,
+			// or there is nothing else to do: wait for the oldest job to complete.
+			retire_oldest_encode_job();
+			continue;
+		}
+
+		auto &slot = self->readbackSlots[ slot_index ];
+
+		// Wait for the copy into our readback buffer to complete on the device.
+		// Offline renders may take a long time per frame, which is why we keep
+		// waiting on timeout.
+		::vk::Result fenceWaitResult;
+		do {
+			fenceWaitResult = self->device.waitForFences( { slot.copyFence }, VK_TRUE, 100'000'000 );
+		} while ( fenceWaitResult == ::vk::Result::eTimeout );
+
+		assert( fenceWaitResult == ::vk::Result::eSuccess );
+
+		if ( self->encodeMaxInFlight > 0 ) {
+
+			if ( le_jobs::get_worker_thread_count() > 0 ) {
+				le_jobs::job_t job{ img_encode_frame_job, &slot };
+				le_jobs::run_jobs( &job, 1, &slot.encodeCounter );
+			} else {
+				img_encode_frame_job( &slot );
+			}
+
+			encoding_slots.push_back( slot_index );
+
+			std::scoped_lock lock( writer.mtx );
+			writer.pending_slots.pop_front();
+			continue;
+		}
+
+		img_writer_write_frame( self, slot );
+
+		{
+			std::scoped_lock lock( writer.mtx );
+			writer.pending_slots.pop_front();
+			writer.free_slots.push_back( slot_index );
+			writer.stats.frames_written++;
+		}
+		writer.cv_free.notify_one();
+	}
+}
+
+// ----------------------------------------------------------------------
+// Fetch a free readback slot. If all slots are busy, we either wait for
+// the writer thread to release one - which applies backpressure on the
+// render thread - or, if frames may be dropped, we return false.
+// Called on the render thread.
+static bool img_writer_acquire_free_slot( img_data_o *self, uint32_t *slot_index ) {
+	auto &writer = self->writer;
+
+	std::unique_lock<std::mutex> lock( writer.mtx );
+
+	if ( writer.free_slots.empty() ) {
+
+		if ( self->mSettings.img_settings.backpressure == le_swapchain_settings_t::img_settings_t::Backpressure::eDropFrames ) {
+			if ( 0 == writer.stats.frames_dropped++ ) {
+				std::cout << "WARNING: Image swapchain dropped frame " << self->totalImages
+				          << ": all " << self->readbackSlots.size() << " readback buffers are busy. Consider raising readback buffer count." << std::endl
+				          << std::flush;
+			}
+			return false;
+		}
+
+		if ( 0 == writer.stats.frames_late++ ) {
+			std::cout << "WARNING: Image swapchain is waiting for writer thread: all " << self->readbackSlots.size()
+			          << " readback buffers are busy. Consider raising readback buffer count." << std::endl
+			          << std::flush;
+		}
+
+		auto wait_start = std::chrono::steady_clock::now();
+		writer.cv_free.wait( lock, [ & ] { return !writer.free_slots.empty(); } );
+		writer.stats.wait_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - wait_start ).count();
+	}
+
+	*slot_index = writer.free_slots.back();
+	writer.free_slots.pop_back();
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+// Hand over a slot, for which a copy has been submitted, to the writer thread.
+static void img_writer_enqueue_slot( img_data_o *self, uint32_t slot_index ) {
+	auto &writer = self->writer;
+	{
+		std::scoped_lock lock( writer.mtx );
+		writer.pending_slots.push_back( slot_index );
+		writer.stats.max_pending_count = std::max( writer.stats.max_pending_count, writer.pending_slots.size() );
+	}
+	writer.cv_pending.notify_one();
+}
+
+// ----------------------------------------------------------------------
+// Record commands which copy swapchain image into readback slot buffer.
+static void img_record_copy_commands( img_data_o *self, ReadbackSlot &slot, TransferFrame const &frame ) {
+
+	// copy == transfer image to buffer memory
+	vk::CommandBuffer &cmdCopy = slot.cmdCopy;
+
+	cmdCopy.begin( { ::vk::CommandBufferUsageFlagBits::eOneTimeSubmit } );
+
+	auto imgMemBarrier =
+	    vk::ImageMemoryBarrier()
+	        .setSrcAccessMask( ::vk::AccessFlagBits::eMemoryRead )
+	        .setDstAccessMask( ::vk::AccessFlagBits::eTransferRead )
+	        .setOldLayout( ::vk::ImageLayout::ePresentSrcKHR )
+	        .setNewLayout( ::vk::ImageLayout::eTransferSrcOptimal )
+	        .setSrcQueueFamilyIndex( self->vk_graphics_queue_family_index ) // < TODO: queue ownership: graphics -> transfer
+	        .setDstQueueFamilyIndex( self->vk_graphics_queue_family_index ) // < TODO: queue ownership: graphics -> transfer
+	        .setImage( frame.image )
+	        .setSubresourceRange( { ::vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 } );
+
+	cmdCopy.pipelineBarrier( ::vk::PipelineStageFlagBits::eAllCommands, ::vk::PipelineStageFlagBits::eTransfer, ::vk::DependencyFlags(), {}, {}, { imgMemBarrier } );
+
+	::vk::ImageSubresourceLayers imgSubResource;
+	imgSubResource
+	    .setAspectMask( ::vk::ImageAspectFlagBits::eColor )
+	    .setMipLevel( 0 )
+	    .setBaseArrayLayer( 0 )
+	    .setLayerCount( 1 );
+
+	vk::BufferImageCopy imgCopy;
+	imgCopy
+	    .setBufferOffset( 0 ) // offset is always 0, since allocator created individual buffer objects
+	    .setBufferRowLength( self->mSwapchainExtent.width )
+	    .setBufferImageHeight( self->mSwapchainExtent.height )
+	    .setImageSubresource( imgSubResource )
+	    .setImageOffset( { 0 } )
+	    .setImageExtent( self->mSwapchainExtent );
+
+	// image must be transferred to a buffer - we can then read from this buffer.
+	cmdCopy.copyImageToBuffer( frame.image, ::vk::ImageLayout::eTransferSrcOptimal, slot.buffer, { imgCopy } );
+	cmdCopy.end();
+}
+
 // ----------------------------------------------------------------------
 
 static le_swapchain_o *swapchain_img_create( const le_swapchain_vk_api::swapchain_interface_t &interface, le_backend_o *backend, const le_swapchain_settings_t *settings ) {
@@ -247,7 +962,8 @@ static le_swapchain_o *swapchain_img_create( const le_swapchain_vk_api::swapchai
 	self->windowSurfaceFormat.format     = le_format_to_vk( self->mSettings.format_hint );
 	self->windowSurfaceFormat.colorSpace = vk::ColorSpaceKHR::eSrgbNonlinear;
 	self->mImageIndex                    = uint32_t( ~0 );
-	self->pipe_cmd                       = std::string( settings->img_settings.pipe_cmd );
+	self->pipe_cmd                       = settings->img_settings.pipe_cmd ? std::string( settings->img_settings.pipe_cmd ) : std::string();
+	self->shm_name                       = settings->img_settings.shm_name ? std::string( settings->img_settings.shm_name ) : std::string();
 	{
 
 		using namespace le_backend_vk;
@@ -270,7 +986,12 @@ static le_swapchain_o *swapchain_img_create( const le_swapchain_vk_api::swapchai
 
 	swapchain_img_reset( base, settings );
 
-	{
+	if ( !self->shm_name.empty() && !img_shm_open( self ) ) {
+		std::cout << " ***** ERROR: Could not create shared memory frame ring, falling back to pipe." << std::endl
+		          << std::flush;
+	}
+
+	if ( nullptr == self->shm_header ) {
 		// First generate a timestamp tag so that we can make
 		// sure that successive screen captures don't overwrite.
 
@@ -279,45 +1000,76 @@ static le_swapchain_o *swapchain_img_create( const le_swapchain_vk_api::swapchai
 
 		timestamp_tag << std::put_time( std::localtime( &time_now ), "_%y-%m-%d_%OH-%OM-%OS" );
 
-		// -- Initialise ffmpeg as a receiver for our frames by selecting one of
-		// these possible command line options. Eventually we want to expose the
-		// command line, so that we may pipe to any program.
-
-		const char *commandLines[] = {
-		    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -vcodec h264_nvenc -preset llhq -rc:v vbr_minqp -qmin:v 19 -qmax:v 21 -b:v 2500k -maxrate:v 5000k -profile:v high isl%s.mp4",
-		    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -filter_complex \"[0:v] fps=30,split [a][b];[a] palettegen [p];[b][p] paletteuse\" isl%s.gif",
-		    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -vcodec nvenc_hevc -preset llhq -rc:v vbr_minqp -qmin:v 0 -qmax:v 4 -b:v 2500k -maxrate:v 50000k -vf \"minterpolate=mi_mode=blend:mc_mode=aobmc:mi_mode=mci,framerate=30\" isl%s.mov",
-		    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -vcodec h264_nvenc  -preset llhq -rc:v vbr_minqp -qmin:v 0 -qmax:v 10 -b:v 5000k -maxrate:v 50000k -pix_fmt yuv420p -r 60 -profile:v high isl%s.mp4",
-		    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -preset fast -y -pix_fmt yuv420p isl%s.mp4",
-		    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 isl%s_%%03d.png",
-		};
+		if ( self->mSettings.img_settings.encoding != le_swapchain_settings_t::img_settings_t::Encoding::eNone ) {
+
+			// -- Encode frames into an image sequence on le_jobs worker threads.
+			// We limit the number of frames which may be encoded at the same
+			// time - each frame in flight holds on to a readback buffer.
+
+			size_t worker_count = le_jobs::get_worker_thread_count();
 
-		char cmd[ 1024 ]{};
+			self->sequenceBaseName  = std::string( "isl" ) + timestamp_tag.str();
+			self->encodeMaxInFlight = self->mSettings.img_settings.encode_max_in_flight
+			                              ? self->mSettings.img_settings.encode_max_in_flight
+			                              : uint32_t( std::max<size_t>( 1, worker_count ) );
+
+			std::cout << "Image swapchain encoding image sequence: '" << self->sequenceBaseName << "_########"
+			          << img_encoding_get_file_extension( self->mSettings.img_settings.encoding ) << "', "
+			          << self->encodeMaxInFlight << " frames in flight on " << worker_count << " worker threads." << std::endl
+			          << std::flush;
+
+			if ( worker_count == 0 ) {
+				std::cout << "WARNING: Job system not initialised, frames will be encoded on writer thread." << std::endl
+				          << std::flush;
+			}
 
-		if ( self->pipe_cmd.empty() ) {
-			snprintf( cmd, sizeof( cmd ), commandLines[ 3 ], self->mSwapchainExtent.width, self->mSwapchainExtent.height, timestamp_tag.str().c_str() );
 		} else {
-			snprintf( cmd, sizeof( cmd ), self->pipe_cmd.c_str(), self->mSwapchainExtent.width, self->mSwapchainExtent.height, timestamp_tag.str().c_str() );
-		}
 
-		std::cout << "Image swapchain opening pipe using command line: '" << cmd << "'" << std::endl
-		          << std::flush;
+			// -- Initialise ffmpeg as a receiver for our frames by selecting one of
+			// these possible command line options. Eventually we want to expose the
+			// command line, so that we may pipe to any program.
+
+			const char *commandLines[] = {
+			    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -vcodec h264_nvenc -preset llhq -rc:v vbr_minqp -qmin:v 19 -qmax:v 21 -b:v 2500k -maxrate:v 5000k -profile:v high isl%s.mp4",
+			    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -filter_complex \"[0:v] fps=30,split [a][b];[a] palettegen [p];[b][p] paletteuse\" isl%s.gif",
+			    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -vcodec nvenc_hevc -preset llhq -rc:v vbr_minqp -qmin:v 0 -qmax:v 4 -b:v 2500k -maxrate:v 50000k -vf \"minterpolate=mi_mode=blend:mc_mode=aobmc:mi_mode=mci,framerate=30\" isl%s.mov",
+			    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -vcodec h264_nvenc  -preset llhq -rc:v vbr_minqp -qmin:v 0 -qmax:v 10 -b:v 5000k -maxrate:v 50000k -pix_fmt yuv420p -r 60 -profile:v high isl%s.mp4",
+			    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 -preset fast -y -pix_fmt yuv420p isl%s.mp4",
+			    "ffmpeg -r 60 -f rawvideo -pix_fmt rgba -s %dx%d -i - -threads 0 isl%s_%%03d.png",
+			};
+
+			char cmd[ 1024 ]{};
+
+			if ( self->pipe_cmd.empty() ) {
+				snprintf( cmd, sizeof( cmd ), commandLines[ 3 ], self->mSwapchainExtent.width, self->mSwapchainExtent.height, timestamp_tag.str().c_str() );
+			} else {
+				snprintf( cmd, sizeof( cmd ), self->pipe_cmd.c_str(), self->mSwapchainExtent.width, self->mSwapchainExtent.height, timestamp_tag.str().c_str() );
+			}
+
+			std::cout << "Image swapchain opening pipe using command line: '" << cmd << "'" << std::endl
+			          << std::flush;
 #ifdef _MSC_VER
-		// todo: implement windows-specific solution 
+			// todo: implement windows-specific solution 
 #else
 
-		// Open pipe to ffmpeg's stdin in binary write mode
-		self->pipe = popen( cmd, "w" );
+			// Open pipe to ffmpeg's stdin in binary write mode
+			self->pipe = popen( cmd, "w" );
 
-		if ( self->pipe == nullptr ) {
+			if ( self->pipe == nullptr ) {
 
-			std::cout << " ***** ERROR: Could not open pipe. Additionally, strerror reports:" << strerror( errno ) << std::endl
-			          << std::flush;
-		}
+				std::cout << " ***** ERROR: Could not open pipe. Additionally, strerror reports:" << strerror( errno ) << std::endl
+				          << std::flush;
+			}
 
-		assert( self->pipe != nullptr );
+			assert( self->pipe != nullptr );
 #endif // _MSC_VER
+		}
 	}
+
+	// Start writer thread - from now on, frames which have been read back
+	// get written out on the writer thread, and not on the render thread.
+	self->writer.thread = std::thread( img_writer_thread_loop, self );
+
 	return base;
 }
 
@@ -327,6 +1079,31 @@ static void swapchain_img_destroy( le_swapchain_o *base ) {
 
 	auto self = static_cast<img_data_o *const>( base->data );
 
+	{
+		// Stop writer thread - writer will first write out any pending frames.
+		// We must do this before we close the pipe, and before we free any
+		// readback buffers.
+		{
+			std::scoped_lock lock( self->writer.mtx );
+			self->writer.should_stop = true;
+		}
+		self->writer.cv_pending.notify_one();
+
+		if ( self->writer.thread.joinable() ) {
+			self->writer.thread.join();
+		}
+
+		auto const &stats = self->writer.stats;
+
+		std::cout << "Image swapchain wrote " << stats.frames_written << " frames"
+		          << ", dropped: " << stats.frames_dropped
+		          << ", late: " << stats.frames_late
+		          << " (render thread waited " << std::fixed << std::setprecision( 3 ) << double( stats.wait_time_ns ) / 1'000'000. << "ms)"
+		          << ", max queued: " << stats.max_pending_count << "/" << self->readbackSlots.size()
+		          << std::endl
+		          << std::flush;
+	}
+
 	// close ffmpeg pipe handle
 
 	if ( self->pipe ) {
@@ -338,6 +1115,10 @@ static void swapchain_img_destroy( le_swapchain_o *base ) {
 		self->pipe = nullptr; // mark as closed
 	}
 
+	// detach from shared memory frame ring
+
+	img_shm_close( self );
+
 	using namespace le_backend_vk;
 
 	{
@@ -360,8 +1141,6 @@ static void swapchain_img_destroy( le_swapchain_o *base ) {
 
 		// Destroy image allocation for this frame.
 		private_backend_vk_i.destroy_image( self->backend, f.image, f.imageAllocation );
-		// Destroy buffer allocation for this frame.
-		private_backend_vk_i.destroy_buffer( self->backend, f.buffer, f.bufferAllocation );
 
 		if ( f.frameFence ) {
 			self->device.destroyFence( f.frameFence );
@@ -369,9 +1148,21 @@ static void swapchain_img_destroy( le_swapchain_o *base ) {
 		}
 	}
 
-	// Clear TransferFrame
+	for ( auto &s : self->readbackSlots ) {
+
+		// Destroy buffer allocation for this slot.
+		private_backend_vk_i.destroy_buffer( self->backend, s.buffer, s.bufferAllocation );
+
+		if ( s.copyFence ) {
+			self->device.destroyFence( s.copyFence );
+			s.copyFence = nullptr;
+		}
+	}
+
+	// Clear TransferFrames, and readback slots
 
 	self->transferFrames.clear();
+	self->readbackSlots.clear();
 
 	if ( self->vkCommandPool ) {
 
@@ -409,29 +1200,9 @@ static bool swapchain_img_acquire_next_image( le_swapchain_o *base, VkSemaphore
 
 	self->mImageIndex = imageIndex;
 
-	// We only want to write out images which have made the round-trip
-	// the first n images will be black...
-	if ( self->totalImages > self->mImagecount ) {
-		if ( self->pipe ) {
-			// TODO: we should be able to do the write on the back thread.
-			// the back thread must signal that it is complete with writing
-			// before the next present command is executed.
-
-			// Write out frame contents to ffmpeg via pipe.
-			auto const &frame = self->transferFrames[ imageIndex ];
-			fwrite( frame.bufferAllocationInfo.pMappedData, self->mSwapchainExtent.width * self->mSwapchainExtent.height * 4, 1, self->pipe );
-
-		} else {
-			char file_name[ 1024 ];
-			sprintf( file_name, "isl_%08d.rgba", self->totalImages );
-			auto const &  frame = self->transferFrames[ imageIndex ];
-			std::ofstream myfile( file_name, std::ios::out | std::ios::binary );
-			myfile.write( ( char * )frame.bufferAllocationInfo.pMappedData, self->mSwapchainExtent.width * self->mSwapchainExtent.height * 4 );
-			myfile.close();
-			std::cout << "Wrote Image: " << file_name << std::endl
-			          << std::flush;
-		}
-	}
+	// Note that we don't write out any image data here - this happens on
+	// the writer thread, once the copy which was submitted on present has
+	// completed.
 
 	++self->totalImages;
 
@@ -478,6 +1249,13 @@ static bool swapchain_img_present( le_swapchain_o *base, VkQueue queue_, VkSemap
 
 	auto self = static_cast<img_data_o *const>( base->data );
 
+	auto const &frame = self->transferFrames[ *pImageIndex ];
+
+	// Find a readback slot into which to copy this frame. This may wait for
+	// the writer thread to release a slot, or, if frames may be dropped, fail.
+	uint32_t slot_index = 0;
+	bool     has_slot   = img_writer_acquire_free_slot( self, &slot_index );
+
 	vk::PipelineStageFlags wait_dst_stage_mask = ::vk::PipelineStageFlagBits::eColorAttachmentOutput;
 
 	auto renderCompleteSemaphore = vk::Semaphore{ renderCompleteSemaphore_ };
@@ -487,16 +1265,45 @@ static bool swapchain_img_present( le_swapchain_o *base, VkQueue queue_, VkSemap
 	    .setWaitSemaphoreCount( 1 )
 	    .setPWaitSemaphores( &renderCompleteSemaphore ) // the render complete semaphore tells us that the image has been written
 	    .setPWaitDstStageMask( &wait_dst_stage_mask )
-	    .setCommandBufferCount( 1 )
-	    .setPCommandBuffers( &self->transferFrames[ *pImageIndex ].cmdPresent ) // copies image to buffer
+	    .setCommandBufferCount( 0 )
+	    .setPCommandBuffers( nullptr )
 	    .setSignalSemaphoreCount( 0 )
 	    .setPSignalSemaphores( nullptr );
 
+	vk::Fence copyFence = nullptr;
+
+	if ( has_slot ) {
+		auto &slot       = self->readbackSlots[ slot_index ];
+		slot.frameNumber = self->totalImages - 1;
+
+		// Slot is free, which means that the writer thread has already waited
+		// for its fence - we may reset fence and re-record command buffer.
+		self->device.resetFences( { slot.copyFence } );
+		img_record_copy_commands( self, slot, frame );
+
+		submitInfo
+		    .setCommandBufferCount( 1 )
+		    .setPCommandBuffers( &slot.cmdCopy ); // copies image to buffer
+
+		copyFence = slot.copyFence;
+	}
+
 	// Todo: submit to this to a transfer queue, not main queue, if possible
 
 	{
 		vk::Queue queue{ queue_ };
-		queue.submit( { submitInfo }, self->transferFrames[ *pImageIndex ].frameFence );
+
+		// If frame was dropped, we still must wait for the render complete semaphore,
+		// which is why we submit even if there is no command buffer to execute.
+		queue.submit( 1, &submitInfo, copyFence );
+
+		// Signal frame fence once all work submitted so far has completed:
+		// this tells acquire that the image may be re-used.
+		queue.submit( 0, nullptr, frame.frameFence );
+	}
+
+	if ( has_slot ) {
+		img_writer_enqueue_slot( self, slot_index );
 	}
 
 	return true;
@@ -543,6 +1350,15 @@ static size_t swapchain_img_get_swapchain_images_count( le_swapchain_o *base ) {
 	return self->mImagecount;
 }
 
+// ----------------------------------------------------------------------
+// Image swapchains don't present to a display, and therefore don't collect
+// frame pacing statistics - see writer statistics printed on destroy instead.
+static bool swapchain_img_get_stats( le_swapchain_o *, le_swapchain_stats_t * ) {
+	return false;
+}
+
+// ----------------------------------------------------------------------
+
 static void swapchain_get_required_vk_instance_extensions( const le_swapchain_settings_t *, char const ***exts, size_t *num_exts ) {
 	static std::array<char const *, 0> extensions = {};
 
@@ -575,6 +1391,7 @@ void register_le_swapchain_img_api( void *api_ ) {
 	swapchain_i.get_image_height                    = swapchain_img_get_image_height;
 	swapchain_i.get_surface_format                  = swapchain_img_get_surface_format;
 	swapchain_i.get_images_count                    = swapchain_img_get_swapchain_images_count;
+	swapchain_i.get_stats                           = swapchain_img_get_stats;
 	swapchain_i.present                             = swapchain_img_present;
 	swapchain_i.get_required_vk_instance_extensions = swapchain_get_required_vk_instance_extensions;
 	swapchain_i.get_required_vk_device_extensions   = swapchain_get_required_vk_device_extensions;
@@ -0,0 +1,99 @@
+#ifndef GUARD_LE_SWAPCHAIN_IMG_SHM_H
+#define GUARD_LE_SWAPCHAIN_IMG_SHM_H
+
+#include <stdint.h>
+
+/*
+
+  Shared memory frame ring - memory layout, and reader protocol.
+
+  If an image swapchain is given a shm name (via img_settings), it publishes
+  each finished frame into a POSIX shared memory object of that name, instead
+  of writing frames to a pipe or to disk. Readers in other processes may map
+  this object read-only, and read frames in place.
+
+  The shared memory object is laid out like this:
+
+      [ le_img_shm_header_t | le_img_shm_slot_t[slot_count] | padding ]
+      [ frame data slot 0 ]     <- at offset `data_offset`, page-aligned
+      [ frame data slot 1 ]     <- at `data_offset + slot_stride`
+      ...
+
+  Frames are written round-robin: frame n goes into slot (n % slot_count).
+
+  The producer never waits for readers. Each slot carries a sequence
+  counter, which is odd while the producer writes to the slot, and even
+  once the slot is stable. A reader must therefore:
+
+  1. Wait for a new frame: futex-wait on `header->frames_published`, for
+     as long as it equals the last value seen. The producer increments this
+     counter, then wakes all waiters, after each published frame. It also
+     wakes waiters when it detaches (`producer_attached` becomes 0).
+
+  2. Pick slot `( frames_published - 1 ) % slot_count`, read its sequence
+     counter (acquire), and skip the slot if the sequence is odd.
+
+  3. Read frame data, and slot metadata.
+
+  4. Re-read the sequence counter (acquire) - if it changed, the producer
+     has overwritten the slot while it was being read, and the frame must
+     be discarded.
+
+  Readers which need more time per frame than the producer needs for
+  `slot_count` frames will see torn frames, which step 4 detects.
+
+  Counters are accessed with the atomic builtins, and the futex words are
+  32 bit wide, as required by futex(2). Futexes are not private, since
+  they are shared between processes.
+
+*/
+
+#define LE_IMG_SHM_MAGIC 0x4d48534c // 'LSHM'
+#define LE_IMG_SHM_VERSION 1
+
+struct le_img_shm_header_t {
+	uint32_t magic;             // must be LE_IMG_SHM_MAGIC
+	uint32_t version;           // must be LE_IMG_SHM_VERSION
+	uint32_t width;             // frame width in pixels
+	uint32_t height;            // frame height in pixels
+	uint32_t format;            // VkFormat of frame data
+	uint32_t bytes_per_row;     // row pitch of frame data; rows are tightly packed
+	uint32_t slot_count;        // number of frame slots in ring
+	uint32_t producer_attached; // 1 while the producer is alive, 0 once it has detached
+	uint64_t frame_data_size;   // number of bytes per frame
+	uint64_t data_offset;       // offset in bytes from start of shared memory to frame data of slot 0
+	uint64_t slot_stride;       // offset in bytes from one slot's frame data to the next
+	uint32_t frames_published;  // futex word - incremented after each published frame
+	uint32_t reserved;          //
+};
+
+struct le_img_shm_slot_t {
+	uint32_t sequence;     // futex word - odd while producer writes to this slot, even when slot is stable
+	uint32_t reserved;     //
+	uint64_t frame_number; // number of frame held by this slot
+	uint64_t timestamp_ns; // CLOCK_MONOTONIC time at which frame was published, in nanoseconds
+};
+
+#ifdef __cplusplus
+
+inline le_img_shm_slot_t *le_img_shm_get_slots( le_img_shm_header_t *header ) {
+	return reinterpret_cast<le_img_shm_slot_t *>( header + 1 );
+}
+
+inline void *le_img_shm_get_slot_data( le_img_shm_header_t *header, uint32_t slot_index ) {
+	return reinterpret_cast<char *>( header ) + header->data_offset + header->slot_stride * slot_index;
+}
+
+// Returns size in bytes needed for a shared memory frame ring.
+inline uint64_t le_img_shm_calculate_size( uint32_t slot_count, uint64_t frame_data_size, uint64_t *data_offset, uint64_t *slot_stride ) {
+	constexpr uint64_t page_size = 4096;
+	auto               align_up  = []( uint64_t v, uint64_t a ) { return ( v + a - 1 ) & ~( a - 1 ); };
+
+	*data_offset = align_up( sizeof( le_img_shm_header_t ) + sizeof( le_img_shm_slot_t ) * slot_count, page_size );
+	*slot_stride = align_up( frame_data_size, page_size );
+
+	return *data_offset + *slot_stride * slot_count;
+}
+
+#endif // __cplusplus
+#endif // GUARD_LE_SWAPCHAIN_IMG_SHM_H
@@ -51,6 +51,12 @@ static size_t swapchain_get_swapchain_images_count( le_swapchain_o *self ) {
 
 // ----------------------------------------------------------------------
 
+static bool swapchain_get_stats( le_swapchain_o *self, le_swapchain_stats_t *stats ) {
+	return self->vtable.get_stats( self, stats );
+}
+
+// ----------------------------------------------------------------------
+
 static void swapchain_destroy( le_swapchain_o *self ) {
 	self->vtable.destroy( self );
 }
@@ -111,6 +117,7 @@ LE_MODULE_REGISTER_IMPL( le_swapchain_vk, api_ ) {
 	swapchain_i.get_image_height                    = swapchain_get_image_height;
 	swapchain_i.get_surface_format                  = swapchain_get_surface_format;
 	swapchain_i.get_images_count                    = swapchain_get_swapchain_images_count;
+	swapchain_i.get_stats                           = swapchain_get_stats;
 	swapchain_i.present                             = swapchain_present;
 	swapchain_i.get_required_vk_instance_extensions = swapchain_get_required_vk_instance_extensions;
 	swapchain_i.get_required_vk_device_extensions   = swapchain_get_required_vk_device_extensions;
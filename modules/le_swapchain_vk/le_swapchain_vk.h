@@ -16,6 +16,7 @@ struct VkImageView_T;
 struct VkQueue_T;
 struct VkSurfaceFormatKHR;
 struct le_swapchain_settings_t;
+struct le_swapchain_stats_t;
 
 struct le_swapchain_vk_api {
 
@@ -31,6 +32,7 @@ struct le_swapchain_vk_api {
 		uint32_t                  ( *get_image_width          ) ( le_swapchain_o* self );
 		uint32_t                  ( *get_image_height         ) ( le_swapchain_o* self );
 		size_t                    ( *get_images_count         ) ( le_swapchain_o* self );
+		bool                      ( *get_stats                ) ( le_swapchain_o* self, le_swapchain_stats_t* stats ); // returns false if swapchain does not collect frame pacing statistics
 		
 		void                      ( *get_required_vk_instance_extensions )(const le_swapchain_settings_t* settings, char const *** exts, size_t * num_exts);
 		void                      ( *get_required_vk_device_extensions )(const le_swapchain_settings_t* settings, char const *** exts, size_t * num_exts);
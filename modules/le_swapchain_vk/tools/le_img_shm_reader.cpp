@@ -0,0 +1,236 @@
+/*
+
+  Tool: reads frames from an image swapchain's shared memory frame ring.
+
+  This is a standalone program, which does not depend on any island module.
+  It gets built as target `le_img_shm_reader` alongside any app which uses
+  le_swapchain_vk, or, from the island root directory, with:
+
+      c++ -std=c++17 -O2 -I modules \
+          modules/le_swapchain_vk/tools/le_img_shm_reader.cpp -o le_img_shm_reader -lrt
+
+  Then, while an app with an image swapchain whose `img_settings.shm_name`
+  is set is running, run:
+
+      ./le_img_shm_reader <shm_name> [frame_count] [output_prefix]
+
+  The reader attaches to the ring, prints its header, and then follows the
+  reader protocol documented in le_swapchain_img_shm.h: it waits for new
+  frames, copies each one out of its slot, and discards frames which the
+  producer overwrote while they were being copied. For each frame it prints
+  frame number, and latency from publish to end of copy.
+
+  If `output_prefix` is given, each frame which was read gets written to
+  `<output_prefix>_<frame_number>.rgba`, in the same raw format which the
+  image swapchain uses when it writes frames to disk.
+
+  Stops after `frame_count` frames (default: run until the producer
+  detaches), and prints how many frames were read, torn, and missed. Note
+  that the producer detaches, and re-creates the ring, whenever its extent
+  changes - run the reader again to attach to the new ring.
+
+  Linux only - the ring relies on POSIX shared memory, and futexes.
+
+*/
+
+#include "le_swapchain_vk/le_swapchain_img_shm.h"
+
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// ----------------------------------------------------------------------
+
+static uint64_t now_ns() {
+	timespec now{};
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return uint64_t( now.tv_sec ) * 1'000'000'000 + uint64_t( now.tv_nsec );
+}
+
+// ----------------------------------------------------------------------
+// Blocks until `*word` is no longer equal to `value`, or until timeout.
+// May return early, callers must re-check.
+static void futex_wait( uint32_t const *word, uint32_t value ) {
+	timespec timeout{ 1, 0 }; // so that we notice a producer which went away without waking us
+	syscall( SYS_futex, word, FUTEX_WAIT, value, &timeout, nullptr, 0 );
+}
+
+// ----------------------------------------------------------------------
+
+static bool write_frame( char const *output_prefix, uint64_t frame_number, std::vector<char> const &frame ) {
+
+	std::string const file_name = std::string( output_prefix ) + "_" + std::to_string( frame_number ) + ".rgba";
+
+	FILE *file = fopen( file_name.c_str(), "wb" );
+
+	if ( nullptr == file ) {
+		fprintf( stderr, "ERROR: Could not open file for writing: '%s'\n", file_name.c_str() );
+		return false;
+	}
+
+	bool const result = ( 1 == fwrite( frame.data(), frame.size(), 1, file ) );
+
+	fclose( file );
+
+	return result;
+}
+
+// ----------------------------------------------------------------------
+
+int main( int argc, char const **argv ) {
+
+	if ( argc < 2 ) {
+		fprintf( stderr, "usage: %s <shm_name> [frame_count] [output_prefix]\n", argv[ 0 ] );
+		return 1;
+	}
+
+	char const *shm_name      = argv[ 1 ];
+	uint64_t    frame_count   = argc > 2 ? strtoull( argv[ 2 ], nullptr, 10 ) : 0; // 0 means: no limit
+	char const *output_prefix = argc > 3 ? argv[ 3 ] : nullptr;
+
+	int fd = shm_open( shm_name, O_RDONLY, 0 );
+
+	if ( fd == -1 ) {
+		fprintf( stderr, "ERROR: Could not open shared memory object '%s': %s\n", shm_name, strerror( errno ) );
+		return 1;
+	}
+
+	struct stat st {};
+
+	void *mapping = MAP_FAILED;
+
+	if ( 0 == fstat( fd, &st ) && size_t( st.st_size ) >= sizeof( le_img_shm_header_t ) ) {
+		mapping = mmap( nullptr, size_t( st.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+	}
+
+	close( fd ); // mapping, if successful, keeps shared memory object alive.
+
+	if ( mapping == MAP_FAILED ) {
+		fprintf( stderr, "ERROR: Could not map shared memory object '%s'\n", shm_name );
+		return 1;
+	}
+
+	// The ring is mapped read-only - we only ever read through it.
+	auto header = static_cast<le_img_shm_header_t const *>( mapping );
+
+	if ( __atomic_load_n( &header->magic, __ATOMIC_ACQUIRE ) != LE_IMG_SHM_MAGIC ||
+	     header->version != LE_IMG_SHM_VERSION ) {
+		fprintf( stderr, "ERROR: '%s' is not a frame ring, or has an unsupported version\n", shm_name );
+		munmap( mapping, size_t( st.st_size ) );
+		return 1;
+	}
+
+	// --------| invariant: header is complete, and immutable from here on (other than its counters)
+
+	uint64_t data_offset = 0;
+	uint64_t slot_stride = 0;
+
+	uint64_t const expected_size = le_img_shm_calculate_size( header->slot_count, header->frame_data_size, &data_offset, &slot_stride );
+
+	if ( uint64_t( st.st_size ) < expected_size || data_offset != header->data_offset || slot_stride != header->slot_stride ) {
+		fprintf( stderr, "ERROR: Frame ring layout in '%s' is inconsistent with its header\n", shm_name );
+		munmap( mapping, size_t( st.st_size ) );
+		return 1;
+	}
+
+	printf( "Frame ring '%s': %ux%u, VkFormat %u, %u bytes per row, %u slots, %llu bytes per frame\n",
+	        shm_name, header->width, header->height, header->format, header->bytes_per_row,
+	        header->slot_count, ( unsigned long long )header->frame_data_size );
+
+	// Accessors in le_swapchain_img_shm.h take non-const pointers.
+	auto mutable_header = const_cast<le_img_shm_header_t *>( header );
+	auto slots          = le_img_shm_get_slots( mutable_header );
+
+	std::vector<char> frame( header->frame_data_size );
+
+	uint64_t num_read   = 0;
+	uint64_t num_torn   = 0;
+	uint64_t num_missed = 0;
+
+	uint64_t last_frame_number = 0;
+	bool     has_last_frame    = false;
+
+	uint32_t last_published = __atomic_load_n( &header->frames_published, __ATOMIC_ACQUIRE );
+
+	while ( frame_count == 0 || num_read < frame_count ) {
+
+		// 1. Wait for a new frame.
+
+		uint32_t published = __atomic_load_n( &header->frames_published, __ATOMIC_ACQUIRE );
+
+		if ( published == last_published ) {
+			if ( 0 == __atomic_load_n( &header->producer_attached, __ATOMIC_ACQUIRE ) ) {
+				printf( "Producer has detached.\n" );
+				break;
+			}
+			futex_wait( &header->frames_published, last_published );
+			continue;
+		}
+
+		last_published = published;
+
+		// 2. Pick most recent slot, skip it if the producer is writing to it.
+
+		uint32_t const           slot_index = ( published - 1 ) % header->slot_count;
+		le_img_shm_slot_t const *slot       = slots + slot_index;
+
+		uint32_t const sequence = __atomic_load_n( &slot->sequence, __ATOMIC_ACQUIRE );
+
+		if ( sequence & 1 ) {
+			num_torn++;
+			continue;
+		}
+
+		// 3. Read frame data, and slot metadata.
+
+		memcpy( frame.data(), le_img_shm_get_slot_data( mutable_header, slot_index ), frame.size() );
+
+		uint64_t const frame_number = slot->frame_number;
+		uint64_t const timestamp_ns = slot->timestamp_ns;
+
+		// 4. Discard frame if the producer overwrote the slot while we were reading.
+
+		__atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+		if ( __atomic_load_n( &slot->sequence, __ATOMIC_RELAXED ) != sequence ) {
+			num_torn++;
+			continue;
+		}
+
+		uint64_t const latency_ns = now_ns() - timestamp_ns;
+
+		if ( has_last_frame && frame_number > last_frame_number + 1 ) {
+			num_missed += frame_number - last_frame_number - 1;
+		}
+
+		last_frame_number = frame_number;
+		has_last_frame    = true;
+
+		num_read++;
+
+		printf( "frame %8llu  slot %2u  latency %8.3f ms\n",
+		        ( unsigned long long )frame_number, slot_index, double( latency_ns ) / 1'000'000.0 );
+
+		if ( output_prefix && !write_frame( output_prefix, frame_number, frame ) ) {
+			break;
+		}
+	}
+
+	printf( "Read %llu frames, discarded %llu torn frames, missed %llu frames.\n",
+	        ( unsigned long long )num_read, ( unsigned long long )num_torn, ( unsigned long long )num_missed );
+
+	munmap( mapping, size_t( st.st_size ) );
+
+	return 0;
+}
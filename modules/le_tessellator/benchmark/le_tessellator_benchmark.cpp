@@ -0,0 +1,205 @@
+/*
+
+  Benchmark: fast paths for convex and monotone contours vs. earcut and libtess.
+
+  This is a standalone program, and not part of the build. Build from the
+  island root directory with:
+
+      c++ -std=c++17 -O2 -DNDEBUG -I . -I modules -I 3rdparty/src/glm \
+          -I modules/le_tessellator/3rdparty/libtess2/Include \
+          -x c++ modules/le_tessellator/benchmark/le_tessellator_benchmark.cpp \
+          -x c modules/le_tessellator/3rdparty/libtess2/Source/{bucketalloc,dict,geom,mesh,priorityq,sweep,tess}.c \
+          -o le_tessellator_benchmark
+
+  Then run:
+
+      ./le_tessellator_benchmark [num_shapes] [num_iterations]
+
+  The test scene is a mix of what we typically fill: rounded rectangles and
+  ellipses (convex), wavy blobs (monotone in y, but not convex), and stars
+  (neither, these always take the general path). Each shape is tessellated
+  on its own, using one tessellator, which is reset between shapes.
+
+*/
+
+#include "../le_tessellator.cpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <random>
+#include <stdlib.h>
+
+// Benchmarks don't link le_core - this is all that's needed to load
+// le_tessellator statically.
+ISL_API_ATTR void *le_core_load_module_static( char const *, void ( *module_reg_fun )( void * ), uint64_t api_size_in_bytes ) {
+	void *api = calloc( 1, api_size_in_bytes );
+	module_reg_fun( api );
+	return api;
+}
+
+using Shape = std::vector<Point>;
+
+// ----------------------------------------------------------------------
+
+static void add_rounded_rect( std::vector<Shape> &shapes, Point origin, Point extents, float radius ) {
+	Shape s;
+
+	constexpr int num_corner_segments = 8;
+
+	Point const corners[ 4 ] = {
+	    { origin.x + extents.x - radius, origin.y + extents.y - radius },
+	    { origin.x + radius, origin.y + extents.y - radius },
+	    { origin.x + radius, origin.y + radius },
+	    { origin.x + extents.x - radius, origin.y + radius },
+	};
+
+	for ( int c = 0; c != 4; c++ ) {
+		for ( int i = 0; i <= num_corner_segments; i++ ) {
+			float const angle = glm::half_pi<float>() * ( float( c ) + float( i ) / float( num_corner_segments ) );
+			s.push_back( corners[ c ] + radius * Point{ cosf( angle ), sinf( angle ) } );
+		}
+	}
+
+	s.push_back( s.front() ); // closed polylines repeat their first point
+	shapes.emplace_back( std::move( s ) );
+}
+
+// ----------------------------------------------------------------------
+
+static void add_ellipse( std::vector<Shape> &shapes, Point origin, Point radii, int num_segments ) {
+	Shape s;
+	for ( int i = 0; i != num_segments; i++ ) {
+		float const angle = glm::two_pi<float>() * float( i ) / float( num_segments );
+		s.push_back( origin + radii * Point{ cosf( angle ), sinf( angle ) } );
+	}
+	shapes.emplace_back( std::move( s ) );
+}
+
+// ----------------------------------------------------------------------
+// Ellipse with a wavy outline: monotone in y, but not convex.
+static void add_blob( std::vector<Shape> &shapes, Point origin, Point radii, int num_segments, float wave ) {
+	Shape s;
+	for ( int i = 0; i != num_segments; i++ ) {
+		float const angle = glm::two_pi<float>() * float( i ) / float( num_segments );
+		float const x     = cosf( angle ) * ( radii.x + wave * sinf( angle * 12.f ) );
+		s.push_back( origin + Point{ x, radii.y * sinf( angle ) } );
+	}
+	shapes.emplace_back( std::move( s ) );
+}
+
+// ----------------------------------------------------------------------
+
+static void add_star( std::vector<Shape> &shapes, Point origin, float radius, int num_points ) {
+	Shape s;
+	for ( int i = 0; i != num_points * 2; i++ ) {
+		float const angle = glm::pi<float>() * float( i ) / float( num_points );
+		float const r     = ( i & 1 ) ? radius * 0.4f : radius;
+		s.push_back( origin + r * Point{ cosf( angle ), sinf( angle ) } );
+	}
+	shapes.emplace_back( std::move( s ) );
+}
+
+// ----------------------------------------------------------------------
+
+static void build_scene( std::vector<Shape> &shapes, size_t num_shapes ) {
+
+	std::mt19937                          rng( 12345 );
+	std::uniform_real_distribution<float> size( 10.f, 100.f );
+	std::uniform_int_distribution<int>    kind( 0, 9 );
+
+	for ( size_t i = 0; i != num_shapes; i++ ) {
+		Point const origin{ float( i % 32 ) * 120.f, float( i / 32 ) * 120.f };
+		Point const extents{ size( rng ), size( rng ) };
+
+		int const k = kind( rng );
+
+		if ( k < 4 ) {
+			add_rounded_rect( shapes, origin, extents, 0.2f * std::min( extents.x, extents.y ) );
+		} else if ( k < 7 ) {
+			add_ellipse( shapes, origin, extents * 0.5f, 64 );
+		} else if ( k < 9 ) {
+			add_blob( shapes, origin, extents * 0.5f, 96, 0.05f * extents.x );
+		} else {
+			add_star( shapes, origin, extents.x * 0.5f, 5 );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+
+struct Result {
+	double                                                  ms;
+	size_t                                                  num_triangles;
+	le_tessellator_api::le_tessellator_interface_t::stats_t stats;
+};
+
+static Result measure( std::vector<Shape> const &shapes, uint64_t options, size_t num_iterations ) {
+
+	le_tessellator_o *tess = le_tessellator_create();
+	le_tessellator_set_options( tess, options );
+
+	Result result{};
+
+	auto run = [ & ]() {
+		result.num_triangles = 0;
+		for ( auto const &s : shapes ) {
+			le_tessellator_reset( tess );
+			le_tessellator_add_polyline( tess, s.data(), s.size() );
+			le_tessellator_tessellate( tess );
+			result.num_triangles += tess->indices.size() / 3;
+		}
+	};
+
+	run(); // warm up
+
+	auto t0 = std::chrono::steady_clock::now();
+	for ( size_t i = 0; i != num_iterations; i++ ) {
+		run();
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	result.ms = std::chrono::duration<double, std::milli>( t1 - t0 ).count() / double( num_iterations );
+
+	le_tessellator_get_stats( tess, &result.stats );
+	le_tessellator_destroy( tess );
+
+	return result;
+}
+
+// ----------------------------------------------------------------------
+
+static void print_result( char const *name, Result const &r ) {
+	printf( "%-28s %10.3f ms/iteration, %8zu triangles | convex: %8llu, monotone: %8llu, earcut: %8llu, libtess: %8llu\n",
+	        name, r.ms, r.num_triangles,
+	        ( unsigned long long )r.stats.num_convex, ( unsigned long long )r.stats.num_monotone,
+	        ( unsigned long long )r.stats.num_earcut, ( unsigned long long )r.stats.num_libtess );
+}
+
+// ----------------------------------------------------------------------
+
+int main( int argc, char const **argv ) {
+
+	size_t const num_shapes     = argc > 1 ? size_t( atol( argv[ 1 ] ) ) : 4096;
+	size_t const num_iterations = argc > 2 ? size_t( atol( argv[ 2 ] ) ) : 20;
+
+	std::vector<Shape> shapes;
+	build_scene( shapes, num_shapes );
+
+	uint64_t const libtess = Options::eWindingNonzero;
+	uint64_t const earcut  = Options::bitUseEarcutTessellator;
+
+	Result const libtess_only = measure( shapes, libtess | Options::bitDisableFastPaths, num_iterations );
+	Result const libtess_fast = measure( shapes, libtess, num_iterations );
+	Result const earcut_only  = measure( shapes, earcut | Options::bitDisableFastPaths, num_iterations );
+	Result const earcut_fast  = measure( shapes, earcut, num_iterations );
+
+	printf( "le_tessellator: %zu shapes\n", num_shapes );
+	print_result( "libtess", libtess_only );
+	print_result( "libtess, with fast paths", libtess_fast );
+	print_result( "earcut", earcut_only );
+	print_result( "earcut, with fast paths", earcut_fast );
+	printf( "speedup: libtess %.2fx, earcut %.2fx\n", libtess_only.ms / libtess_fast.ms, earcut_only.ms / earcut_fast.ms );
+
+	return 0;
+}
@@ -5,10 +5,14 @@
 #include "tesselator.h"
 
 #include <string.h> // memcpy
+#include <stdlib.h> // malloc, free
+#include <algorithm>
+#include <limits>
 #include <glm/vec2.hpp>
 
 using Point     = glm::vec2;
 using IndexType = le_tessellator_api::IndexType;
+using Options   = le_tessellator::Options;
 
 namespace mapbox {
 namespace util {
@@ -29,89 +33,632 @@ struct nth<1, Point> {
 } // namespace util
 } // namespace mapbox
 
+// ----------------------------------------------------------------------
+// Bump allocator which backs libtess. libtess frees everything it allocates
+// by the end of each tessellation, so that we can make `free` a no-op, and
+// instead rewind the arena to where it was before the run. Blocks are kept
+// across runs: once the arena has grown to fit the largest input seen so
+// far, tessellating does not allocate anymore.
+//
+// The arena is called from within libtess, which is C: it must not throw.
+// Instead, it returns nullptr if it runs out of memory, which makes libtess
+// bail out of the current run.
+struct TessArena {
+
+	static constexpr size_t Alignment    = 16; // also the size of the header which stores the size of each allocation
+	static constexpr size_t MinBlockSize = 64 * 1024;
+	static constexpr size_t MaxBlocks    = 48; // block sizes double, so that we run out of memory long before we run out of blocks
+
+	struct Block {
+		char * data;
+		size_t size;
+	};
+
+	struct Mark {
+		size_t block_index;
+		size_t offset;
+	};
+
+	Block  blocks[ MaxBlocks ]{};
+	size_t num_blocks  = 0;
+	size_t block_index = 0; // block which we currently allocate from
+	size_t offset      = 0; // offset of next free byte in current block
+	void * last_alloc  = nullptr;
+};
+
+// ----------------------------------------------------------------------
+
+static size_t tess_arena_align( size_t size ) {
+	return ( size + TessArena::Alignment - 1 ) & ~( TessArena::Alignment - 1 );
+}
+
+// ----------------------------------------------------------------------
+
+static void *tess_arena_alloc( void *user_data, unsigned int size ) {
+	auto arena = static_cast<TessArena *>( user_data );
+
+	size_t const num_bytes = TessArena::Alignment + tess_arena_align( size );
+
+	// Find a block which fits the allocation - skip any blocks which don't.
+	while ( arena->block_index < arena->num_blocks &&
+	        arena->offset + num_bytes > arena->blocks[ arena->block_index ].size ) {
+		arena->block_index++;
+		arena->offset = 0;
+	}
+
+	if ( arena->block_index == arena->num_blocks ) {
+
+		if ( arena->num_blocks == TessArena::MaxBlocks ) {
+			return nullptr;
+		}
+
+		size_t block_size = arena->num_blocks ? arena->blocks[ arena->num_blocks - 1 ].size * 2 : TessArena::MinBlockSize;
+		block_size        = std::max( block_size, num_bytes );
+
+		// malloc returns memory aligned to at least 16 bytes.
+		char *data = static_cast<char *>( malloc( block_size ) );
+
+		if ( data == nullptr ) {
+			return nullptr;
+		}
+
+		arena->blocks[ arena->num_blocks++ ] = { data, block_size };
+		arena->offset                        = 0;
+	}
+
+	char *header = arena->blocks[ arena->block_index ].data + arena->offset;
+	arena->offset += num_bytes;
+
+	*reinterpret_cast<size_t *>( header ) = size;
+	arena->last_alloc                     = header + TessArena::Alignment;
+
+	return arena->last_alloc;
+}
+
+// ----------------------------------------------------------------------
+
+static void *tess_arena_realloc( void *user_data, void *ptr, unsigned int size ) {
+	auto arena = static_cast<TessArena *>( user_data );
+
+	if ( ptr == nullptr ) {
+		return tess_arena_alloc( user_data, size );
+	}
+
+	size_t &old_size = *reinterpret_cast<size_t *>( static_cast<char *>( ptr ) - TessArena::Alignment );
+
+	if ( size <= tess_arena_align( old_size ) ) {
+		old_size = std::max<size_t>( old_size, size );
+		return ptr;
+	}
+
+	// If this was the most recent allocation, we may be able to grow it in place.
+	if ( ptr == arena->last_alloc ) {
+		auto const & block      = arena->blocks[ arena->block_index ];
+		size_t const ptr_offset = size_t( static_cast<char *>( ptr ) - block.data );
+		size_t const new_offset = ptr_offset + tess_arena_align( size );
+		if ( new_offset <= block.size ) {
+			arena->offset = new_offset;
+			old_size      = size;
+			return ptr;
+		}
+	}
+
+	void *result = tess_arena_alloc( user_data, size );
+	if ( result ) {
+		memcpy( result, ptr, old_size );
+	}
+	return result;
+}
+
+// ----------------------------------------------------------------------
+
+static void tess_arena_free( void *, void * ) {
+	// No-op: memory is reclaimed in bulk via tess_arena_reset_to().
+}
+
+// ----------------------------------------------------------------------
+
+static void tess_arena_reset_to( TessArena *arena, TessArena::Mark const &mark ) {
+	arena->block_index = mark.block_index;
+	arena->offset      = mark.offset;
+	arena->last_alloc  = nullptr;
+}
+
+// ----------------------------------------------------------------------
+
+static void tess_arena_free_blocks( TessArena *arena ) {
+	for ( size_t i = 0; i != arena->num_blocks; i++ ) {
+		free( arena->blocks[ i ].data );
+	}
+	arena->num_blocks = 0;
+	tess_arena_reset_to( arena, {} );
+}
+
+// ----------------------------------------------------------------------
+// View onto a contour stored in `le_tessellator_o::points` - earcut reads
+// contours through this, so that it does not need contours to be copied.
+struct ContourView {
+	using value_type = Point;
+
+	Point const *points;
+	size_t       count;
+
+	size_t size() const {
+		return count;
+	}
+	Point const &operator[]( size_t i ) const {
+		return points[ i ];
+	}
+};
+
+struct SweepVertex {
+	IndexType index; // index into le_tessellator_o::points
+	uint32_t  chain; // 0: left-hand chain, 1: right-hand chain, when walking the contour forward from its first vertex in sweep order
+};
+
 struct le_tessellator_o {
-	std::vector<std::vector<Point>> contours;
-	std::vector<IndexType>          indices;
-	std::vector<Point>              vertices;
-	uint64_t                        options;
+	std::vector<Point>     points;       // input points of all contours, back-to-back
+	std::vector<size_t>    contour_ends; // one past the last point of each contour, as index into points
+	std::vector<IndexType> indices;
+	std::vector<Point>     vertices;     // output vertices, if tessellated with libtess
+	uint64_t               options = 0;
+
+	bool has_libtess_result = false; // whether indices refer to `vertices` rather than to `points`
+
+	// libtess context is kept alive across calls to tessellate, and all its
+	// memory comes from `arena`, which we rewind to `arena_mark` before each run.
+	TESStesselator * tess = nullptr;
+	TESSalloc        tess_alloc{};
+	TessArena        arena;
+	TessArena::Mark  arena_mark{};
+
+	mapbox::detail::Earcut<IndexType> earcut;
+	std::vector<ContourView>          earcut_contours;
+
+	// Scratch storage for fast paths
+	std::vector<IndexType>   ring;        // indices of contour points, without repeated points
+	std::vector<SweepVertex> sweep;       // contour vertices in sweep order
+	std::vector<uint32_t>    sweep_stack; // positions into sweep
+
+	le_tessellator_api::le_tessellator_interface_t::stats_t stats{};
 };
 
 // ----------------------------------------------------------------------
 
 static le_tessellator_o *le_tessellator_create() {
 	auto self = new le_tessellator_o();
+
+	self->tess_alloc.memalloc   = tess_arena_alloc;
+	self->tess_alloc.memrealloc = tess_arena_realloc;
+	self->tess_alloc.memfree    = tess_arena_free;
+	self->tess_alloc.userData   = &self->arena;
+
 	return self;
 }
 
 // ----------------------------------------------------------------------
 
 static void le_tessellator_destroy( le_tessellator_o *self ) {
+	if ( self->tess ) {
+		tessDeleteTess( self->tess );
+	}
+	tess_arena_free_blocks( &self->arena );
 	delete self;
 }
 
 // ----------------------------------------------------------------------
 
 static void le_tessellator_add_polyline( le_tessellator_o *self, Point const *const pPoints, size_t const &pointCount ) {
-	// Add new contour
-	self->contours.insert( self->contours.end(), { pPoints, pPoints + pointCount } );
+	self->points.insert( self->points.end(), pPoints, pPoints + pointCount );
+	self->contour_ends.push_back( self->points.size() );
+}
 
-	// append to vertices
-	self->vertices.insert( self->vertices.end(), pPoints, pPoints + pointCount );
+// ----------------------------------------------------------------------
+// Winding rule is stored in three bits, above the flag bits.
+static int get_winding_rule( uint64_t options ) {
+	return int( ( options >> le_tessellator_api::le_tessellator_interface_t::OptionsWindingsOffset ) & 0x7 );
 }
 
 // ----------------------------------------------------------------------
+// Fast paths
+//
+// Most of what we fill - rounded rectangles, ellipses, parts of glyphs - is
+// a single contour which is either convex, or monotone in y. Neither needs a
+// general-purpose tessellator: convex contours become a triangle fan, and
+// monotone contours are triangulated in one sweep, both in linear time, and
+// without allocating once scratch storage has grown to fit. Like earcut, fast
+// paths emit indices into the input points.
+
+// Order in which we sweep: by y, then by x.
+static inline bool sweep_less( Point const &a, Point const &b ) {
+	return a.y < b.y || ( a.y == b.y && a.x < b.x );
+}
 
-static bool le_tessellator_tessellate( le_tessellator_o *self ) {
+// ----------------------------------------------------------------------
 
-	// Run tessellation
-	if ( self->options & le_tessellator::Options::bitUseEarcutTessellator ) {
-		// Use earcut tessellator
-		self->indices = mapbox::earcut<IndexType>( self->contours );
-	} else {
-		// Use libtess
-		TESStesselator *tess;
-		tess = tessNewTess( nullptr );
-
-		tessSetOption( tess, TessOption::TESS_CONSTRAINED_DELAUNAY_TRIANGULATION,
-		               self->options & le_tessellator::Options::bitConstrainedDelaunayTriangulation );
-
-		tessSetOption( tess, TessOption::TESS_REVERSE_CONTOURS,
-		               self->options & le_tessellator::Options::bitReverseContours );
-
-		for ( auto const &contour : self->contours ) {
-			tessAddContour( tess, Point::type::length(), contour.data(), sizeof( Point ), int( contour.size() ) );
+static inline float cross( Point const &a, Point const &b, Point const &c ) {
+	return ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x );
+}
+
+// ----------------------------------------------------------------------
+
+enum class ContourClass : uint32_t {
+	eComplex = 0,
+	eConvex,
+	eMonotone,
+};
+
+// ----------------------------------------------------------------------
+// Classifies the single contour in `points` in one pass. Fills `ring` with
+// indices of contour points, with repeated points removed, and sets
+// `orientation` to +1 if contour is counter-clockwise, -1 otherwise.
+static ContourClass classify_contour( le_tessellator_o *self, float *orientation ) {
+
+	auto &       ring       = self->ring;
+	Point const *p          = self->points.data();
+	size_t const num_points = self->points.size();
+
+	ring.clear();
+
+	if ( num_points > size_t( std::numeric_limits<IndexType>::max() ) ) {
+		return ContourClass::eComplex;
+	}
+
+	for ( size_t i = 0; i != num_points; i++ ) {
+		if ( ring.empty() || p[ i ] != p[ ring.back() ] ) {
+			ring.push_back( IndexType( i ) );
 		}
+	}
 
-		tessTesselate( tess,
-		               int( self->options >> le_tessellator_api::le_tessellator_interface_t::OptionsWindingsOffset ),
-		               TessElementType::TESS_POLYGONS,
-		               3, // max number of vertices per polygon - we want triangles.
-		               Point::length(),
-		               nullptr );
+	// Closed polylines repeat their first point at the end.
+	while ( ring.size() > 1 && p[ ring.back() ] == p[ ring.front() ] ) {
+		ring.pop_back();
+	}
+
+	size_t const n = ring.size();
+
+	if ( n < 3 ) {
+		return ContourClass::eComplex;
+	}
+
+	float    area                  = 0;
+	bool     has_left_turn         = false;
+	bool     has_right_turn        = false;
+	uint32_t num_direction_changes = 0; // how often the contour changes direction in sweep order
+
+	Point prev         = p[ ring[ n - 1 ] ];
+	Point prev_edge    = prev - p[ ring[ n - 2 ] ];
+	bool  prev_forward = sweep_less( p[ ring[ n - 2 ] ], prev );
+
+	for ( size_t i = 0; i != n; i++ ) {
+		Point const &curr    = p[ ring[ i ] ];
+		Point const  edge    = curr - prev;
+		float const  turn    = prev_edge.x * edge.y - prev_edge.y * edge.x;
+		bool const   forward = sweep_less( prev, curr );
+
+		has_left_turn |= turn > 0;
+		has_right_turn |= turn < 0;
+		num_direction_changes += ( forward != prev_forward );
+
+		area += prev.x * curr.y - curr.x * prev.y;
+
+		prev         = curr;
+		prev_edge    = edge;
+		prev_forward = forward;
+	}
 
+	// A contour which changes direction exactly twice in sweep order goes
+	// once up, and once down - it is monotone. If it also only ever turns
+	// one way, it is convex.
+	if ( num_direction_changes != 2 || area == 0 ) {
+		return ContourClass::eComplex;
+	}
+
+	*orientation = area > 0 ? 1.f : -1.f;
+
+	if ( !( has_left_turn && has_right_turn ) ) {
+		return ContourClass::eConvex;
+	}
+
+	return ContourClass::eMonotone;
+}
+
+// ----------------------------------------------------------------------
+// Emits a triangle with the same orientation as the contour.
+static inline void emit_triangle( std::vector<IndexType> &indices, Point const *p, float orientation, IndexType a, IndexType b, IndexType c ) {
+	if ( cross( p[ a ], p[ b ], p[ c ] ) * orientation < 0 ) {
+		std::swap( b, c );
+	}
+	indices.push_back( a );
+	indices.push_back( b );
+	indices.push_back( c );
+}
+
+// ----------------------------------------------------------------------
+
+static void triangulate_convex( le_tessellator_o *self ) {
+	auto const & ring = self->ring;
+	size_t const n    = ring.size();
+
+	self->indices.reserve( ( n - 2 ) * 3 );
+
+	for ( size_t i = 1; i + 1 < n; i++ ) {
+		self->indices.push_back( ring[ 0 ] );
+		self->indices.push_back( ring[ i ] );
+		self->indices.push_back( ring[ i + 1 ] );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Triangulates a contour which is monotone in y, see: de Berg et al.,
+// "Computational Geometry", chapter 3.3. Returns false, and emits nothing,
+// if the two chains of the contour cross each other - in which case the
+// contour is self-intersecting, and must take the general path.
+static bool triangulate_monotone( le_tessellator_o *self, float orientation ) {
+
+	auto const & ring = self->ring;
+	Point const *p    = self->points.data();
+	size_t const n    = ring.size();
+
+	size_t i_min = 0;
+	size_t i_max = 0;
+
+	for ( size_t i = 1; i != n; i++ ) {
+		if ( sweep_less( p[ ring[ i ] ], p[ ring[ i_min ] ] ) ) {
+			i_min = i;
+		}
+		if ( sweep_less( p[ ring[ i_max ] ], p[ ring[ i ] ] ) ) {
+			i_max = i;
+		}
+	}
+
+	// Merge both chains into sweep order: chain 0 walks forward from i_min,
+	// chain 1 walks backward; both end at i_max. While we merge, we check
+	// that chain 0 stays on the same side of chain 1 throughout.
+
+	auto &sweep = self->sweep;
+	sweep.clear();
+	sweep.push_back( { ring[ i_min ], 0 } );
+
+	size_t a      = ( i_min + 1 ) % n;     // next vertex on chain 0
+	size_t b      = ( i_min + n - 1 ) % n; // next vertex on chain 1
+	size_t a_prev = i_min;
+	size_t b_prev = i_min;
+	float  side   = 0;
+
+	while ( a != i_max || b != i_max ) {
+
+		bool const take_a = ( b == i_max ) || ( a != i_max && sweep_less( p[ ring[ a ] ], p[ ring[ b ] ] ) );
+
+		// Side of the edge on the opposite chain which spans the vertex we take.
+		float s;
+
+		if ( take_a ) {
+			s = cross( p[ ring[ b_prev ] ], p[ ring[ b ] ], p[ ring[ a ] ] );
+			sweep.push_back( { ring[ a ], 0 } );
+			a_prev = a;
+			a      = ( a + 1 ) % n;
+		} else {
+			s = -cross( p[ ring[ a_prev ] ], p[ ring[ a ] ], p[ ring[ b ] ] );
+			sweep.push_back( { ring[ b ], 1 } );
+			b_prev = b;
+			b      = ( b + n - 1 ) % n;
+		}
+
+		if ( s * side < 0 ) {
+			return false; // chains cross
+		}
+		if ( side == 0 ) {
+			side = s;
+		}
+	}
+
+	sweep.push_back( { ring[ i_max ], 1 } );
+
+	size_t const m = sweep.size();
+
+	auto &indices = self->indices;
+	auto &stack   = self->sweep_stack;
+
+	indices.reserve( ( m - 2 ) * 3 );
+
+	stack.clear();
+	stack.push_back( 0 );
+	stack.push_back( 1 );
+
+	for ( size_t j = 2; j + 1 < m; j++ ) {
+		SweepVertex const &u = sweep[ j ];
+
+		if ( u.chain != sweep[ stack.back() ].chain ) {
+			// Vertex on opposite chain: it sees all vertices on the stack.
+			for ( size_t k = 0; k + 1 < stack.size(); k++ ) {
+				emit_triangle( indices, p, orientation, u.index, sweep[ stack[ k ] ].index, sweep[ stack[ k + 1 ] ].index );
+			}
+			stack.clear();
+			stack.push_back( uint32_t( j - 1 ) );
+			stack.push_back( uint32_t( j ) );
+		} else {
+			// Vertex on same chain: cut off triangles for as long as the
+			// vertex at the top of the stack is convex.
+			float const chain_orientation = u.chain == 0 ? orientation : -orientation;
+			uint32_t    last              = stack.back();
+			stack.pop_back();
+			while ( !stack.empty() &&
+			        cross( p[ sweep[ stack.back() ].index ], p[ sweep[ last ].index ], p[ u.index ] ) * chain_orientation > 0 ) {
+				emit_triangle( indices, p, orientation, u.index, sweep[ last ].index, sweep[ stack.back() ].index );
+				last = stack.back();
+				stack.pop_back();
+			}
+			stack.push_back( last );
+			stack.push_back( uint32_t( j ) );
+		}
+	}
+
+	// Last vertex sees all vertices remaining on the stack.
+	for ( size_t k = 0; k + 1 < stack.size(); k++ ) {
+		emit_triangle( indices, p, orientation, sweep[ m - 1 ].index, sweep[ stack[ k ] ].index, sweep[ stack[ k + 1 ] ].index );
+	}
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+// Returns true if the contour was triangulated using a fast path.
+static bool tessellate_fast_path( le_tessellator_o *self ) {
+
+	if ( self->contour_ends.size() != 1 ||
+	     ( self->options & ( Options::bitDisableFastPaths | Options::bitConstrainedDelaunayTriangulation ) ) ) {
+		return false;
+	}
+
+	if ( 0 == ( self->options & Options::bitUseEarcutTessellator ) ) {
+		// libtess orients a single contour so that its winding number is
+		// +1 - fast paths match libtess only for rules which fill that.
+		switch ( get_winding_rule( self->options ) ) {
+		case TessWindingRule::TESS_WINDING_ODD:
+		case TessWindingRule::TESS_WINDING_NONZERO:
+		case TessWindingRule::TESS_WINDING_POSITIVE:
+			break;
+		default:
+			return false;
+		}
+	}
+
+	float orientation = 0;
+
+	switch ( classify_contour( self, &orientation ) ) {
+	case ContourClass::eConvex:
+		triangulate_convex( self );
+		self->stats.num_convex++;
+		return true;
+	case ContourClass::eMonotone:
+		if ( triangulate_monotone( self, orientation ) ) {
+			self->stats.num_monotone++;
+			return true;
+		}
 		self->indices.clear();
-		self->vertices.clear();
+		return false;
+	default:
+		return false;
+	}
+}
 
-		size_t numVertices = size_t( tessGetVertexCount( tess ) );
-		auto   pVertices   = tessGetVertices( tess );
-		self->vertices.resize( numVertices );
-		memcpy( self->vertices.data(), pVertices, sizeof( Point ) * numVertices );
+// ----------------------------------------------------------------------
+
+static bool tessellate_earcut( le_tessellator_o *self ) {
+
+	self->earcut_contours.clear();
+
+	size_t contour_begin = 0;
+	for ( auto const &contour_end : self->contour_ends ) {
+		self->earcut_contours.push_back( { self->points.data() + contour_begin, contour_end - contour_begin } );
+		contour_begin = contour_end;
+	}
+
+	self->earcut( self->earcut_contours );
 
-		size_t numIndices = size_t( tessGetElementCount( tess ) ) * 3; // each element has 3 vertices, as we requested triangles when tessellating
-		self->indices.reserve( numIndices );
+	// Earcut indices refer to input points - swap, so that earcut keeps
+	// the storage of our previous index buffer for its next run.
+	std::swap( self->indices, self->earcut.indices );
 
-		TESSindex const *      pIndex     = tessGetElements( tess );
-		TESSindex const *const pIndex_end = pIndex + numIndices;
+	self->stats.num_earcut++;
 
-		// we must copy manually since indices are int, but we want uint16_t
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+static bool tessellate_libtess( le_tessellator_o *self ) {
 
-		for ( auto idx = pIndex; idx != pIndex_end; idx++ ) {
-			self->indices.emplace_back( *idx );
+	if ( self->tess == nullptr ) {
+		self->tess = tessNewTess( &self->tess_alloc );
+		if ( self->tess == nullptr ) {
+			return false;
 		}
+		// Everything allocated after this point is only needed for the
+		// duration of a single run.
+		self->arena_mark = { self->arena.block_index, self->arena.offset };
+	}
 
+	// Reclaims all memory used by the previous run - including output
+	// which we have already copied into `indices` and `vertices`.
+	tess_arena_reset_to( &self->arena, self->arena_mark );
+
+	TESStesselator *tess = self->tess;
+
+	tessSetOption( tess, TessOption::TESS_CONSTRAINED_DELAUNAY_TRIANGULATION,
+	               self->options & Options::bitConstrainedDelaunayTriangulation );
+
+	tessSetOption( tess, TessOption::TESS_REVERSE_CONTOURS,
+	               self->options & Options::bitReverseContours );
+
+	size_t contour_begin = 0;
+	for ( auto const &contour_end : self->contour_ends ) {
+		tessAddContour( tess, Point::type::length(), self->points.data() + contour_begin, sizeof( Point ), int( contour_end - contour_begin ) );
+		contour_begin = contour_end;
+	}
+
+	int const result = tessTesselate( tess,
+	                                  get_winding_rule( self->options ),
+	                                  TessElementType::TESS_POLYGONS,
+	                                  3, // max number of vertices per polygon - we want triangles.
+	                                  Point::length(),
+	                                  nullptr );
+
+	if ( result == 0 ) {
+		// libtess may have bailed out half-way, and left a mesh behind which
+		// lives in arena memory. Start over with a fresh context next time.
 		tessDeleteTess( tess );
+		self->tess = nullptr;
+		tess_arena_reset_to( &self->arena, {} );
+		return false;
 	}
 
+	size_t numVertices = size_t( tessGetVertexCount( tess ) );
+	auto   pVertices   = tessGetVertices( tess );
+	self->vertices.resize( numVertices );
+	memcpy( self->vertices.data(), pVertices, sizeof( Point ) * numVertices );
+
+	size_t numIndices = size_t( tessGetElementCount( tess ) ) * 3; // each element has 3 vertices, as we requested triangles when tessellating
+
+	TESSindex const *      pIndex     = tessGetElements( tess );
+	TESSindex const *const pIndex_end = pIndex + numIndices;
+
+	// we must copy manually since indices are int, but we want uint16_t
+	self->indices.assign( pIndex, pIndex_end );
+
+	self->has_libtess_result = true;
+
+	self->stats.num_libtess++;
+
+	return true;
+}
+
+// ----------------------------------------------------------------------
+
+static bool le_tessellator_tessellate( le_tessellator_o *self ) {
+
+	self->indices.clear();
+	self->vertices.clear();
+	self->has_libtess_result = false;
+
+	if ( self->contour_ends.empty() ) {
+		return true;
+	}
+
+	if ( tessellate_fast_path( self ) ) {
+		return true;
+	}
+
+	// Run tessellation
+	if ( self->options & Options::bitUseEarcutTessellator ) {
+		return tessellate_earcut( self );
+	}
+
+	// If libtess fails, we leave results empty, but still return true, as
+	// we always have: callers draw nothing for empty results.
+	tessellate_libtess( self );
+
 	return true;
 }
 
@@ -124,17 +671,23 @@ static void le_tessellator_get_indices( le_tessellator_o *self, IndexType const
 
 // ----------------------------------------------------------------------
 
+// Libtess creates new vertices, earcut indexes into the input points.
 static void le_tessellator_get_vertices( le_tessellator_o *self, Point const **pVertices, size_t *vertexCount ) {
-	*pVertices   = self->vertices.data();
-	*vertexCount = self->vertices.size();
+	auto const &v = self->has_libtess_result ? self->vertices : self->points;
+	*pVertices    = v.data();
+	*vertexCount  = v.size();
 }
 
 // ----------------------------------------------------------------------
 
+// Keeps all storage, and the libtess context, so that the tessellator may be
+// reused without allocating.
 static void le_tessellator_reset( le_tessellator_o *self ) {
-	self->contours.clear();
+	self->points.clear();
+	self->contour_ends.clear();
 	self->indices.clear();
 	self->vertices.clear();
+	self->has_libtess_result = false;
 }
 
 // ----------------------------------------------------------------------
@@ -145,6 +698,12 @@ static void le_tessellator_set_options( le_tessellator_o *self, uint64_t options
 
 // ----------------------------------------------------------------------
 
+static void le_tessellator_get_stats( le_tessellator_o *self, le_tessellator_api::le_tessellator_interface_t::stats_t *stats ) {
+	*stats = self->stats;
+}
+
+// ----------------------------------------------------------------------
+
 LE_MODULE_REGISTER_IMPL( le_tessellator, api ) {
 	auto &le_tessellator_i = static_cast<le_tessellator_api *>( api )->le_tessellator_i;
 
@@ -156,4 +715,5 @@ LE_MODULE_REGISTER_IMPL( le_tessellator, api ) {
 	le_tessellator_i.get_vertices = le_tessellator_get_vertices;
 	le_tessellator_i.reset        = le_tessellator_reset;
 	le_tessellator_i.set_options  = le_tessellator_set_options;
+	le_tessellator_i.get_stats    = le_tessellator_get_stats;
 }
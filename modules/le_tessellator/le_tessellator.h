@@ -30,6 +30,17 @@ struct le_tessellator_api {
 			eWindingPositive                    = 3 << OptionsWindingsOffset, /* ignored if tessellator not libtess */
 			eWindingNegative                    = 4 << OptionsWindingsOffset, /* ignored if tessellator not libtess */
 			eWindingAbsGeqTwo                   = 5 << OptionsWindingsOffset, /* ignored if tessellator not libtess */
+			// Single contours which are convex, or monotone in y, are triangulated directly, without
+			// earcut or libtess, unless fast paths are disabled, or constrained delaunay triangulation was requested.
+			bitDisableFastPaths                 = 1 << 6,
+		};
+
+		// Counts how often each method was used to tessellate, over the lifetime of a tessellator.
+		struct stats_t {
+			uint64_t num_convex;   // fast path: triangle fan
+			uint64_t num_monotone; // fast path: monotone polygon triangulation
+			uint64_t num_earcut;
+			uint64_t num_libtess;
 		};
 
 
@@ -45,6 +56,8 @@ struct le_tessellator_api {
 
 		void                 ( * reset                    ) ( le_tessellator_o* self );
 
+		void                 ( * get_stats                ) ( le_tessellator_o* self, stats_t* stats );
+
 	};
 
 	le_tessellator_interface_t       le_tessellator_i;
@@ -0,0 +1,417 @@
+#include "le_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <stdio.h>
+#include <assert.h>
+#include <iostream>
+
+enum le_trace_event_type : uint32_t {
+	LE_TRACE_EVENT_ZONE_BEGIN = 0,
+	LE_TRACE_EVENT_ZONE_END,
+	LE_TRACE_EVENT_COUNTER,
+	LE_TRACE_EVENT_FRAME_MARK,
+};
+
+struct le_trace_event_t {
+	uint64_t timestamp_ns; // time since trace epoch
+	double   value;        // counter value, unused for other event types
+	uint32_t name_id;      //
+	uint32_t type;         // le_trace_event_type
+};
+
+// Each thread records into its own buffer. A buffer is a ring of events which
+// is only ever written to by its owning thread. Readers (exporting a trace)
+// copy events, and then check whether the owning thread has overwritten any
+// of the copied events in the meantime, in which case these get discarded.
+struct le_trace_thread_buffer_t {
+	le_trace_event_t events[ LE_TRACE_EVENTS_PER_THREAD ];
+
+	std::atomic<uint64_t> head{ 0 };           // number of events written in total - written by owning thread only
+	std::atomic<uint64_t> discard_before{ 0 }; // events with index smaller than this have been discarded via reset
+	std::atomic<uint32_t> thread_name_id{ 0 }; // interned name of owning thread, 0 if not set
+
+	std::thread::id           owner;              // immutable once published
+	uint32_t                  thread_index = 0;   // immutable once published, used as tid in trace output
+	le_trace_thread_buffer_t *next         = nullptr; // next buffer in list of all buffers, immutable once published
+};
+
+struct le_trace_o {
+	std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	std::atomic<le_trace_thread_buffer_t *> buffers{ nullptr }; // list of all thread buffers, append-only
+	std::atomic<uint32_t>                   next_thread_index{ 1 };
+
+	std::mutex                                    names_mtx;       // protects names, name_ids, thread_name_ids - only used when interning, naming threads, and exporting
+	std::vector<std::string>                      names;           // name for id is at index (id - 1)
+	std::unordered_map<std::string, uint32_t>     name_ids;        // name -> id
+	std::unordered_map<std::thread::id, uint32_t> thread_name_ids; // thread -> id of thread name, applied to a thread's buffer once it gets created
+};
+
+// Trace state lives in the api, so that it survives reloading this module.
+static le_trace_o *get_state() {
+	return le_trace_api_i->state;
+}
+
+// Buffer for the current thread - nullptr until the first event gets recorded
+// on this thread, or after this module was reloaded.
+static thread_local le_trace_thread_buffer_t *tl_thread_buffer = nullptr;
+
+// ----------------------------------------------------------------------
+// Returns buffer for the calling thread, or nullptr if the calling thread has
+// not recorded any events yet.
+static le_trace_thread_buffer_t *find_thread_buffer() {
+
+	if ( tl_thread_buffer ) {
+		return tl_thread_buffer;
+	}
+
+	// If this module was reloaded, our thread-local pointer has been reset,
+	// but a buffer for this thread may already exist - in which case we re-use it.
+
+	auto const this_thread_id = std::this_thread::get_id();
+
+	for ( auto b = get_state()->buffers.load( std::memory_order_acquire ); b != nullptr; b = b->next ) {
+		if ( b->owner == this_thread_id ) {
+			tl_thread_buffer = b;
+			return b;
+		}
+	}
+
+	return nullptr;
+}
+
+// ----------------------------------------------------------------------
+// Returns buffer for the calling thread, creates and publishes a new buffer if needed.
+//
+// Buffers are large, which is why we only create them once a thread records
+// its first event - that is, only for threads which record while tracing is
+// enabled.
+static le_trace_thread_buffer_t *get_thread_buffer() {
+
+	if ( auto buffer = find_thread_buffer() ) {
+		return buffer;
+	}
+
+	le_trace_o *state = get_state();
+
+	auto const this_thread_id = std::this_thread::get_id();
+
+	// Only the calling thread may add a buffer which it owns - which means
+	// that we don't need to check for duplicates if publishing fails.
+
+	auto buffer          = new le_trace_thread_buffer_t();
+	buffer->owner        = this_thread_id;
+	buffer->thread_index = state->next_thread_index.fetch_add( 1, std::memory_order_relaxed );
+	buffer->next         = state->buffers.load( std::memory_order_relaxed );
+
+	{
+		// Apply thread name, if it was set before this buffer existed.
+		std::scoped_lock lock( state->names_mtx );
+
+		auto it = state->thread_name_ids.find( this_thread_id );
+
+		if ( it != state->thread_name_ids.end() ) {
+			buffer->thread_name_id.store( it->second, std::memory_order_relaxed );
+		}
+	}
+
+	while ( !state->buffers.compare_exchange_weak( buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed ) ) {
+	}
+
+	tl_thread_buffer = buffer;
+
+	return buffer;
+}
+
+// ----------------------------------------------------------------------
+
+static inline void record_event( le_trace_event_type type, uint32_t name_id, double value ) {
+
+	le_trace_thread_buffer_t *buffer = get_thread_buffer();
+
+	uint64_t const timestamp_ns = uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - get_state()->epoch ).count() );
+
+	uint64_t const head = buffer->head.load( std::memory_order_relaxed ); // only we write to head
+
+	buffer->events[ head & ( LE_TRACE_EVENTS_PER_THREAD - 1 ) ] = { timestamp_ns, value, name_id, type };
+
+	buffer->head.store( head + 1, std::memory_order_release );
+}
+
+// ----------------------------------------------------------------------
+
+static uint32_t le_trace_intern_name( char const *name ) {
+
+	le_trace_o *state = get_state();
+
+	std::scoped_lock lock( state->names_mtx );
+
+	auto it = state->name_ids.find( name );
+
+	if ( it != state->name_ids.end() ) {
+		return it->second;
+	}
+
+	state->names.emplace_back( name );
+	uint32_t const name_id = uint32_t( state->names.size() ); // ids start at 1
+
+	state->name_ids.emplace( name, name_id );
+
+	return name_id;
+}
+
+// ----------------------------------------------------------------------
+
+static void le_trace_zone_begin( uint32_t name_id ) {
+	record_event( LE_TRACE_EVENT_ZONE_BEGIN, name_id, 0 );
+}
+
+// ----------------------------------------------------------------------
+
+static void le_trace_zone_end( uint32_t name_id ) {
+	record_event( LE_TRACE_EVENT_ZONE_END, name_id, 0 );
+}
+
+// ----------------------------------------------------------------------
+
+static void le_trace_counter( uint32_t name_id, double value ) {
+	record_event( LE_TRACE_EVENT_COUNTER, name_id, value );
+}
+
+// ----------------------------------------------------------------------
+
+static void le_trace_frame_mark( uint32_t name_id ) {
+	record_event( LE_TRACE_EVENT_FRAME_MARK, name_id, 0 );
+}
+
+// ----------------------------------------------------------------------
+
+// Only stores the name - this does not create a buffer for the calling thread,
+// since the thread might never record an event.
+static void le_trace_set_thread_name( char const *name ) {
+
+	uint32_t const name_id = le_trace_intern_name( name );
+
+	le_trace_o *state = get_state();
+
+	{
+		std::scoped_lock lock( state->names_mtx );
+		state->thread_name_ids[ std::this_thread::get_id() ] = name_id;
+	}
+
+	if ( auto buffer = find_thread_buffer() ) {
+		buffer->thread_name_id.store( name_id, std::memory_order_relaxed );
+	}
+}
+
+// ----------------------------------------------------------------------
+
+static void le_trace_set_enabled( bool enabled ) {
+	auto api = const_cast<le_trace_api *>( le_trace_api_i );
+#ifdef _MSC_VER
+	*reinterpret_cast<uint32_t volatile *>( &api->enabled ) = enabled ? 1 : 0;
+#else
+	__atomic_store_n( &api->enabled, enabled ? 1 : 0, __ATOMIC_RELAXED );
+#endif
+}
+
+// ----------------------------------------------------------------------
+
+static void le_trace_reset() {
+	for ( auto b = get_state()->buffers.load( std::memory_order_acquire ); b != nullptr; b = b->next ) {
+		b->discard_before.store( b->head.load( std::memory_order_acquire ), std::memory_order_relaxed );
+	}
+}
+
+// ----------------------------------------------------------------------
+// Copies all events from buffer which have not been overwritten, or discarded.
+static void thread_buffer_copy_events( le_trace_thread_buffer_t const *buffer, std::vector<le_trace_event_t> &events ) {
+
+	events.clear();
+
+	uint64_t const head  = buffer->head.load( std::memory_order_acquire );
+	uint64_t       first = head > LE_TRACE_EVENTS_PER_THREAD ? head - LE_TRACE_EVENTS_PER_THREAD : 0;
+
+	first = std::max( first, buffer->discard_before.load( std::memory_order_relaxed ) );
+
+	for ( uint64_t i = first; i < head; i++ ) {
+		events.push_back( buffer->events[ i & ( LE_TRACE_EVENTS_PER_THREAD - 1 ) ] );
+	}
+
+	// The owning thread may have overwritten events while we were copying them -
+	// anything older than one ring's worth of events before the current head
+	// may be torn, and must be dropped. This includes the event one full ring
+	// before the head: it shares its slot with event `head_after`, which the
+	// owning thread may be writing right now, before it publishes a new head.
+
+	std::atomic_thread_fence( std::memory_order_acquire );
+
+	uint64_t const head_after = buffer->head.load( std::memory_order_relaxed );
+
+	if ( head_after >= LE_TRACE_EVENTS_PER_THREAD ) {
+		uint64_t const first_valid = head_after - LE_TRACE_EVENTS_PER_THREAD + 1;
+		if ( first_valid > first ) {
+			events.erase( events.begin(), events.begin() + std::min<uint64_t>( first_valid - first, events.size() ) );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------
+
+static void write_json_string( FILE *file, char const *str ) {
+	fputc( '"', file );
+	for ( char const *c = str; *c; c++ ) {
+		if ( *c == '"' || *c == '\\' ) {
+			fputc( '\\', file );
+			fputc( *c, file );
+		} else if ( uint8_t( *c ) < 0x20 ) {
+			fprintf( file, "\\u%04x", unsigned( uint8_t( *c ) ) );
+		} else {
+			fputc( *c, file );
+		}
+	}
+	fputc( '"', file );
+}
+
+// ----------------------------------------------------------------------
+// Writes all recorded events in Chrome trace event format.
+// See: <https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU>
+static bool le_trace_write_chrome_trace( char const *file_path ) {
+
+	FILE *file = fopen( file_path, "wb" );
+
+	if ( nullptr == file ) {
+		std::cerr << "ERROR: Could not open file for writing trace: '" << file_path << "'" << std::endl
+		          << std::flush;
+		return false;
+	}
+
+	le_trace_o *state = get_state();
+
+	// Take a copy of names, so that we don't hold the lock while writing.
+	std::vector<std::string> names;
+	{
+		std::scoped_lock lock( state->names_mtx );
+		names = state->names;
+	}
+
+	auto get_name = [ &names ]( uint32_t name_id ) -> char const * {
+		return ( name_id != 0 && name_id <= names.size() ) ? names[ name_id - 1 ].c_str() : "<< unknown >>";
+	};
+
+	constexpr int pid = 1;
+
+	fprintf( file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+	bool is_first_event = true;
+
+	auto begin_event = [ & ]() {
+		if ( !is_first_event ) {
+			fprintf( file, ",\n" );
+		}
+		is_first_event = false;
+	};
+
+	std::vector<le_trace_event_t> events;
+	events.reserve( LE_TRACE_EVENTS_PER_THREAD );
+
+	for ( auto b = state->buffers.load( std::memory_order_acquire ); b != nullptr; b = b->next ) {
+
+		uint32_t const tid = b->thread_index;
+
+		uint32_t const thread_name_id = b->thread_name_id.load( std::memory_order_relaxed );
+		if ( thread_name_id ) {
+			begin_event();
+			fprintf( file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":", pid, tid );
+			write_json_string( file, get_name( thread_name_id ) );
+			fprintf( file, "}}" );
+		}
+
+		thread_buffer_copy_events( b, events );
+
+		// The oldest events in the ring may be zone ends for zones whose beginning
+		// has already been overwritten - we skip these, so that zones stay balanced.
+		uint32_t depth = 0;
+
+		for ( auto const &e : events ) {
+
+			double const ts_us = double( e.timestamp_ns ) / 1000.0;
+
+			switch ( e.type ) {
+			case LE_TRACE_EVENT_ZONE_BEGIN:
+				depth++;
+				begin_event();
+				fprintf( file, "{\"name\":" );
+				write_json_string( file, get_name( e.name_id ) );
+				fprintf( file, ",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u}", ts_us, pid, tid );
+				break;
+			case LE_TRACE_EVENT_ZONE_END:
+				if ( depth == 0 ) {
+					break;
+				}
+				depth--;
+				begin_event();
+				fprintf( file, "{\"ph\":\"E\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u}", ts_us, pid, tid );
+				break;
+			case LE_TRACE_EVENT_COUNTER:
+				begin_event();
+				fprintf( file, "{\"name\":" );
+				write_json_string( file, get_name( e.name_id ) );
+				fprintf( file, ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"value\":%.17g}}", ts_us, pid, tid, e.value );
+				break;
+			case LE_TRACE_EVENT_FRAME_MARK:
+				begin_event();
+				fprintf( file, "{\"name\":" );
+				write_json_string( file, get_name( e.name_id ) );
+				fprintf( file, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u}", ts_us, pid, tid );
+				break;
+			default:
+				assert( false && "unknown trace event type" );
+				break;
+			}
+		}
+	}
+
+	fprintf( file, "\n]}\n" );
+
+	bool const result = ( 0 == ferror( file ) );
+
+	fclose( file );
+
+	if ( result ) {
+		std::cout << "Wrote trace: '" << file_path << "'" << std::endl
+		          << std::flush;
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------
+
+LE_MODULE_REGISTER_IMPL( le_trace, api ) {
+	auto  le_api     = static_cast<le_trace_api *>( api );
+	auto &le_trace_i = le_api->le_trace_i;
+
+	le_trace_i.intern_name        = le_trace_intern_name;
+	le_trace_i.zone_begin         = le_trace_zone_begin;
+	le_trace_i.zone_end           = le_trace_zone_end;
+	le_trace_i.counter            = le_trace_counter;
+	le_trace_i.frame_mark         = le_trace_frame_mark;
+	le_trace_i.set_thread_name    = le_trace_set_thread_name;
+	le_trace_i.set_enabled        = le_trace_set_enabled;
+	le_trace_i.reset              = le_trace_reset;
+	le_trace_i.write_chrome_trace = le_trace_write_chrome_trace;
+
+	if ( nullptr == le_api->state ) {
+		// First time this module gets loaded - trace state is never freed,
+		// since any thread may still record into it up until the program exits.
+		le_api->state = new le_trace_o();
+	}
+}
@@ -0,0 +1,133 @@
+#ifndef GUARD_le_trace_H
+#define GUARD_le_trace_H
+
+/*
+ * Tracing: scoped zones, counters, and frame markers, which may be recorded
+ * from any module, and from any thread, and exported in Chrome trace format
+ * (which can be loaded into chrome://tracing, or https://ui.perfetto.dev).
+ *
+ * Usage:
+ *
+ *     static void my_function(){
+ *         LE_TRACE_ZONE( "my_function" );   // zone lasts until end of scope
+ *         ...
+ *         LE_TRACE_COUNTER( "num_things", num_things );
+ *     }
+ *
+ *     LE_TRACE_FRAME_MARK( "frame" );
+ *
+ *     le_trace::le_trace_i.set_enabled( true );
+ *     ...
+ *     le_trace::le_trace_i.write_chrome_trace( "trace.json" );
+ *
+ * Tracing is disabled by default. While disabled, a zone costs one relaxed
+ * atomic load, and a branch.
+ *
+ * Each thread records into its own, fixed-size ring buffer of events, so that
+ * recording never locks, and so that memory use is bounded - we only keep the
+ * most recent LE_TRACE_EVENTS_PER_THREAD events per thread.
+ *
+ * Names are interned: each call site looks up the id for its name once, and
+ * from then on only records that id. Interned names are copied, and trace
+ * state lives in the api struct, which means that both survive reloading the
+ * instrumented module, or this module.
+ *
+ */
+
+#include <stdint.h>
+#include "le_core/le_core.h"
+
+struct le_trace_o; // global trace state
+
+#define LE_TRACE_EVENTS_PER_THREAD ( 1 << 16 ) // must be power of two
+
+// clang-format off
+struct le_trace_api {
+
+	struct le_trace_interface_t {
+
+		uint32_t ( *intern_name        )( char const *name ); // returns non-zero id for name; name is copied
+		void     ( *zone_begin         )( uint32_t name_id );
+		void     ( *zone_end           )( uint32_t name_id );
+		void     ( *counter            )( uint32_t name_id, double value );
+		void     ( *frame_mark         )( uint32_t name_id );
+		void     ( *set_thread_name    )( char const *name ); // sets name for calling thread - cheap, does not allocate an event buffer
+		void     ( *set_enabled        )( bool enabled );
+		void     ( *reset              )(); // discards all events recorded so far
+		bool     ( *write_chrome_trace )( char const *file_path );
+	};
+
+	le_trace_interface_t le_trace_i;
+
+	le_trace_o *state;   // owned, kept here so that it survives reload
+	uint32_t    enabled; // non-zero while tracing is enabled, use le_trace::is_enabled() to query
+};
+// clang-format on
+
+LE_MODULE( le_trace );
+LE_MODULE_LOAD_DEFAULT( le_trace );
+
+#ifdef __cplusplus
+
+namespace le_trace {
+static const auto &api        = le_trace_api_i;
+static const auto &le_trace_i = api -> le_trace_i;
+
+inline bool is_enabled() {
+#	ifdef _MSC_VER
+	return *reinterpret_cast<uint32_t const volatile *>( &api->enabled ) != 0;
+#	else
+	return __atomic_load_n( &api->enabled, __ATOMIC_RELAXED ) != 0;
+#	endif
+}
+
+// Records a zone which lasts for the lifetime of this object - only if
+// tracing was enabled when the zone began.
+class ScopedZone : NoCopy, NoMove {
+	uint32_t name_id; // 0 if zone was not recorded
+
+  public:
+	explicit ScopedZone( uint32_t name_id_ )
+	    : name_id( is_enabled() ? name_id_ : 0 ) {
+		if ( name_id ) {
+			le_trace_i.zone_begin( name_id );
+		}
+	}
+
+	~ScopedZone() {
+		if ( name_id ) {
+			le_trace_i.zone_end( name_id );
+		}
+	}
+};
+
+} // namespace le_trace
+
+#	define LE_TRACE_CONCAT_IMPL( a, b ) a##b
+#	define LE_TRACE_CONCAT( a, b ) LE_TRACE_CONCAT_IMPL( a, b )
+
+// Returns id for name - name is interned once per call site.
+#	define LE_TRACE_NAME_ID( name ) []() -> uint32_t {                                   \
+		static uint32_t const name_id = le_trace::le_trace_i.intern_name( name ); \
+		return name_id; }()
+
+#	define LE_TRACE_ZONE( name ) \
+		le_trace::ScopedZone LE_TRACE_CONCAT( le_trace_zone_, __LINE__ )( LE_TRACE_NAME_ID( name ) )
+
+#	define LE_TRACE_COUNTER( name, value )                                             \
+		do {                                                                           \
+			if ( le_trace::is_enabled() ) {                                            \
+				le_trace::le_trace_i.counter( LE_TRACE_NAME_ID( name ), double( value ) ); \
+			}                                                                          \
+		} while ( 0 )
+
+#	define LE_TRACE_FRAME_MARK( name )                                     \
+		do {                                                                \
+			if ( le_trace::is_enabled() ) {                                 \
+				le_trace::le_trace_i.frame_mark( LE_TRACE_NAME_ID( name ) ); \
+			}                                                               \
+		} while ( 0 )
+
+#endif // __cplusplus
+
+#endif
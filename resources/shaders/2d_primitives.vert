@@ -43,10 +43,13 @@ void main()
 
 	outColor = col;
 
-	// apply translation from instance data
+	// apply instance transform - application order: scale, rotation, translation
 
-	mat4 transform = mat4(1);
-	transform[3].xy = translation.xy;
+	float s = sin(rotation_ccw);
+	float c = cos(rotation_ccw);
 
-	gl_Position = mvp * transform * vec4(inPos,0,1);
+	vec2 pos = inPos * scale;
+	pos = vec2(c * pos.x - s * pos.y, s * pos.x + c * pos.y);
+
+	gl_Position = mvp * vec4(pos + translation, 0, 1);
 }
\ No newline at end of file
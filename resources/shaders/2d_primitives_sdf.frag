@@ -0,0 +1,88 @@
+#version 450 core
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+// inputs 
+layout (location = 0) in vec4 inColor;
+layout (location = 1) in vec2 inLocalPos;
+layout (location = 2) flat in vec2  inRadii;
+layout (location = 3) flat in vec2  inAngles;
+layout (location = 4) flat in float inStrokeWeight;
+layout (location = 5) flat in uint  inFlags;
+
+// outputs
+layout (location = 0) out vec4 outFragColor;
+
+// Must match SdfInstanceData2D flags in le_2d.cpp
+const uint SHAPE_MASK    = 0x3;
+const uint SHAPE_ELLIPSE = 0;
+const uint SHAPE_LINE    = 1;
+const uint FLAG_FILLED   = 0x4;
+const uint FLAG_ARC      = 0x8; // restrict ellipse to sector between start and end angle
+
+const float PI = 3.14159265359;
+
+// Approximate signed distance to ellipse - exact for circles.
+// See: https://iquilezles.org/articles/ellipsedist/
+float sd_ellipse(vec2 p, vec2 r)
+{
+	float k0 = length(p / r);
+	float k1 = length(p / (r * r));
+	if (k1 < 1e-6) {
+		return -min(r.x, r.y); // at centre
+	}
+	return k0 * (k0 - 1.0) / k1;
+}
+
+// Signed distance to box with half extents b, centred at origin.
+float sd_box(vec2 p, vec2 b)
+{
+	vec2 q = abs(p) - b;
+	return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0);
+}
+
+// Signed distance to sector which sweeps ccw from start angle to end angle.
+// Angles are parametric, as in e(t) = {r.x * cos(t), r.y * sin(t)}, which is
+// how tessellated arcs interpret them, too.
+float sd_sector(vec2 p, vec2 r, vec2 a)
+{
+	vec2 d0 = normalize(r * vec2(cos(a.x), sin(a.x)));
+	vec2 d1 = normalize(r * vec2(cos(a.y), sin(a.y)));
+
+	float s0 = dot(p, vec2(d0.y, -d0.x)); // negative: ccw of start ray
+	float s1 = dot(p, vec2(-d1.y, d1.x)); // negative: cw of end ray
+
+	return (a.y - a.x) < PI ? max(s0, s1) : min(s0, s1);
+}
+
+void main()
+{
+	float d;
+
+	if ((inFlags & SHAPE_MASK) == SHAPE_LINE) {
+		d = sd_box(inLocalPos, vec2(inRadii.x, 0.5 * inStrokeWeight));
+	} else {
+		vec2 r = max(inRadii, vec2(1e-6));
+		d      = sd_ellipse(inLocalPos, r);
+
+		if ((inFlags & FLAG_FILLED) == 0) {
+			d = abs(d) - 0.5 * inStrokeWeight;
+		}
+
+		if ((inFlags & FLAG_ARC) != 0) {
+			d = max(d, sd_sector(inLocalPos, r, inAngles));
+		}
+	}
+
+	// Anti-aliasing: coverage falls off over one pixel around the edge.
+
+	float w        = max(fwidth(d), 1e-4);
+	float coverage = clamp(0.5 - d / w, 0.0, 1.0);
+
+	if (coverage <= 0.0) {
+		discard;
+	}
+
+	outFragColor = vec4(inColor.rgb, inColor.a * coverage);
+}
@@ -0,0 +1,69 @@
+#version 450 core
+
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+// uniforms (resources)
+layout (set = 0, binding = 0) uniform Mvp 
+{
+	mat4 mvp;
+};
+
+// inputs (vertex attributes)
+layout (location = 0) in vec2 inPos; // corner of unit quad, in [-1..1]
+
+layout (location = 1) in vec2  translation;   // centre of shape
+layout (location = 2) in vec2  radii;         // ellipse: radius x, radius y; line: half length, 0
+layout (location = 3) in vec2  angles;        // arc: start angle, end angle
+layout (location = 4) in float rotation_ccw;
+layout (location = 5) in float stroke_weight;
+layout (location = 6) in uint  color;
+layout (location = 7) in uint  flags;         // shape, and flags, see 2d_primitives_sdf.frag
+
+// outputs 
+layout (location = 0) out vec4 outColor;
+layout (location = 1) out vec2 outLocalPos; // position in shape space
+layout (location = 2) flat out vec2  outRadii;
+layout (location = 3) flat out vec2  outAngles;
+layout (location = 4) flat out float outStrokeWeight;
+layout (location = 5) flat out uint  outFlags;
+
+// we override the built-in fixed function outputs
+// to have more control over the SPIR-V code created.
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main()
+{
+	vec4 col = 
+	vec4(
+		((color>>24) & 0xff), 
+		((color>>16) & 0xff),
+		((color>>8) & 0xff),
+		((color) & 0xff)) / 255.f;
+
+	outColor        = col;
+	outRadii        = radii;
+	outAngles       = angles;
+	outStrokeWeight = stroke_weight;
+	outFlags        = flags;
+
+	// Quad must cover the shape, plus half its stroke, plus a margin of
+	// about a pixel, so that anti-aliased edges don't get clipped.
+
+	vec2 extent = radii + vec2(0.5 * stroke_weight + 1.0);
+	vec2 pos    = inPos * extent;
+
+	outLocalPos = pos;
+
+	// apply instance transform - application order: rotation, translation
+
+	float s = sin(rotation_ccw);
+	float c = cos(rotation_ccw);
+
+	pos = vec2(c * pos.x - s * pos.y, s * pos.x + c * pos.y);
+
+	gl_Position = mvp * vec4(pos + translation, 0, 1);
+}